@@ -1,6 +1,7 @@
 from typing import *
 import ctypes
 import wave
+import array
 import os
 
 # 获取当前文件的绝对路径
@@ -14,11 +15,64 @@ if os.name == 'nt':
     g729a_lib_path = PATH + "\\" + 'libg729a.dll'
 elif os.name == 'posix':
     # g729a_lib_path = './libg729a.so'
-    g729a_lib_path = PATH + "\\" + 'libg729a.so'
+    g729a_lib_path = os.path.join(PATH, 'libg729a.so')
 else:
     raise RuntimeError("Unknown OS")
 
 
+_g729a_lib = None
+
+def load_g729a_lib() -> ctypes.CDLL:
+    """Load the library once, with the argument types of the functions used here"""
+    global _g729a_lib
+    if _g729a_lib is None:
+        lib = ctypes.CDLL(g729a_lib_path)
+        p, i32 = ctypes.c_void_p, ctypes.c_int32
+        for name, argtypes in (
+            ('G729A_Encoder_Init', [p]),
+            ('G729A_Encoder_Process', [p, p, p]),
+            ('G729A_Encoder_Process_Frames', [p, p, i32, p]),
+            ('G729A_Encoder_Process_Private_DTX', [p, p, p]),
+            ('G729A_Encoder_Process_Parallel', [p, i32, p, i32, i32, p]),
+            ('G729A_Decoder_Init', [p]),
+            ('G729A_Decoder_Process', [p, p, p]),
+            ('G729A_Decoder_Process_Frames', [p, p, i32, p, p]),
+            ('G729A_Decoder_Process_Private_DTX', [p, p, i32, p]),
+            ('G729A_Decoder_Set_Postfilter', [p, i32]),
+            ('G729A_Decoder_Analyze', [p, p, i32, p, p]),
+            ('G729A_Level_Init', [p]),
+            ('G729A_Level_Process', [p, p, i32, p, p, p]),
+            ('G729A_Level_Rank', [p, i32, p, p, i32, p]),
+            ('G729A_Encode_File', [ctypes.c_char_p, ctypes.c_char_p, p]),
+            ('G729A_Decode_File', [ctypes.c_char_p, ctypes.c_char_p, i32, p]),
+        ):
+            f = getattr(lib, name)
+            f.argtypes = argtypes
+            f.restype = i32
+        lib.G729A_Encoder_Get_Size.restype = ctypes.c_uint32
+        lib.G729A_Decoder_Get_Size.restype = ctypes.c_uint32
+        lib.G729A_Level_Get_Size.restype = ctypes.c_uint32
+        _g729a_lib = lib
+    return _g729a_lib
+
+
+def _buffer_arg(buf: Any, writable: bool = False) -> Tuple[Any, int]:
+    """ctypes argument addressing the bytes of buf (bytes, bytearray, memoryview,
+    array.array, numpy array...) without copying them, and its size in bytes"""
+    if isinstance(buf, bytes) and not writable:
+        return buf, len(buf)
+    mv = memoryview(buf)
+    if not mv.c_contiguous:
+        raise RuntimeError("G729: buffer is not contiguous")
+    mv = mv.cast('B')
+    if mv.readonly:
+        if writable:
+            raise RuntimeError("G729: output buffer is read-only")
+        # ctypes cannot address a read-only buffer other than bytes
+        return mv.tobytes(), mv.nbytes
+    return (ctypes.c_char * mv.nbytes).from_buffer(mv), mv.nbytes
+
+
 class G729Acoder:
     SAMPLES_IN_FRAME = 80
     BYTES_IN_COMPRESSED_FRAME = 10
@@ -37,19 +91,53 @@ class G729Acoder:
         self.inputSize = inputSize
         self.outputSize = outputSize
 
-    def process(self, input: bytearray) -> bytearray:
-        if len(input) != self.inputSize:
-            raise RuntimeError("G729: incorrect input size in process(). Expected: " + str(self.inputSize) +". Got: " + str(len(input)))
-        inData = (ctypes.c_byte * len(input))(*input)
-        outData = (ctypes.c_byte * self.outputSize)()
-        if self._f_process(self._state, inData, outData) != 0:
+    def process(self, input: Any) -> bytearray:
+        inData, size = _buffer_arg(input)
+        if size != self.inputSize:
+            raise RuntimeError("G729: incorrect input size in process(). Expected: " + str(self.inputSize) +". Got: " + str(size))
+        output = bytearray(self.outputSize)
+        if self._f_process(self._state, inData, _buffer_arg(output, True)[0]) != 0:
             raise RuntimeError("G729 process function " + self._f_process.__name__ + " returned error")
-        return bytearray(outData)
+        return output
+
+    def _process_frames(self, nFrames: int, inData: Any, outData: Any) -> int:
+        raise NotImplementedError
+
+    def process_frames(self, input: Any, output: Any = None) -> Any:
+        """Process a whole number of frames in one native call.
+
+        input may be any contiguous buffer (bytes, bytearray, memoryview,
+        array.array, numpy array); it is not copied unless it is read-only and
+        not bytes. The result is written to output if given (any writable
+        buffer of at least the output size), otherwise to a new bytearray,
+        and returned."""
+        inData, size = _buffer_arg(input)
+        if size % self.inputSize != 0:
+            raise RuntimeError("G729: input of process_frames() is not a whole number of frames")
+        nFrames = size // self.inputSize
+        if output is None:
+            output = bytearray(nFrames * self.outputSize)
+        outData, outSize = _buffer_arg(output, True)
+        if outSize < nFrames * self.outputSize:
+            raise RuntimeError("G729: output buffer of process_frames() is too small")
+        if nFrames > 0 and self._process_frames(nFrames, inData, outData) != 0:
+            raise RuntimeError("G729 process_frames() returned error")
+        return output
+
+
+class G729AJoin(ctypes.Structure):
+    """Report of a join of G729Aencoder.process_parallel()"""
+    _fields_ = [
+        ('frame', ctypes.c_int32),       # first frame after the join
+        ('diffFrames', ctypes.c_int32),  # frames the warm-up coded differently from serial coding,
+                                         # -1 (unbounded) if the states did not meet
+        ('syncFrames', ctypes.c_int32),  # frames until the encoder states met, -1 if they did not
+    ]
 
 
 class G729Aencoder(G729Acoder):
     def __init__(self) -> None:
-        g729aLib = ctypes.CDLL(g729a_lib_path)
+        g729aLib = load_g729a_lib()
         super().__init__(
             g729aLib.G729A_Encoder_Get_Size,
             g729aLib.G729A_Encoder_Init,
@@ -57,11 +145,63 @@ class G729Aencoder(G729Acoder):
             self.SAMPLES_IN_FRAME*2,
             self.BYTES_IN_COMPRESSED_FRAME
         )
+        self._f_frames = g729aLib.G729A_Encoder_Process_Frames
+        self._f_parallel = g729aLib.G729A_Encoder_Process_Parallel
+        self._f_dtx = g729aLib.G729A_Encoder_Process_Private_DTX
+
+    def _process_frames(self, nFrames: int, inData: Any, outData: Any) -> int:
+        return self._f_frames(self._state, inData, nFrames, outData)
+
+    def process_parallel(self, input: bytes, threads: int, warmup: int = 50) -> Tuple[bytearray, List[G729AJoin]]:
+        """Encode a whole signal in blocks on several threads, independently of this encoder's state"""
+        inData, size = _buffer_arg(input)
+        if size % self.inputSize != 0:
+            raise RuntimeError("G729: input of process_parallel() is not a whole number of frames")
+        nFrames = size // self.inputSize
+        output = bytearray(nFrames * self.outputSize)
+        joins = (G729AJoin * max(threads - 1, 1))()
+        nJoins = self._f_parallel(inData, nFrames, _buffer_arg(output, True)[0], threads, warmup, joins)
+        if nJoins < 0:
+            raise RuntimeError("G729 process function " + self._f_parallel.__name__ + " returned error")
+        return output, list(joins[:nJoins])
+
+    def process_private_dtx(self, input: Any) -> bytearray:
+        """Encode a frame with the private voice activity detection and DTX of
+        this library: returns a speech frame (10 bytes), a SID frame (3 bytes) or,
+        in silence, nothing to send (b''). This is not G.729 Annex B and does not
+        interoperate with G.729B peers; decode the stream with
+        G729Adecoder.process_private_dtx(). Only available when the library
+        is built with make PRIVATE_DTX=1, raises RuntimeError otherwise"""
+        inData, size = _buffer_arg(input)
+        if size != self.inputSize:
+            raise RuntimeError("G729: incorrect input size in process_private_dtx(). Expected: " + str(self.inputSize) +". Got: " + str(size))
+        output = bytearray(self.outputSize)
+        n = self._f_dtx(self._state, inData, _buffer_arg(output, True)[0])
+        if n < 0:
+            raise RuntimeError("G729 process function " + self._f_dtx.__name__ + " returned error")
+        return output[:n]
+
+
+# Decoder output modes, see G729Adecoder
+POSTFILTER_ON = 0      # postfilter and high-pass filter (G.729A)
+POSTFILTER_OFF_HP = 1  # high-pass filter of the raw synthesis
+POSTFILTER_OFF = 2     # raw synthesis, for speech recognition and analytics
+
+
+class G729AParams(ctypes.Structure):
+    """Output arrays of G729A_Decoder_Analyze, NULL to skip a parameter"""
+    _fields_ = [(name, ctypes.c_void_p) for name in
+                ('lsp', 'pitchLag', 'pitchFrac', 'gainPitch', 'gainCode', 'energy')]
+
+
+# Parameters of G729Adecoder.analyze() and their number per frame
+ANALYZE_FIELDS = (('lsp', 10), ('pitchLag', 2), ('pitchFrac', 2),
+                  ('gainPitch', 2), ('gainCode', 2), ('energy', 2))
 
 
 class G729Adecoder(G729Acoder):
-    def __init__(self) -> None:
-        g729aLib = ctypes.CDLL(g729a_lib_path)
+    def __init__(self, postfilter: int = POSTFILTER_ON) -> None:
+        g729aLib = load_g729a_lib()
         super().__init__(
             g729aLib.G729A_Decoder_Get_Size,
             g729aLib.G729A_Decoder_Init,
@@ -69,23 +209,203 @@ class G729Adecoder(G729Acoder):
             self.BYTES_IN_COMPRESSED_FRAME,
             self.SAMPLES_IN_FRAME*2
         )
+        self._f_frames = g729aLib.G729A_Decoder_Process_Frames
+        self._f_postfilter = g729aLib.G729A_Decoder_Set_Postfilter
+        self._f_analyze = g729aLib.G729A_Decoder_Analyze
+        self._f_dtx = g729aLib.G729A_Decoder_Process_Private_DTX
+        self.set_postfilter(postfilter)
+
+    def set_postfilter(self, mode: int) -> None:
+        """Select the output of the frames decoded from now on: POSTFILTER_ON, or
+        POSTFILTER_OFF_HP / POSTFILTER_OFF to skip the postfilter for machine consumers"""
+        if self._f_postfilter(self._state, mode) != 0:
+            raise RuntimeError("G729: invalid postfilter mode " + str(mode))
+
+    def _process_frames(self, nFrames: int, inData: Any, outData: Any) -> int:
+        return self._f_frames(self._state, inData, nFrames, None, outData)
+
+    def process_private_dtx(self, input: Any) -> bytearray:
+        """Decode a frame of G729Aencoder.process_private_dtx() (not G.729 Annex B):
+        a speech or SID frame, or b'' (None) for a frame not sent, which gives
+        comfort noise. Only available when the library is built with
+        make PRIVATE_DTX=1, raises RuntimeError otherwise"""
+        if input is None:
+            input = b''
+        inData, size = _buffer_arg(input)
+        output = bytearray(self.outputSize)
+        if self._f_dtx(self._state, inData if size > 0 else None, size, _buffer_arg(output, True)[0]) != 0:
+            raise RuntimeError("G729 process function " + self._f_dtx.__name__ + " returned error")
+        return output
 
+    def analyze(self, input: Any, fields: Sequence[str] = None) -> Dict[str, 'array.array']:
+        """Decode the parameters of whole frames without the synthesis, many
+        times faster than process_frames(). Returns one array.array('h') per
+        field of ANALYZE_FIELDS (all by default): LSPs in Q15, pitch lag and
+        fraction, pitch gain in Q14, codebook gain in Q1 and energy of the
+        codebook contribution in dB in Q8, per frame or per subframe"""
+        inData, size = _buffer_arg(input)
+        if size % self.inputSize != 0:
+            raise RuntimeError("G729: input of analyze() is not a whole number of frames")
+        nFrames = size // self.inputSize
+        result = {}
+        params = G729AParams()
+        for name, count in ANALYZE_FIELDS:
+            if fields is None or name in fields:
+                result[name] = array.array('h', bytes(2 * count * nFrames))
+                setattr(params, name, result[name].buffer_info()[0])
+        if nFrames > 0 and self._f_analyze(self._state, inData, nFrames, None, ctypes.byref(params)) != 0:
+            raise RuntimeError("G729 analyze() returned error")
+        return result
 
-def convert_wav_to_g729(coder: G729Acoder, infile_path: str, outfile_path: str) -> None:
-    with open(infile_path, 'rb') as infile, open(outfile_path, 'wb') as outfile:
-        while True:
-            buff = infile.read(coder.inputSize)
-            if not buff:
-                # End of file
-                break
-            if len(buff) < coder.inputSize:
+
+class G729Alevel:
+    """Level (dB, of the excitation) and voice activity of a stream, estimated
+    from the gain indexes of the encoded frames without decoding them"""
+    def __init__(self) -> None:
+        self._lib = load_g729a_lib()
+        self._state = (ctypes.c_byte * self._lib.G729A_Level_Get_Size())()
+        self._lib.G729A_Level_Init(self._state)
+
+    def process(self, input: Any) -> Tuple['array.array', 'array.array']:
+        """Level in dB (Q8) and voice activity (0/1) of each frame of input"""
+        inData, size = _buffer_arg(input)
+        if size % G729Acoder.BYTES_IN_COMPRESSED_FRAME != 0:
+            raise RuntimeError("G729: input of process() is not a whole number of frames")
+        nFrames = size // G729Acoder.BYTES_IN_COMPRESSED_FRAME
+        level = array.array('h', bytes(2 * nFrames))
+        active = array.array('h', bytes(2 * nFrames))
+        if nFrames > 0 and self._lib.G729A_Level_Process(self._state, inData, nFrames, None,
+                                                         level.buffer_info()[0], active.buffer_info()[0]) != 0:
+            raise RuntimeError("G729 level process() returned error")
+        return level, active
+
+    @staticmethod
+    def rank(streams: Sequence['G729Alevel'], frames: Any, n: int) -> List[int]:
+        """Feed one frame per stream (len(streams) * 10 bytes) and return the
+        indexes of the n loudest streams with speech, loudest first"""
+        inData, size = _buffer_arg(frames)
+        if size != len(streams) * G729Acoder.BYTES_IN_COMPRESSED_FRAME:
+            raise RuntimeError("G729: rank() needs one frame per stream")
+        lib = load_g729a_lib()
+        states = (ctypes.c_void_p * len(streams))(*[ctypes.addressof(s._state) for s in streams])
+        loudest = (ctypes.c_int32 * max(n, 1))()
+        count = lib.G729A_Level_Rank(states, len(streams), inData, None, n, loudest)
+        if count < 0:
+            raise RuntimeError("G729 rank() returned error")
+        return list(loudest[:count])
+
+
+BLOCK_FRAMES = 1000  # frames (10 s) per native call of the file converters
+
+
+def process_file(coder: G729Acoder, infile: BinaryIO, outfile: BinaryIO, pad: bool = True) -> None:
+    """Run the coder over a file, BLOCK_FRAMES frames per native call, in buffers
+    allocated once. A partial last frame is padded with zeros, or dropped."""
+    inBuff = bytearray(BLOCK_FRAMES * coder.inputSize)
+    outBuff = bytearray(BLOCK_FRAMES * coder.outputSize)
+    inView, outView = memoryview(inBuff), memoryview(outBuff)
+    while True:
+        n = infile.readinto(inBuff)
+        if not n:
+            # End of file
+            break
+        if n % coder.inputSize:
+            if not pad:
+                n -= n % coder.inputSize
+            else:
                 # Handle partial frame - pad with zeros
-                buff = buff.ljust(coder.inputSize, b'\0')
-            processed_data = coder.process(bytearray(buff))
+                m = n + coder.inputSize - n % coder.inputSize
+                inView[n:m] = bytes(m - n)
+                n = m
+        nFrames = n // coder.inputSize
+        coder.process_frames(inView[:n], outView)
+        outfile.write(outView[:nFrames * coder.outputSize])
+
+
+class _WavReader:
+    """readinto() over the samples of an 8 kHz mono 16-bit WAV file, for process_file()"""
+    def __init__(self, wf: 'wave.Wave_read', path: str) -> None:
+        if (wf.getnchannels(), wf.getsampwidth(), wf.getframerate()) != (1, 2, 8000):
+            raise RuntimeError("G729: " + path + " is not 8 kHz mono 16-bit")
+        self._wf = wf
+
+    def readinto(self, b: bytearray) -> int:
+        data = self._wf.readframes(len(b) // 2)
+        b[:len(data)] = data
+        return len(data)
+
+
+class _WavWriter:
+    """write() of the samples of an 8 kHz mono 16-bit WAV file, for process_file();
+    the sizes in the header are set when the wave file is closed"""
+    def __init__(self, wf: 'wave.Wave_write') -> None:
+        wf.setnchannels(1)
+        wf.setsampwidth(2)
+        wf.setframerate(8000)
+        self._wf = wf
+
+    def write(self, data: Any) -> None:
+        self._wf.writeframesraw(data)
+
+
+def _is_wav(path: str) -> bool:
+    with open(path, 'rb') as infile:
+        return infile.read(4) == b'RIFF'
+
+
+def convert_wav_to_g729(coder: G729Acoder, infile_path: str, outfile_path: str, threads: int = 1, warmup: int = 50) -> None:
+    """Encode a WAV (8 kHz mono 16-bit) or raw PCM file with coder, whose state
+    carries on from the frames it already encoded; with threads > 1 the file is
+    encoded in parallel from a fresh encoder state (G729Aencoder.process_parallel),
+    and the state of coder is neither used nor updated"""
+    if isinstance(coder, G729Aencoder) and threads > 1:
+        if _is_wav(infile_path):
+            with wave.open(infile_path, 'rb') as wf:
+                if (wf.getnchannels(), wf.getsampwidth(), wf.getframerate()) != (1, 2, 8000):
+                    raise RuntimeError("G729: " + infile_path + " is not 8 kHz mono 16-bit")
+                buff = wf.readframes(wf.getnframes())
+        else:
+            with open(infile_path, 'rb') as infile:
+                buff = infile.read()
+        if len(buff) % coder.inputSize:
+            # Handle partial frame - pad with zeros
+            buff = buff.ljust(len(buff) + coder.inputSize - len(buff) % coder.inputSize, b'\0')
+        processed_data, joins = coder.process_parallel(buff, threads, warmup)
+        with open(outfile_path, 'wb') as outfile:
             outfile.write(processed_data)
+        for join in joins:
+            if join.diffFrames < 0:
+                print('Join at frame %d: states did not meet, any frame of the block may differ' % join.frame)
+            else:
+                print('Join at frame %d: %d frames differed, %s' % (join.frame, join.diffFrames,
+                      'states met after %d frames' % join.syncFrames if join.syncFrames >= 0 else 'states did not meet'))
+    elif isinstance(coder, G729Aencoder) and _is_wav(infile_path):
+        with wave.open(infile_path, 'rb') as wf, open(outfile_path, 'wb') as outfile:
+            process_file(coder, _WavReader(wf, infile_path), outfile)
+    else:
+        with open(infile_path, 'rb') as infile, open(outfile_path, 'wb') as outfile:
+            process_file(coder, infile, outfile)
     print('Done.')
 
 
+def encode_file(infile_path: str, outfile_path: str) -> int:
+    """Encode a WAV (8 kHz mono 16-bit) or raw PCM file in the library, in
+    bounded memory. Returns the number of frames."""
+    nFrames = ctypes.c_int64()
+    if load_g729a_lib().G729A_Encode_File(os.fsencode(infile_path), os.fsencode(outfile_path), ctypes.byref(nFrames)) != 0:
+        raise RuntimeError("G729: cannot encode " + infile_path + " into " + outfile_path)
+    return nFrames.value
+
+
+def decode_file(infile_path: str, outfile_path: str, wav: bool = True) -> int:
+    """Decode a bitstream file into a WAV or raw PCM file in the library, in
+    bounded memory. Returns the number of frames."""
+    nFrames = ctypes.c_int64()
+    if load_g729a_lib().G729A_Decode_File(os.fsencode(infile_path), os.fsencode(outfile_path), int(wav), ctypes.byref(nFrames)) != 0:
+        raise RuntimeError("G729: cannot decode " + infile_path + " into " + outfile_path)
+    return nFrames.value
+
+
 def write_pcm_to_wav(pcm_data: bytes, sample_rate: int, num_channels: int, sample_width: int, wav_file_path: str):
     with wave.open(wav_file_path, 'wb') as wf:
         wf.setnchannels(num_channels)
@@ -95,15 +415,10 @@ def write_pcm_to_wav(pcm_data: bytes, sample_rate: int, num_channels: int, sampl
 
 
 def convert_g729_to_wav(g729_decoder: G729Adecoder, g729_file_path: str, wav_file_path: str):
-    pcm_data = bytearray()
-    with open(g729_file_path, 'rb') as g729_file:
-        while True:
-            input_data = g729_file.read(g729_decoder.inputSize)
-            if not input_data:
-                break
-            output_data = g729_decoder.process(bytearray(input_data))
-            pcm_data.extend(output_data)
-    write_pcm_to_wav(pcm_data, sample_rate=8000, num_channels=1, sample_width=2, wav_file_path=wav_file_path)
+    """Decode a bitstream file into a WAV file with g729_decoder, in its postfilter
+    mode and from the state it is in; a partial last frame is dropped"""
+    with open(g729_file_path, 'rb') as infile, wave.open(wav_file_path, 'wb') as wf:
+        process_file(g729_decoder, infile, _WavWriter(wf), pad=False)
 
 
 if __name__ == "__main__":
@@ -115,9 +430,5 @@ if __name__ == "__main__":
     coder = G729Aencoder() if sys.argv[1] == 'encode' else G729Adecoder() # type: G729Acoder
     
     with open(sys.argv[2], 'rb') as infile, open(sys.argv[3], 'wb') as outfile:
-        while True:
-            buff = infile.read(coder.inputSize)
-            if len(buff) < coder.inputSize:
-                break
-            outfile.write(coder.process(bytearray(buff)))
-    print('Done.')
\ No newline at end of file
+        process_file(coder, infile, outfile, pad=False)
+    print('Done.')
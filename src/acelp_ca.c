@@ -46,6 +46,7 @@
 #include "g729a_typedef.h"
 #include "basic_op.h"
 #include "ld8a.h"
+#include "simd_func.h"
 
 /* Constants defined in ld8a.h */
 /*  L_SUBFR   -> Lenght of subframe.                                        */
@@ -56,9 +57,14 @@
 
 /* local routines definition */
 
-static void Cor_h(
+static void Cor_h_scale(
     G729_Word16 *H,         /* (i) Q12 :Impulse response of filters */
-    G729_Word16 *rr         /* (o)     :Correlations of H[]         */
+    G729_Word16 *h          /* (o)     :Scaled impulse response     */
+);
+
+static void Cor_h_mac(
+    G729_Word16 *h,         /* (i)     :Scaled impulse response     */
+    G729_Word16 *rr         /* (o)     :Correlations of h[]         */
 );
 
 static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.               */
@@ -98,7 +104,7 @@ G729_Word16  g729_ACELP_Code_A(    /* (o)     :index of pulses positions    */
         for (i = T0; i < L_SUBFR; i++)     /* h[i] += pitch_sharp*h[i-T0] */
             h[i] = g729_add(h[i], g729_mult(h[i-T0], sharp));
     
-    Cor_h(h, rr);
+    g729_Cor_h(h, rr);
     
     /*-----------------------------------------------------------------*
      * Compute correlation of target vector with impulse response.     *
@@ -127,33 +133,64 @@ G729_Word16  g729_ACELP_Code_A(    /* (o)     :index of pulses positions    */
 
 
 /*--------------------------------------------------------------------------*
- *  Function  Cor_h()                                                       *
- *  ~~~~~~~~~~~~~~~~~                                                       *
+ *  Function  g729_Cor_h()                                                  *
+ *  ~~~~~~~~~~~~~~~~~~~~~~                                                  *
  * Compute  correlations of h[]  needed for the codebook search.            *
+ *                                                                          *
+ * g729_Cor_h_rr() builds the tables row by row in the order they are read  *
+ * by D4i40_17_fast(). The ITU loops of Cor_h_mac() are used when the       *
+ * L_mac() chains could saturate and in builds without SIMD.                *
  *--------------------------------------------------------------------------*/
 
-static void Cor_h(
+void g729_Cor_h(
     G729_Word16 *H,     /* (i) Q12 :Impulse response of filters */
     G729_Word16 *rr     /* (o)     :Correlations of H[]         */
 )
 {
-    G729_Word16 *rri0i0, *rri1i1, *rri2i2, *rri3i3, *rri4i4;
-    G729_Word16 *rri0i1, *rri0i2, *rri0i3, *rri0i4;
-    G729_Word16 *rri1i2, *rri1i3, *rri1i4;
-    G729_Word16 *rri2i3, *rri2i4;
+    G729_Word16 h[L_SUBFR];
     
-    G729_Word16 *p0, *p1, *p2, *p3, *p4;
+    Cor_h_scale(H, h);
     
-    G729_Word16 *ptr_hd, *ptr_hf, *ptr_h1, *ptr_h2;
-    G729_Word32 cor;
-    G729_Word16 i, k, ldec, l_fin_sup, l_fin_inf;
+    if (g729_Cor_h_rr(h, rr) != 0)
+    {
+        Cor_h_mac(h, rr);
+    }
+    
+    return;
+}
+
+/*--------------------------------------------------------------------------*
+ *  Function  g729_Cor_h_ref()                                              *
+ *  ~~~~~~~~~~~~~~~~~~~~~~~~~~                                              *
+ * Same as g729_Cor_h() with the ITU loops only.                            *
+ *--------------------------------------------------------------------------*/
+
+void g729_Cor_h_ref(
+    G729_Word16 *H,     /* (i) Q12 :Impulse response of filters */
+    G729_Word16 *rr     /* (o)     :Correlations of H[]         */
+)
+{
     G729_Word16 h[L_SUBFR];
     
-    /* Scaling h[] for maximum precision */
+    Cor_h_scale(H, h);
+    Cor_h_mac(h, rr);
+    
+    return;
+}
+
+/*--------------------------------------------------------------------------*
+ * Scaling h[] for maximum precision                                        *
+ *--------------------------------------------------------------------------*/
+
+static void Cor_h_scale(
+    G729_Word16 *H,     /* (i) Q12 :Impulse response of filters */
+    G729_Word16 *h      /* (o)     :Scaled impulse response     */
+)
+{
+    G729_Word32 cor;
+    G729_Word16 i, k;
     
-    cor = 0;
-    for(i=0; i<L_SUBFR; i++)
-        cor = g729_L_mac(cor, H[i], H[i]);
+    cor = g729_Dot_mac(0, H, H, L_SUBFR, 0);
     
     if(g729_sub(g729_extract_h(cor),32000) > 0)
     {
@@ -171,6 +208,28 @@ static void Cor_h(
         }
     }
     
+    return;
+}
+
+/*--------------------------------------------------------------------------*
+ * Correlations of the scaled h[] with the L_mac() chains of the ITU code   *
+ *--------------------------------------------------------------------------*/
+
+static void Cor_h_mac(
+    G729_Word16 *h,     /* (i)     :Scaled impulse response     */
+    G729_Word16 *rr     /* (o)     :Correlations of h[]         */
+)
+{
+    G729_Word16 *rri0i0, *rri1i1, *rri2i2, *rri3i3, *rri4i4;
+    G729_Word16 *rri0i1, *rri0i2, *rri0i3, *rri0i4;
+    G729_Word16 *rri1i2, *rri1i3, *rri1i4;
+    G729_Word16 *rri2i3, *rri2i4;
+    
+    G729_Word16 *p0, *p1, *p2, *p3, *p4;
+    
+    G729_Word16 *ptr_hd, *ptr_hf, *ptr_h1, *ptr_h2;
+    G729_Word32 cor;
+    G729_Word16 i, k, ldec, l_fin_sup, l_fin_inf;
     
     /*------------------------------------------------------------*
      * Compute rri0i0[], rri1i1[], rri2i2[], rri3i3 and rri4i4[]  *
@@ -462,14 +521,17 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
 )
 {
     G729_Word16 i0, i1, i2, i3, ip0, ip1, ip2, ip3;
-    G729_Word16 i, j, ix, iy, track, trk, max;
+    G729_Word16 i, j, k, ix, iy, track, trk, max;
     G729_Word16 prev_i0, i1_offset;
-    G729_Word16 psk, ps, ps0, ps1, ps2, sq, sq2;
-    G729_Word16 alpk, alp, alp_16;
-    G729_Word32 s, alp0, alp1, alp2;
-    G729_Word16 *p0, *p1, *p2, *p3, *p4;
-    G729_Word16 sign_dn[L_SUBFR], sign_dn_inv[L_SUBFR], *psign;
-    G729_Word16 tmp_vect[NB_POS];
+    G729_Word16 psk, ps, ps0, ps1, sq;
+    G729_Word16 alpk, alp;
+    G729_Word32 s, alp0, alp1;
+    G729_Word16 *p0, *p1, *p2, *p3;
+    G729_Word16 sign_dn[L_SUBFR];
+    G729_Word16 sign_trk[L_SUBFR], sign_trk_inv[L_SUBFR], dn_trk[L_SUBFR];
+    G729_Word16 tmp_vect[NB_POS], rr_col[NB_POS];
+    G729_Word16 ps1_v[NB_POS];
+    G729_Word32 alp1_v[NB_POS];
     G729_Word16 *rri0i0, *rri1i1, *rri2i2, *rri3i3, *rri4i4;
     G729_Word16 *rri0i1, *rri0i2, *rri0i3, *rri0i4;
     G729_Word16 *rri1i2, *rri1i3, *rri1i4;
@@ -505,70 +567,46 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
         if (dn[i] >= 0)
         {
             sign_dn[i] = G729A_MAX_16;
-            sign_dn_inv[i] = G729A_MIN_16;
         }
         else
         {
             sign_dn[i] = G729A_MIN_16;
-            sign_dn_inv[i] = G729A_MAX_16;
             dn[i] = g729_negate(dn[i]);
         }
     }
     
     /*-------------------------------------------------------------------*
-     * Modification of rrixiy[] to take signs into account.              *
+     * Reorder signs and dn[] by track: x_trk[t*NB_POS+k] = x[t+k*STEP]  *
+     * so that the 8 positions of a track are contiguous.                *
      *-------------------------------------------------------------------*/
     
-    p0 = rri0i1;
-    p1 = rri0i2;
-    p2 = rri0i3;
-    p3 = rri0i4;
-    
-    for(i0=0; i0<L_SUBFR; i0+=STEP)
+    for (track=0, j=0; track<STEP; track++)
     {
-        psign = sign_dn;
-        if (psign[i0] < 0) psign = sign_dn_inv;
-        
-        for(i1=1; i1<L_SUBFR; i1+=STEP)
+        for (i=track; i<L_SUBFR; i+=STEP, j++)
         {
-            *p0 = g729_mult(*p0, psign[i1]);     ++p0;
-            *p1 = g729_mult(*p1, psign[i1+1]);   ++p1;
-            *p2 = g729_mult(*p2, psign[i1+2]);   ++p2;
-            *p3 = g729_mult(*p3, psign[i1+3]);   ++p3;
+            sign_trk[j] = sign_dn[i];
+            sign_trk_inv[j] = (sign_dn[i] < 0) ? G729A_MAX_16 : G729A_MIN_16;
+            dn_trk[j] = dn[i];
         }
     }
     
-    p0 = rri1i2;
-    p1 = rri1i3;
-    p2 = rri1i4;
+    /*-------------------------------------------------------------------*
+     * Modification of rrixiy[] to take signs into account.              *
+     * Row i of rrixiy[] is multiplied by the signs of track y, inverted *
+     * when the sign of position i of track x is negative.               *
+     *-------------------------------------------------------------------*/
     
-    for(i1=1; i1<L_SUBFR; i1+=STEP)
-    {
-        psign = sign_dn;
-        if (psign[i1] < 0) psign = sign_dn_inv;
-        
-        for(i2=2; i2<L_SUBFR; i2+=STEP)
-        {
-            *p0 = g729_mult(*p0, psign[i2]);   ++p0;
-            *p1 = g729_mult(*p1, psign[i2+1]); ++p1;
-            *p2 = g729_mult(*p2, psign[i2+2]); ++p2;
-        }
-    }
+    g729_Mult_rows(rri0i1, NB_POS, &sign_trk[0*NB_POS], &sign_trk[1*NB_POS], &sign_trk_inv[1*NB_POS]);
+    g729_Mult_rows(rri0i2, NB_POS, &sign_trk[0*NB_POS], &sign_trk[2*NB_POS], &sign_trk_inv[2*NB_POS]);
+    g729_Mult_rows(rri0i3, NB_POS, &sign_trk[0*NB_POS], &sign_trk[3*NB_POS], &sign_trk_inv[3*NB_POS]);
+    g729_Mult_rows(rri0i4, NB_POS, &sign_trk[0*NB_POS], &sign_trk[4*NB_POS], &sign_trk_inv[4*NB_POS]);
     
-    p0 = rri2i3;
-    p1 = rri2i4;
+    g729_Mult_rows(rri1i2, NB_POS, &sign_trk[1*NB_POS], &sign_trk[2*NB_POS], &sign_trk_inv[2*NB_POS]);
+    g729_Mult_rows(rri1i3, NB_POS, &sign_trk[1*NB_POS], &sign_trk[3*NB_POS], &sign_trk_inv[3*NB_POS]);
+    g729_Mult_rows(rri1i4, NB_POS, &sign_trk[1*NB_POS], &sign_trk[4*NB_POS], &sign_trk_inv[4*NB_POS]);
     
-    for(i2=2; i2<L_SUBFR; i2+=STEP)
-    {
-        psign = sign_dn;
-        if (psign[i2] < 0) psign = sign_dn_inv;
-        
-        for(i3=3; i3<L_SUBFR; i3+=STEP)
-        {
-            *p0 = g729_mult(*p0, psign[i3]);   ++p0;
-            *p1 = g729_mult(*p1, psign[i3+1]); ++p1;
-        }
-    }
+    g729_Mult_rows(rri2i3, NB_POS, &sign_trk[2*NB_POS], &sign_trk[3*NB_POS], &sign_trk_inv[3*NB_POS]);
+    g729_Mult_rows(rri2i4, NB_POS, &sign_trk[2*NB_POS], &sign_trk[4*NB_POS], &sign_trk_inv[4*NB_POS]);
     
     
     /*-------------------------------------------------------------------*
@@ -586,7 +624,7 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
     
     /* Initializations only to remove warning from some compilers */
     
-    ip0=0; ip1=1; ip2=2; ip3=3; ix=0; iy=0; ps=0;
+    ip0=0; ip1=1; ip2=2; ip3=3; ix=0; iy=0; ps=0; i0=0;
     
     /* search 2 times: track 3 and 4 */
     for (track=3, trk=0; track<5; track++, trk++)
@@ -627,26 +665,13 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
             p0 = ptr_rri2i3_i4 + g729_shl(j, 3);
             p1 = ptr_rri3i3_i4;
             
-            for (i1=track; i1<L_SUBFR; i1+=STEP)
+            /* alp1 = alp0 + rr[i0][i1] + 1/2*rr[i1][i1]; */
+            k = g729_Acelp_cand(1, &ps1, &dn_trk[track*NB_POS], &alp1, p0, _1_2, p1, _1_4,
+                                &sq, &alp, &ps);
+            if (k >= 0)
             {
-                ps2 = g729_add(ps1, dn[i1]);       /* index increment = STEP */
-                
-                /* alp1 = alp0 + rr[i0][i1] + 1/2*rr[i1][i1]; */
-                alp2 = g729_L_mac(alp1, *p0++, _1_2);
-                alp2 = g729_L_mac(alp2, *p1++, _1_4);
-                
-                sq2 = g729_mult(ps2, ps2);
-                alp_16 = g729_round(alp2);
-                
-                s = g729_L_msu(g729_L_mult(alp,sq2),sq,alp_16);
-                if (s > 0)
-                {
-                    sq = sq2;
-                    ps = ps2;
-                    alp = alp_16;
-                    ix = i0;
-                    iy = i1;
-                }
+                ix = i0;
+                iy = track + k*STEP;
             }
         }
         
@@ -685,41 +710,26 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
         p0 = rri0i2 + g729_mult(i0, 6554);
         p1 = ptr_rri0i3_i4 + g729_mult(i1, 6554);
         p2 = rri0i0;
-        p3 = rri0i1;
         
-        for (i2=0; i2<L_SUBFR; i2+=STEP)
+        for (i2=0, k=0; i2<L_SUBFR; i2+=STEP, k++)
         {
-            ps1 = g729_add(ps0, dn[i2]);         /* index increment = STEP */
+            ps1_v[k] = g729_add(ps0, dn[i2]);         /* index increment = STEP */
             
             /* alp1 = alp0 + rr[i0][i2] + rr[i1][i2] + 1/2*rr[i2][i2]; */
             alp1 = g729_L_mac(alp0, *p0, _1_8);       p0 += NB_POS;
             alp1 = g729_L_mac(alp1, *p1, _1_8);       p1 += NB_POS;
-            alp1 = g729_L_mac(alp1, *p2++, _1_16);
-            
-            /* i3 loop: 8 positions in track 1 */
-            
-            p4 = tmp_vect;
-            
-            for (i3=1; i3<L_SUBFR; i3+=STEP)
-            {
-                ps2 = g729_add(ps1, dn[i3]);       /* index increment = STEP */
-                
-                /* alp1 = alp0 + rr[i0][i3] + rr[i1][i3] + rr[i2][i3] + 1/2*rr[i3][i3]; */
-                alp2 = g729_L_mac(alp1, *p3++, _1_8);
-                alp2 = g729_L_mac(alp2, *p4++, _1_2);
-                
-                sq2 = g729_mult(ps2, ps2);
-                alp_16 = g729_round(alp2);
-                
-                s = g729_L_msu(g729_L_mult(alp,sq2),sq,alp_16);
-                if (s > 0)
-                {
-                    sq = sq2;
-                    alp = alp_16;
-                    ix = i2;
-                    iy = i3;
-                }
-            }
+            alp1_v[k] = g729_L_mac(alp1, *p2++, _1_16);
+        }
+        
+        /* i3 loop: 8 positions in track 1, for each i2 */
+        /* alp2 = alp1 + rr[i2][i3] + 1/2*rr[i3][i3]; */
+        
+        k = g729_Acelp_cand(NB_POS, ps1_v, &dn_trk[1*NB_POS], alp1_v, rri0i1, _1_8, tmp_vect, _1_2,
+                            &sq, &alp, 0);
+        if (k >= 0)
+        {
+            ix = 0 + (k >> 3)*STEP;
+            iy = 1 + (k & 7)*STEP;
         }
         
         /*----------------------------------------------------------------*
@@ -771,28 +781,19 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
             /* i1 loop: 8 positions in track 0 */
             
             p0 = ptr_rri0i3_i4 + j;
-            p1 = rri0i0;
             
-            for (i1=0; i1<L_SUBFR; i1+=STEP)
+            for (k=0; k<NB_POS; k++, p0 += NB_POS)
             {
-                ps2 = g729_add(ps1, dn[i1]);       /* index increment = STEP */
-                
-                /* alp1 = alp0 + rr[i0][i1] + 1/2*rr[i1][i1]; */
-                alp2 = g729_L_mac(alp1, *p0, _1_2);       p0 += NB_POS;
-                alp2 = g729_L_mac(alp2, *p1++, _1_4);
-                
-                sq2 = g729_mult(ps2, ps2);
-                alp_16 = g729_round(alp2);
-                
-                s = g729_L_msu(g729_L_mult(alp,sq2),sq,alp_16);
-                if (s > 0)
-                {
-                    sq = sq2;
-                    ps = ps2;
-                    alp = alp_16;
-                    ix = i0;
-                    iy = i1;
-                }
+                rr_col[k] = *p0;
+            }
+            
+            /* alp1 = alp0 + rr[i0][i1] + 1/2*rr[i1][i1]; */
+            k = g729_Acelp_cand(1, &ps1, &dn_trk[0*NB_POS], &alp1, rr_col, _1_2, rri0i0, _1_4,
+                                &sq, &alp, &ps);
+            if (k >= 0)
+            {
+                ix = i0;
+                iy = k*STEP;
             }
         }
         
@@ -831,41 +832,26 @@ static G729_Word16 D4i40_17_fast(/*(o) : Index of pulses positions.
         p0 = ptr_rri1i3_i4 + g729_mult(i0, 6554);
         p1 = rri0i1 + i1_offset;
         p2 = rri1i1;
-        p3 = rri1i2;
         
-        for (i2=1; i2<L_SUBFR; i2+=STEP)
+        for (i2=1, k=0; i2<L_SUBFR; i2+=STEP, k++)
         {
-            ps1 = g729_add(ps0, dn[i2]);         /* index increment = STEP */
+            ps1_v[k] = g729_add(ps0, dn[i2]);         /* index increment = STEP */
             
             /* alp1 = alp0 + rr[i0][i2] + rr[i1][i2] + 1/2*rr[i2][i2]; */
             alp1 = g729_L_mac(alp0, *p0, _1_8);       p0 += NB_POS;
             alp1 = g729_L_mac(alp1, *p1++, _1_8);
-            alp1 = g729_L_mac(alp1, *p2++, _1_16);
-            
-            /* i3 loop: 8 positions in track 2 */
-            
-            p4 = tmp_vect;
-            
-            for (i3=2; i3<L_SUBFR; i3+=STEP)
-            {
-                ps2 = g729_add(ps1, dn[i3]);       /* index increment = STEP */
-                
-                /* alp1 = alp0 + rr[i0][i3] + rr[i1][i3] + rr[i2][i3] + 1/2*rr[i3][i3]; */
-                alp2 = g729_L_mac(alp1, *p3++, _1_8);
-                alp2 = g729_L_mac(alp2, *p4++, _1_2);
-                
-                sq2 = g729_mult(ps2, ps2);
-                alp_16 = g729_round(alp2);
-                
-                s = g729_L_msu(g729_L_mult(alp,sq2),sq,alp_16);
-                if (s > 0)
-                {
-                    sq = sq2;
-                    alp = alp_16;
-                    ix = i2;
-                    iy = i3;
-                }
-            }
+            alp1_v[k] = g729_L_mac(alp1, *p2++, _1_16);
+        }
+        
+        /* i3 loop: 8 positions in track 2, for each i2 */
+        /* alp2 = alp1 + rr[i2][i3] + 1/2*rr[i3][i3]; */
+        
+        k = g729_Acelp_cand(NB_POS, ps1_v, &dn_trk[2*NB_POS], alp1_v, rri1i2, _1_8, tmp_vect, _1_2,
+                            &sq, &alp, 0);
+        if (k >= 0)
+        {
+            ix = 1 + (k >> 3)*STEP;
+            iy = 2 + (k & 7)*STEP;
         }
         
         /*----------------------------------------------------------------*
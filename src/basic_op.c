@@ -62,10 +62,14 @@
 
 /* G729_Flag Carry =0; */
 
-#if !defined(USE_GLOBAL_OVERFLOW_FLAG) || (USE_GLOBAL_OVERFLOW_FLAG != 1)
-static
+#if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
+G729A_THREAD_LOCAL G729_Flag G729A_Overflow_Flag = 0;
+#elif !defined(USE_INLINE_BASIC_OP) || (USE_INLINE_BASIC_OP != 1)
+static G729A_THREAD_LOCAL G729_Flag G729A_Overflow_Flag = 0;
 #endif
-G729_Flag G729A_Overflow_Flag = 0;
+
+/* With USE_INLINE_BASIC_OP the operators below come from basic_op_inline.h */
+#if !defined(USE_INLINE_BASIC_OP) || (USE_INLINE_BASIC_OP != 1)
 
 /*___________________________________________________________________________
  |                                                                           |
@@ -1534,6 +1538,8 @@ G729_Word32 g729_L_shr_r(G729_Word32 L_var1,G729_Word16 var2)
     return(L_var_out);
 }
 
+#endif  /* USE_INLINE_BASIC_OP */
+
 /*___________________________________________________________________________
  |                                                                           |
  |   Function Name : g729_div_s                                              |
@@ -52,19 +52,37 @@
 #define G729A_MAX_16 (G729_Word16)0x7fff
 #define G729A_MIN_16 (G729_Word16)0x8000
 
+/* The overflow flag is per thread so that channels can run on any thread */
+#if defined(_MSC_VER)
+#define G729A_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define G729A_THREAD_LOCAL _Thread_local
+#else
+#define G729A_THREAD_LOCAL __thread
+#endif
+
 #if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
-extern G729_Flag G729A_Overflow_Flag;
+extern G729A_THREAD_LOCAL G729_Flag G729A_Overflow_Flag;
 #endif
 
 /*___________________________________________________________________________
  |                                                                           |
  |   Operators prototypes                                                    |
+ |                                                                           |
+ |   Build with USE_INLINE_BASIC_OP=1 to get the operators as static inline  |
+ |   functions (basic_op_inline.h) instead of calls into basic_op.c.         |
  |___________________________________________________________________________|
 */
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(USE_INLINE_BASIC_OP) && (USE_INLINE_BASIC_OP == 1)
+
+#include "basic_op_inline.h"
+
+#else
+
 /*----------------------------------------------*
  * Never overflow                               *
  *----------------------------------------------*/
@@ -102,6 +120,9 @@ G729_Word16 g729_shr_r(G729_Word16 var1, G729_Word16 var2);   /* Shift right wit
 G729_Word16 g729_mac_r(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2);/* Mac with rounding, 2*/
 G729_Word16 g729_msu_r(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2);/* Msu with rounding, 2*/
 G729_Word32 g729_L_shr_r(G729_Word32 L_var1, G729_Word16 var2);  /* Long shift right with round,  3*/
+
+#endif  /* USE_INLINE_BASIC_OP */
+
 G729_Word16 g729_div_s(G729_Word16 var1, G729_Word16 var2);      /* Short division,      18 */
 
 /*----------------------------------------------*
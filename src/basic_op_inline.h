@@ -0,0 +1,386 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ *  Portions of this file are derived from the following ITU notice:
+ *
+ *  ITU-T G.729 Software Package Release 2 (November 2006)
+ *
+ *  ITU-T G.729A Speech Coder    ANSI-C Source Code
+ *  Version 1.1    Last modified: September 1996
+ *
+ *  Copyright (c) 1996,
+ *  AT&T, France Telecom, NTT, Universite de Sherbrooke
+ *  All rights reserved.
+ */
+
+/*___________________________________________________________________________
+ |                                                                           |
+ |   Inline basic operators.                                                 |
+ |                                                                           |
+ |   Included by basic_op.h when USE_INLINE_BASIC_OP is 1. Every operator    |
+ |   gives the same result as its reference version in basic_op.c, and sets  |
+ |   G729A_Overflow_Flag the same way when USE_GLOBAL_OVERFLOW_FLAG is 1.    |
+ |   Without the global flag nobody reads the flag, so it is not written.    |
+ |___________________________________________________________________________|
+*/
+
+#ifndef __G729_BASIC_OP_INLINE_H__
+#define __G729_BASIC_OP_INLINE_H__
+
+#if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
+#define G729A_SET_OVERFLOW(flag)    (G729A_Overflow_Flag = (flag))
+#else
+#define G729A_SET_OVERFLOW(flag)    ((void)0)
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5))
+#define G729A_HAVE_OVERFLOW_BUILTINS 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define G729A_INLINE static __inline
+#else
+#define G729A_INLINE static inline
+#endif
+
+G729A_INLINE G729_Word16 g729_shr(G729_Word16 var1, G729_Word16 var2);
+G729A_INLINE G729_Word32 g729_L_shr(G729_Word32 L_var1, G729_Word16 var2);
+
+/*----------------------------------------------*
+ * Local Functions                              *
+ *----------------------------------------------*/
+
+G729A_INLINE G729_Word16 g729_sature(G729_Word32 L_var1)
+{
+    if (L_var1 > 0X00007fffL)
+    {
+        G729A_SET_OVERFLOW(1);
+        return G729A_MAX_16;
+    }
+    if (L_var1 < (G729_Word32)0xffff8000L)
+    {
+        G729A_SET_OVERFLOW(1);
+        return G729A_MIN_16;
+    }
+    G729A_SET_OVERFLOW(0);
+    return (G729_Word16)L_var1;
+}
+
+/*----------------------------------------------*
+ * Never overflow                               *
+ *----------------------------------------------*/
+
+G729A_INLINE G729_Word16 g729_abs_s(G729_Word16 var1)
+{
+    if (var1 == G729A_MIN_16) return G729A_MAX_16;
+    return (var1 < 0) ? (G729_Word16)-var1 : var1;
+}
+
+G729A_INLINE G729_Word16 g729_negate(G729_Word16 var1)
+{
+    return (var1 == G729A_MIN_16) ? G729A_MAX_16 : (G729_Word16)-var1;
+}
+
+G729A_INLINE G729_Word16 g729_extract_h(G729_Word32 L_var1)
+{
+    return (G729_Word16)(L_var1 >> 16);
+}
+
+G729A_INLINE G729_Word16 g729_extract_l(G729_Word32 L_var1)
+{
+    return (G729_Word16)L_var1;
+}
+
+G729A_INLINE G729_Word32 g729_L_abs(G729_Word32 L_var1)
+{
+    if (L_var1 == G729A_MIN_32) return G729A_MAX_32;
+    return (L_var1 < 0) ? -L_var1 : L_var1;
+}
+
+G729A_INLINE G729_Word32 g729_L_negate(G729_Word32 L_var1)
+{
+    return (L_var1 == G729A_MIN_32) ? G729A_MAX_32 : -L_var1;
+}
+
+G729A_INLINE G729_Word32 g729_L_deposit_h(G729_Word16 var1)
+{
+    return (G729_Word32)((G729_UWord32)(G729_Word32)var1 << 16);
+}
+
+G729A_INLINE G729_Word32 g729_L_deposit_l(G729_Word16 var1)
+{
+    return (G729_Word32)var1;
+}
+
+G729A_INLINE G729_Word16 g729_norm_s(G729_Word16 var1)
+{
+    if (var1 == 0) return 0;
+#if defined(G729A_HAVE_OVERFLOW_BUILTINS)
+    return (G729_Word16)(__builtin_clrsb((int)var1) - 16);
+#else
+    {
+        G729_Word16 var_out;
+        
+        if (var1 == (G729_Word16)0xffff) return 15;
+        if (var1 < 0) var1 = ~var1;
+        for (var_out = 0; var1 < 0x4000; var_out++) var1 <<= 1;
+        return var_out;
+    }
+#endif
+}
+
+G729A_INLINE G729_Word16 g729_norm_l(G729_Word32 L_var1)
+{
+    if (L_var1 == 0) return 0;
+#if defined(G729A_HAVE_OVERFLOW_BUILTINS)
+    return (G729_Word16)__builtin_clrsb(L_var1);
+#else
+    {
+        G729_Word16 var_out;
+        
+        if (L_var1 == (G729_Word32)0xffffffffL) return 31;
+        if (L_var1 < 0) L_var1 = ~L_var1;
+        for (var_out = 0; L_var1 < (G729_Word32)0x40000000L; var_out++) L_var1 <<= 1;
+        return var_out;
+    }
+#endif
+}
+
+/*----------------------------------------------*
+ * Maybe overflow                               *
+ *----------------------------------------------*/
+
+G729A_INLINE G729_Word16 g729_add(G729_Word16 var1, G729_Word16 var2)
+{
+    return g729_sature((G729_Word32)var1 + var2);
+}
+
+G729A_INLINE G729_Word16 g729_sub(G729_Word16 var1, G729_Word16 var2)
+{
+    return g729_sature((G729_Word32)var1 - var2);
+}
+
+G729A_INLINE G729_Word16 g729_shl(G729_Word16 var1, G729_Word16 var2)
+{
+    G729_Word32 resultat;
+    
+    if (var2 < 0) return g729_shr(var1, (G729_Word16)-var2);
+    
+    if (var2 > 15)
+    {
+        if (var1 == 0) return 0;
+        G729A_SET_OVERFLOW(1);
+        return (var1 > 0) ? G729A_MAX_16 : G729A_MIN_16;
+    }
+    
+    resultat = (G729_Word32)var1 * ((G729_Word32)1 << var2);
+    if (resultat != (G729_Word32)((G729_Word16)resultat))
+    {
+        G729A_SET_OVERFLOW(1);
+        return (var1 > 0) ? G729A_MAX_16 : G729A_MIN_16;
+    }
+    return (G729_Word16)resultat;
+}
+
+G729A_INLINE G729_Word16 g729_shr(G729_Word16 var1, G729_Word16 var2)
+{
+    if (var2 < 0) return g729_shl(var1, (G729_Word16)-var2);
+    if (var2 >= 15) return (var1 < 0) ? (G729_Word16)(-1) : (G729_Word16)0;
+    return (var1 < 0) ? (G729_Word16)~((~var1) >> var2) : (G729_Word16)(var1 >> var2);
+}
+
+G729A_INLINE G729_Word16 g729_mult(G729_Word16 var1, G729_Word16 var2)
+{
+    /* (p & 0xffff8000) >> 15 with sign extension is the arithmetic p >> 15 */
+    return g729_sature(((G729_Word32)var1 * (G729_Word32)var2) >> 15);
+}
+
+G729A_INLINE G729_Word32 g729_L_add(G729_Word32 L_var1, G729_Word32 L_var2)
+{
+    G729_Word32 L_var_out;
+    
+#if defined(G729A_HAVE_OVERFLOW_BUILTINS)
+    if (__builtin_add_overflow(L_var1, L_var2, &L_var_out))
+#else
+    L_var_out = (G729_Word32)((G729_UWord32)L_var1 + (G729_UWord32)L_var2);
+    if ((((L_var1 ^ L_var2) & G729A_MIN_32) == 0) && ((L_var_out ^ L_var1) & G729A_MIN_32))
+#endif
+    {
+        G729A_SET_OVERFLOW(1);
+        L_var_out = (L_var1 < 0) ? G729A_MIN_32 : G729A_MAX_32;
+    }
+    return L_var_out;
+}
+
+G729A_INLINE G729_Word32 g729_L_sub(G729_Word32 L_var1, G729_Word32 L_var2)
+{
+    G729_Word32 L_var_out;
+    
+#if defined(G729A_HAVE_OVERFLOW_BUILTINS)
+    if (__builtin_sub_overflow(L_var1, L_var2, &L_var_out))
+#else
+    L_var_out = (G729_Word32)((G729_UWord32)L_var1 - (G729_UWord32)L_var2);
+    if ((((L_var1 ^ L_var2) & G729A_MIN_32) != 0) && ((L_var_out ^ L_var1) & G729A_MIN_32))
+#endif
+    {
+        G729A_SET_OVERFLOW(1);
+        L_var_out = (L_var1 < 0L) ? G729A_MIN_32 : G729A_MAX_32;
+    }
+    return L_var_out;
+}
+
+G729A_INLINE G729_Word32 g729_L_shl(G729_Word32 L_var1, G729_Word16 var2)
+{
+    G729_Word32 L_var_out;
+    
+    if (var2 <= 0) return g729_L_shr(L_var1, (G729_Word16)-var2);
+    
+    if (var2 < 31)
+    {
+        /* Same as the reference loop: saturate if any doubling would overflow */
+        if (L_var1 > ((G729_Word32)0x3fffffffL >> (var2 - 1)))
+        {
+            G729A_SET_OVERFLOW(1);
+            return G729A_MAX_32;
+        }
+        if (L_var1 < ((G729_Word32)0xc0000000L >> (var2 - 1)))
+        {
+            G729A_SET_OVERFLOW(1);
+            return G729A_MIN_32;
+        }
+        return (G729_Word32)((G729_UWord32)L_var1 << var2);
+    }
+    
+    L_var_out = 0;
+    for (; var2 > 0; var2--)
+    {
+        if (L_var1 > (G729_Word32)0X3fffffffL)
+        {
+            G729A_SET_OVERFLOW(1);
+            L_var_out = G729A_MAX_32;
+            break;
+        }
+        if (L_var1 < (G729_Word32)0xc0000000L)
+        {
+            G729A_SET_OVERFLOW(1);
+            L_var_out = G729A_MIN_32;
+            break;
+        }
+        L_var1 *= 2;
+        L_var_out = L_var1;
+    }
+    return L_var_out;
+}
+
+G729A_INLINE G729_Word32 g729_L_shr(G729_Word32 L_var1, G729_Word16 var2)
+{
+    if (var2 < 0) return g729_L_shl(L_var1, (G729_Word16)-var2);
+    if (var2 >= 31) return (L_var1 < 0L) ? -1 : 0;
+    return (L_var1 < 0) ? ~((~L_var1) >> var2) : (L_var1 >> var2);
+}
+
+G729A_INLINE G729_Word32 g729_L_mult(G729_Word16 var1, G729_Word16 var2)
+{
+    G729_Word32 L_var_out;
+    
+    L_var_out = (G729_Word32)var1 * (G729_Word32)var2;
+    if (L_var_out == (G729_Word32)0x40000000L)
+    {
+        G729A_SET_OVERFLOW(1);
+        return G729A_MAX_32;
+    }
+    return L_var_out * 2;
+}
+
+G729A_INLINE G729_Word16 g729_round(G729_Word32 L_var1)
+{
+    return g729_extract_h(g729_L_add(L_var1, (G729_Word32)0x00008000));
+}
+
+G729A_INLINE G729_Word32 g729_L_mac(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2)
+{
+    return g729_L_add(L_var3, g729_L_mult(var1, var2));
+}
+
+G729A_INLINE G729_Word32 g729_L_msu(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2)
+{
+    return g729_L_sub(L_var3, g729_L_mult(var1, var2));
+}
+
+G729A_INLINE G729_Word16 g729_mult_r(G729_Word16 var1, G729_Word16 var2)
+{
+    return g729_sature(((G729_Word32)var1 * (G729_Word32)var2 + (G729_Word32)0x00004000) >> 15);
+}
+
+G729A_INLINE G729_Word16 g729_shr_r(G729_Word16 var1, G729_Word16 var2)
+{
+    G729_Word16 var_out;
+    
+    if (var2 > 15) return 0;
+    
+    var_out = g729_shr(var1, var2);
+    if (var2 > 0)
+    {
+        if ((var1 & ((G729_Word16)1 << (var2-1))) != 0)
+        {
+            var_out++;
+        }
+    }
+    return var_out;
+}
+
+G729A_INLINE G729_Word16 g729_mac_r(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2)
+{
+    L_var3 = g729_L_mac(L_var3, var1, var2);
+    return g729_extract_h(g729_L_add(L_var3, (G729_Word32)0x00008000));
+}
+
+G729A_INLINE G729_Word16 g729_msu_r(G729_Word32 L_var3, G729_Word16 var1, G729_Word16 var2)
+{
+    L_var3 = g729_L_msu(L_var3, var1, var2);
+    return g729_extract_h(g729_L_add(L_var3, (G729_Word32)0x00008000));
+}
+
+G729A_INLINE G729_Word32 g729_L_shr_r(G729_Word32 L_var1, G729_Word16 var2)
+{
+    G729_Word32 L_var_out;
+    
+    if (var2 > 31) return 0;
+    
+    L_var_out = g729_L_shr(L_var1, var2);
+    if (var2 > 0)
+    {
+        if ((L_var1 & ((G729_Word32)1 << (var2-1))) != 0)
+        {
+            L_var_out++;
+        }
+    }
+    return L_var_out;
+}
+
+#endif  /* __G729_BASIC_OP_INLINE_H__ */
+/* end of file */
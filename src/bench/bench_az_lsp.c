@@ -0,0 +1,188 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Micro-benchmark of the LPC to LSP conversion: g729_Az_lsp()       *
+ * against the ITU Chebyshev evaluation of g729_Az_lsp_ref(), in     *
+ * cycles (x86) or nanoseconds per frame. The A(z) of every frame is *
+ * taken from the encoder run on a speech file, by default           *
+ * test_vectors/IN/LSP.IN, and both outputs are compared.            *
+ *                                                                   *
+ *    Usage : bench_az_lsp [speech file] [runs]                      *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+#include "g729a_encoder.h"
+#include "g729a_interface.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#else
+#include <time.h>
+#define BENCH_UNIT  "ns"
+static unsigned long long bench_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+#endif
+
+typedef void (*Az_lsp_func)(G729_Word16 a[], G729_Word16 lsp[], G729_Word16 old_lsp[]);
+
+/* Encodes the file and keeps A(z) and the previous LSPs of each frame, */
+/* returns the number of frames                                          */
+static int load_frames(const char *path, G729_Word16 **a, G729_Word16 **old_lsp)
+{
+    FILE *f;
+    g729a_encoder_state *state;
+    G729_Word16 speech[L_FRAME];
+    G729_UWord8 bits[L_FRAME / 8];
+    int n = 0, cap = 1024;
+
+    if ((f = fopen(path, "rb")) == NULL)
+    {
+        return -1;
+    }
+
+    state = malloc(G729A_Encoder_Get_Size());
+    *a = malloc(sizeof(G729_Word16) * MP1 * cap);
+    *old_lsp = malloc(sizeof(G729_Word16) * M * cap);
+    if ((state == NULL) || (*a == NULL) || (*old_lsp == NULL) || (G729A_Encoder_Init(state) != 0))
+    {
+        fclose(f);
+        return -1;
+    }
+
+    while (fread(speech, sizeof(G729_Word16), L_FRAME, f) == L_FRAME)
+    {
+        if (n == cap)
+        {
+            cap *= 2;
+            *a = realloc(*a, sizeof(G729_Word16) * MP1 * cap);
+            *old_lsp = realloc(*old_lsp, sizeof(G729_Word16) * M * cap);
+            if ((*a == NULL) || (*old_lsp == NULL))
+            {
+                n = -1;
+                break;
+            }
+        }
+        memcpy(&(*old_lsp)[n * M], state->lsp_old, sizeof(G729_Word16) * M);
+        G729A_Encoder_Process(state, speech, bits);
+        memcpy(&(*a)[n * MP1], state->old_A, sizeof(G729_Word16) * MP1);
+        n++;
+    }
+
+    fclose(f);
+    free(state);
+
+    return n;
+}
+
+static double run(Az_lsp_func f, G729_Word16 *a, G729_Word16 *old_lsp, G729_Word16 *lsp,
+                  int n_frame, int runs)
+{
+    int r, s;
+    unsigned long long t, best = 0;
+
+    for (r = 0; r < runs; r++)
+    {
+        t = bench_clock();
+        for (s = 0; s < n_frame; s++)
+        {
+            f(&a[s * MP1], &lsp[s * M], &old_lsp[s * M]);
+        }
+        t = bench_clock() - t;
+        if ((r == 0) || (t < best))
+        {
+            best = t;
+        }
+    }
+
+    return (double)best / n_frame;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "../test_vectors/IN/LSP.IN";
+    int runs = (argc > 2) ? atoi(argv[2]) : 20;
+    G729_Word16 *a, *old_lsp, *lsp_ref, *lsp;
+    double t_ref, t_fast;
+    int n_frame;
+
+    if (runs <= 0)
+    {
+        printf("Usage : bench_az_lsp [speech file] [runs]\n");
+        return 1;
+    }
+
+    n_frame = load_frames(path, &a, &old_lsp);
+    if (n_frame <= 0)
+    {
+        printf("Cannot read frames from %s\n", path);
+        return 1;
+    }
+
+    lsp_ref = malloc(sizeof(G729_Word16) * M * n_frame);
+    lsp = malloc(sizeof(G729_Word16) * M * n_frame);
+    if ((lsp_ref == NULL) || (lsp == NULL))
+    {
+        return 1;
+    }
+
+    t_ref = run(g729_Az_lsp_ref, a, old_lsp, lsp_ref, n_frame, runs);
+    t_fast = run(g729_Az_lsp, a, old_lsp, lsp, n_frame, runs);
+
+    if (memcmp(lsp_ref, lsp, sizeof(G729_Word16) * M * n_frame) != 0)
+    {
+        printf("g729_Az_lsp() and g729_Az_lsp_ref() differ\n");
+        return 1;
+    }
+
+    printf("Az_lsp  %d frames of %s, best of %d runs, %s per frame\n", n_frame, path, runs, BENCH_UNIT);
+    printf("  g729_Az_lsp_ref : %8.0f\n", t_ref);
+    printf("  g729_Az_lsp     : %8.0f\n", t_fast);
+    printf("  speedup         : %8.2f\n", t_ref / t_fast);
+
+    free(a);
+    free(old_lsp);
+    free(lsp_ref);
+    free(lsp);
+
+    return 0;
+}
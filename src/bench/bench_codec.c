@@ -0,0 +1,692 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Throughput benchmark of the G.729A encoder and decoder.           *
+ *                                                                   *
+ * The files are loaded in memory, then every *.IN file (16 bits     *
+ * PCM) is encoded and every *.BIT file (ITU serial bitstream) is    *
+ * decoded, runs times, without any I/O in the timed loops. The      *
+ * best run gives ns/frame and channels per core (one channel costs  *
+ * one frame every 10 ms).                                           *
+ *                                                                   *
+ * The main codec functions are linked with -Wl,--wrap=<function>    *
+ * (GNU ld, see "make bench") so that every call goes through a      *
+ * probe below; the probes give the share of each function in the    *
+ * encoder and decoder time, less the probed functions it calls.     *
+ * With -a the bitstreams go through G729A_Decoder_Analyze instead   *
+ * of the full decoder. With -d the speech goes through              *
+ * G729A_Encoder_Process_Private_DTX, and the share of inactive      *
+ * frames and the bitrate are reported too.                          *
+ *                                                                   *
+ *    Usage : bench_codec [-r runs] [-p mode] [-a] [-d]              *
+ *                        [-j json_file] files...                    *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "g729a_typedef.h"
+#include "g729a_interface.h"
+#include "ld8a.h"
+#include "g729a_encoder.h"
+#include "g729a_decoder.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#else
+static unsigned long long bench_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+#endif
+
+static double bench_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#define FRAMESIZE       80
+#define SERIALSIZE      (80+2)
+#define FRAME_NS        10000000.0      /* 10 ms of speech per frame */
+#define ANALYZE_BLOCK   128             /* frames per G729A_Decoder_Analyze call (-a) */
+
+/*-------------------------------------------------------------------*
+ * Probes                                                            *
+ *-------------------------------------------------------------------*/
+
+enum
+{
+    PROBE_PRE_PROCESS = 0,
+    PROBE_AUTOCORR,
+    PROBE_LAG_WINDOW,
+    PROBE_LEVINSON,
+    PROBE_AZ_LSP,
+    PROBE_QUA_LSP,
+    PROBE_INT_QLPC,
+    PROBE_PITCH_OL_FAST,
+    PROBE_PITCH_FR3_FAST,
+    PROBE_ACELP_CODE_A,
+    PROBE_QUA_GAIN,
+    PROBE_VAD,
+    PROBE_COD_CNG,
+    PROBE_DECOD_LD8A,
+    PROBE_DECOD_LD8A_PARAMS,
+    PROBE_POST_FILTER,
+    PROBE_POST_PROCESS,
+    NB_PROBE
+};
+
+static const char *probe_name[NB_PROBE] =
+{
+    "g729_Pre_Process",
+    "g729_Autocorr",
+    "g729_Lag_window",
+    "g729_Levinson",
+    "g729_Az_lsp",
+    "g729_Qua_lsp",
+    "g729_Int_qlpc",
+    "g729_Pitch_ol_fast",
+    "g729_Pitch_fr3_fast",
+    "g729_ACELP_Code_A",
+    "g729_Qua_gain",
+    "g729_Vad",
+    "g729_Cod_cng",
+    "g729_Decod_ld8a",
+    "g729_Decod_ld8a_params",
+    "g729_Post_Filter",
+    "g729_Post_Process"
+};
+
+#define SIDE_ENC    0
+#define SIDE_DEC    1
+
+static int bench_side;                                  /* side being timed         */
+static unsigned long long probe_self[2][NB_PROBE];      /* ticks, without children  */
+static unsigned long long probe_calls[2][NB_PROBE];
+static unsigned long long probe_child;                  /* ticks of probed children */
+
+/* Runs the call and charges its time to probe id, minus the time of */
+/* the probed functions it calls itself (g729_Int_qlpc is called by  */
+/* g729_Decod_ld8a for instance).                                    */
+#define PROBE(id, call)                                             \
+    do {                                                            \
+        unsigned long long saved_ = probe_child, t_;                \
+        probe_child = 0;                                            \
+        t_ = bench_clock();                                         \
+        call;                                                       \
+        t_ = bench_clock() - t_;                                    \
+        probe_self[bench_side][id] += t_ - probe_child;             \
+        probe_calls[bench_side][id]++;                              \
+        probe_child = saved_ + t_;                                  \
+    } while (0)
+
+void __real_g729_Pre_Process(g729a_pre_process_state *state, G729_Word16 signal_in[], G729_Word16 signal_out[], G729_Word16 lg);
+void __real_g729_Autocorr(G729_Word16 x[], G729_Word16 m, G729_Word16 r_h[], G729_Word16 r_l[]);
+void __real_g729_Lag_window(G729_Word16 m, G729_Word16 r_h[], G729_Word16 r_l[]);
+void __real_g729_Levinson(G729_Word16 Rh[], G729_Word16 Rl[], G729_Word16 A[], G729_Word16 rc[], G729_Word16 old_A[], G729_Word16 old_rc[]);
+void __real_g729_Az_lsp(G729_Word16 a[], G729_Word16 lsp[], G729_Word16 old_lsp[]);
+void __real_g729_Qua_lsp(g729a_lspenc_state *state, G729_Word16 lsp[], G729_Word16 lsp_q[], G729_Word16 ana[]);
+void __real_g729_Int_qlpc(G729_Word16 lsp_old[], G729_Word16 lsp_new[], G729_Word16 Az[]);
+G729_Word16 __real_g729_Pitch_ol_fast(G729_Word16 signal[], G729_Word16 pit_max, G729_Word16 L_frame);
+G729_Word16 __real_g729_Pitch_fr3_fast(G729_Word16 exc[], G729_Word16 xn[], G729_Word16 h[], G729_Word16 L_subfr,
+                                       G729_Word16 t0_min, G729_Word16 t0_max, G729_Word16 i_subfr, G729_Word16 *pit_frac);
+G729_Word16 __real_g729_ACELP_Code_A(G729_Word16 x[], G729_Word16 h[], G729_Word16 T0, G729_Word16 pitch_sharp,
+                                     G729_Word16 code[], G729_Word16 y[], G729_Word16 *sign);
+G729_Word16 __real_g729_Qua_gain(g729a_encoder_state *state, G729_Word16 code[], G729_Word16 g_coeff[], G729_Word16 exp_coeff[],
+                                 G729_Word16 L_subfr, G729_Word16 *gain_pit, G729_Word16 *gain_cod, G729_Word16 tameflag);
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+G729_Word16 __real_g729_Vad(g729a_vad_state *state, G729_Word16 speech[], G729_Word16 lsp[]);
+G729_Word16 __real_g729_Cod_cng(g729a_encoder_state *state, G729_Word16 A[], G729_Word16 lsp_new[], G729_Word16 ana[]);
+#endif
+void __real_g729_Decod_ld8a(g729a_decoder_state *state, G729_Word16 parm[], G729_Word16 synth[], G729_Word16 A_t[],
+                            G729_Word16 *T2, G729_Word16 bad_lsf);
+void __real_g729_Decod_ld8a_params(g729a_decoder_state *state, G729_Word16 parm[], G729_Word16 lsp_new[], G729_Word16 T[],
+                                   G729_Word16 T_frac[], G729_Word16 gain_pit[], G729_Word16 gain_cod[], G729_Word16 ener[]);
+void __real_g729_Post_Filter(g729a_post_filter_state *state, G729_Word16 *syn, G729_Word16 *Az_4, G729_Word16 *T);
+void __real_g729_Post_Process(g729a_post_process_state *state, G729_Word16 signal_in[], G729_Word16 signal_out[], G729_Word16 lg);
+
+void __wrap_g729_Pre_Process(g729a_pre_process_state *state, G729_Word16 signal_in[], G729_Word16 signal_out[], G729_Word16 lg)
+{
+    PROBE(PROBE_PRE_PROCESS, __real_g729_Pre_Process(state, signal_in, signal_out, lg));
+}
+
+void __wrap_g729_Autocorr(G729_Word16 x[], G729_Word16 m, G729_Word16 r_h[], G729_Word16 r_l[])
+{
+    PROBE(PROBE_AUTOCORR, __real_g729_Autocorr(x, m, r_h, r_l));
+}
+
+void __wrap_g729_Lag_window(G729_Word16 m, G729_Word16 r_h[], G729_Word16 r_l[])
+{
+    PROBE(PROBE_LAG_WINDOW, __real_g729_Lag_window(m, r_h, r_l));
+}
+
+void __wrap_g729_Levinson(G729_Word16 Rh[], G729_Word16 Rl[], G729_Word16 A[], G729_Word16 rc[], G729_Word16 old_A[], G729_Word16 old_rc[])
+{
+    PROBE(PROBE_LEVINSON, __real_g729_Levinson(Rh, Rl, A, rc, old_A, old_rc));
+}
+
+void __wrap_g729_Az_lsp(G729_Word16 a[], G729_Word16 lsp[], G729_Word16 old_lsp[])
+{
+    PROBE(PROBE_AZ_LSP, __real_g729_Az_lsp(a, lsp, old_lsp));
+}
+
+void __wrap_g729_Qua_lsp(g729a_lspenc_state *state, G729_Word16 lsp[], G729_Word16 lsp_q[], G729_Word16 ana[])
+{
+    PROBE(PROBE_QUA_LSP, __real_g729_Qua_lsp(state, lsp, lsp_q, ana));
+}
+
+void __wrap_g729_Int_qlpc(G729_Word16 lsp_old[], G729_Word16 lsp_new[], G729_Word16 Az[])
+{
+    PROBE(PROBE_INT_QLPC, __real_g729_Int_qlpc(lsp_old, lsp_new, Az));
+}
+
+G729_Word16 __wrap_g729_Pitch_ol_fast(G729_Word16 signal[], G729_Word16 pit_max, G729_Word16 L_frame)
+{
+    G729_Word16 r;
+    PROBE(PROBE_PITCH_OL_FAST, r = __real_g729_Pitch_ol_fast(signal, pit_max, L_frame));
+    return r;
+}
+
+G729_Word16 __wrap_g729_Pitch_fr3_fast(G729_Word16 exc[], G729_Word16 xn[], G729_Word16 h[], G729_Word16 L_subfr,
+                                       G729_Word16 t0_min, G729_Word16 t0_max, G729_Word16 i_subfr, G729_Word16 *pit_frac)
+{
+    G729_Word16 r;
+    PROBE(PROBE_PITCH_FR3_FAST, r = __real_g729_Pitch_fr3_fast(exc, xn, h, L_subfr, t0_min, t0_max, i_subfr, pit_frac));
+    return r;
+}
+
+G729_Word16 __wrap_g729_ACELP_Code_A(G729_Word16 x[], G729_Word16 h[], G729_Word16 T0, G729_Word16 pitch_sharp,
+                                     G729_Word16 code[], G729_Word16 y[], G729_Word16 *sign)
+{
+    G729_Word16 r;
+    PROBE(PROBE_ACELP_CODE_A, r = __real_g729_ACELP_Code_A(x, h, T0, pitch_sharp, code, y, sign));
+    return r;
+}
+
+G729_Word16 __wrap_g729_Qua_gain(g729a_encoder_state *state, G729_Word16 code[], G729_Word16 g_coeff[], G729_Word16 exp_coeff[],
+                                 G729_Word16 L_subfr, G729_Word16 *gain_pit, G729_Word16 *gain_cod, G729_Word16 tameflag)
+{
+    G729_Word16 r;
+    PROBE(PROBE_QUA_GAIN, r = __real_g729_Qua_gain(state, code, g_coeff, exp_coeff, L_subfr, gain_pit, gain_cod, tameflag));
+    return r;
+}
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+G729_Word16 __wrap_g729_Vad(g729a_vad_state *state, G729_Word16 speech[], G729_Word16 lsp[])
+{
+    G729_Word16 r;
+    PROBE(PROBE_VAD, r = __real_g729_Vad(state, speech, lsp));
+    return r;
+}
+
+G729_Word16 __wrap_g729_Cod_cng(g729a_encoder_state *state, G729_Word16 A[], G729_Word16 lsp_new[], G729_Word16 ana[])
+{
+    G729_Word16 r;
+    PROBE(PROBE_COD_CNG, r = __real_g729_Cod_cng(state, A, lsp_new, ana));
+    return r;
+}
+#endif
+
+void __wrap_g729_Decod_ld8a(g729a_decoder_state *state, G729_Word16 parm[], G729_Word16 synth[], G729_Word16 A_t[],
+                            G729_Word16 *T2, G729_Word16 bad_lsf)
+{
+    PROBE(PROBE_DECOD_LD8A, __real_g729_Decod_ld8a(state, parm, synth, A_t, T2, bad_lsf));
+}
+
+void __wrap_g729_Decod_ld8a_params(g729a_decoder_state *state, G729_Word16 parm[], G729_Word16 lsp_new[], G729_Word16 T[],
+                                   G729_Word16 T_frac[], G729_Word16 gain_pit[], G729_Word16 gain_cod[], G729_Word16 ener[])
+{
+    PROBE(PROBE_DECOD_LD8A_PARAMS, __real_g729_Decod_ld8a_params(state, parm, lsp_new, T, T_frac, gain_pit, gain_cod, ener));
+}
+
+void __wrap_g729_Post_Filter(g729a_post_filter_state *state, G729_Word16 *syn, G729_Word16 *Az_4, G729_Word16 *T)
+{
+    PROBE(PROBE_POST_FILTER, __real_g729_Post_Filter(state, syn, Az_4, T));
+}
+
+void __wrap_g729_Post_Process(g729a_post_process_state *state, G729_Word16 signal_in[], G729_Word16 signal_out[], G729_Word16 lg)
+{
+    PROBE(PROBE_POST_PROCESS, __real_g729_Post_Process(state, signal_in, signal_out, lg));
+}
+
+/*-------------------------------------------------------------------*
+ * Corpus                                                            *
+ *-------------------------------------------------------------------*/
+
+typedef struct
+{
+    G729_Word16 *data;      /* nFrames * frame_size words */
+    G729_UWord8 *bits;      /* -a: nFrames * 10 bytes     */
+    G729_UWord8 *lost;      /* -a: frame loss bitmask     */
+    long nFrames;
+} bench_file;
+
+typedef struct
+{
+    bench_file *files;
+    int nFiles;
+    long nFrames;
+    double best_ns;         /* best run, whole corpus     */
+    double total_ns;        /* all runs                   */
+    unsigned long long total_ticks;
+} bench_corpus;
+
+static int is_bitstream(const char *name)
+{
+    size_t n = strlen(name);
+    return (n >= 4) && (name[n-4] == '.')
+        && ((name[n-3] | 0x20) == 'b') && ((name[n-2] | 0x20) == 'i') && ((name[n-1] | 0x20) == 't');
+}
+
+static int load_file(bench_corpus *c, const char *name, long frame_size)
+{
+    FILE *f;
+    long size;
+    bench_file *file;
+
+    if ((f = fopen(name, "rb")) == NULL)
+    {
+        printf("Error opening file  %s !!\n", name);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    c->files = realloc(c->files, sizeof(bench_file) * (c->nFiles + 1));
+    if (c->files == NULL)
+    {
+        fclose(f);
+        return -1;
+    }
+    file = &c->files[c->nFiles++];
+    file->bits = NULL;
+    file->lost = NULL;
+
+    file->nFrames = size / (long)(sizeof(G729_Word16) * frame_size);
+    file->data = malloc(sizeof(G729_Word16) * frame_size * (file->nFrames + 1));
+    if ((file->data == NULL)
+        || ((long)fread(file->data, sizeof(G729_Word16) * frame_size, file->nFrames, f) != file->nFrames))
+    {
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    c->nFrames += file->nFrames;
+    return 0;
+}
+
+/* Packs the ITU serial frames of a bitstream file the way the */
+/* encoder outputs them, for G729A_Decoder_Analyze.             */
+static int pack_file(bench_file *file)
+{
+    long k;
+    int i;
+    G729_Word16 *serial = file->data;
+
+    file->bits = calloc(10 * file->nFrames + 1, 1);
+    file->lost = calloc((file->nFrames >> 3) + 1, 1);
+    if ((file->bits == NULL) || (file->lost == NULL)) return -1;
+
+    for (k = 0; k < file->nFrames; k++, serial += SERIALSIZE)
+    {
+        for (i = 0; i < 80; i++)
+        {
+            if (serial[2+i] == 0)
+            {
+                file->lost[k >> 3] |= (G729_UWord8)(1 << (k & 7));
+            }
+            else if (serial[2+i] == BIT_1)
+            {
+                file->bits[10*k + (i >> 3)] |= (G729_UWord8)(0x80 >> (i & 7));
+            }
+        }
+    }
+    return 0;
+}
+
+static int bench_pst_mode = G729A_POSTFILTER_ON;   /* -p: decoder output */
+static int bench_analyze = 0;                      /* -a: parameters only */
+static int bench_dtx = 0;                          /* -d: encoder with DTX */
+static long dtx_inactive = 0;                      /* -d: SID or no frame  */
+static long dtx_bytes = 0;
+
+static void run_encoder(bench_corpus *c, void *state)
+{
+    int i;
+    long k;
+    G729_Word32 size;
+    G729_UWord8 serial[10];
+
+    for (i = 0; i < c->nFiles; i++)
+    {
+        G729_Word16 *speech = c->files[i].data;
+
+        G729A_Encoder_Init(state);
+        for (k = 0; k < c->files[i].nFrames; k++, speech += FRAMESIZE)
+        {
+            if (bench_dtx)
+            {
+                size = G729A_Encoder_Process_Private_DTX(state, speech, serial);
+                dtx_inactive += (size != G729A_SPEECH_FRAME_SIZE);
+                dtx_bytes += size;
+            }
+            else
+            {
+                G729A_Encoder_Process(state, speech, serial);
+            }
+        }
+    }
+}
+
+static void run_analysis(bench_corpus *c, void *state)
+{
+    int i;
+    long k;
+    G729_Word16 lsp[ANALYZE_BLOCK*10], T[ANALYZE_BLOCK*2], T_frac[ANALYZE_BLOCK*2];
+    G729_Word16 gain_pit[ANALYZE_BLOCK*2], gain_cod[ANALYZE_BLOCK*2], ener[ANALYZE_BLOCK*2];
+    G729A_Params params = { lsp, T, T_frac, gain_pit, gain_cod, ener };
+
+    for (i = 0; i < c->nFiles; i++)
+    {
+        bench_file *file = &c->files[i];
+
+        G729A_Decoder_Init(state);
+        for (k = 0; k < file->nFrames; k += ANALYZE_BLOCK)
+        {
+            long n = file->nFrames - k;
+            if (n > ANALYZE_BLOCK) n = ANALYZE_BLOCK;
+            G729A_Decoder_Analyze(state, &file->bits[10*k], n, &file->lost[k >> 3], &params);
+        }
+    }
+}
+
+static void run_decoder(bench_corpus *c, void *state)
+{
+    int i;
+    long k;
+    G729_Word16 synth[FRAMESIZE];
+
+    for (i = 0; i < c->nFiles; i++)
+    {
+        G729_Word16 *serial = c->files[i].data;
+
+        G729A_Decoder_Init(state);
+        G729A_Decoder_Set_Postfilter(state, bench_pst_mode);
+        for (k = 0; k < c->files[i].nFrames; k++, serial += SERIALSIZE)
+        {
+            G729A_Decoder_Process_Testing(state, serial, synth);
+        }
+    }
+}
+
+static void time_corpus(bench_corpus *c, int side, void *state, int runs)
+{
+    int r;
+    double t;
+    unsigned long long ticks;
+
+    bench_side = side;
+    for (r = 0; r < runs; r++)
+    {
+        ticks = bench_clock();
+        t = bench_ns();
+        if (side == SIDE_ENC)
+        {
+            run_encoder(c, state);
+        }
+        else if (bench_analyze)
+        {
+            run_analysis(c, state);
+        }
+        else
+        {
+            run_decoder(c, state);
+        }
+        t = bench_ns() - t;
+        c->total_ticks += bench_clock() - ticks;
+
+        c->total_ns += t;
+        if ((r == 0) || (t < c->best_ns))
+        {
+            c->best_ns = t;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*
+ * Report                                                            *
+ *-------------------------------------------------------------------*/
+
+static double ns_per_frame(const bench_corpus *c)
+{
+    return (c->nFrames > 0) ? c->best_ns / c->nFrames : 0.0;
+}
+
+static void print_side(const char *title, const bench_corpus *c, int side, int runs)
+{
+    int i;
+    double share, other = 1.0;
+    double nspf = ns_per_frame(c);
+
+    if (c->nFrames == 0)
+    {
+        return;
+    }
+
+    printf("%s : %d files, %ld frames, best of %d runs\n", title, c->nFiles, c->nFrames, runs);
+    printf("  %-22s %10.0f\n", "ns/frame", nspf);
+    printf("  %-22s %10.1f\n", "channels per core", FRAME_NS / nspf);
+    printf("  %-22s %10s %10s %8s\n", "function", "calls/frm", "ns/frame", "share");
+    for (i = 0; i < NB_PROBE; i++)
+    {
+        if (probe_calls[side][i] == 0)
+        {
+            continue;
+        }
+        share = (double)probe_self[side][i] / (double)c->total_ticks;
+        other -= share;
+        printf("  %-22s %10.2f %10.0f %7.1f%%\n", probe_name[i],
+               (double)probe_calls[side][i] / ((double)c->nFrames * runs), share * nspf, share * 100.0);
+    }
+    printf("  %-22s %10s %10.0f %7.1f%%\n", "other", "", other * nspf, other * 100.0);
+    printf("\n");
+}
+
+static void json_side(FILE *f, const char *title, const bench_corpus *c, int side, int runs)
+{
+    int i;
+    double share, other = 1.0;
+    double nspf = ns_per_frame(c);
+
+    fprintf(f, "  \"%s\": {\n", title);
+    fprintf(f, "    \"files\": %d,\n", c->nFiles);
+    fprintf(f, "    \"frames\": %ld,\n", c->nFrames);
+    fprintf(f, "    \"ns_per_frame\": %.1f,\n", nspf);
+    fprintf(f, "    \"channels_per_core\": %.1f,\n", (nspf > 0.0) ? FRAME_NS / nspf : 0.0);
+    fprintf(f, "    \"functions\": [");
+    for (i = 0; (c->nFrames > 0) && (i < NB_PROBE); i++)
+    {
+        if (probe_calls[side][i] == 0)
+        {
+            continue;
+        }
+        share = (double)probe_self[side][i] / (double)c->total_ticks;
+        other -= share;
+        fprintf(f, "\n      { \"name\": \"%s\", \"calls_per_frame\": %.2f, \"ns_per_frame\": %.1f, \"share\": %.4f },",
+                probe_name[i], (double)probe_calls[side][i] / ((double)c->nFrames * runs), share * nspf, share);
+    }
+    if (c->nFrames > 0)
+    {
+        fprintf(f, "\n      { \"name\": \"other\", \"calls_per_frame\": 0, \"ns_per_frame\": %.1f, \"share\": %.4f }\n    ",
+                other * nspf, other);
+    }
+    fprintf(f, "]\n  }");
+}
+
+static int write_json(const char *name, const bench_corpus *enc, const bench_corpus *dec, int runs)
+{
+    FILE *f;
+    double duplex = ns_per_frame(enc) + ns_per_frame(dec);
+
+    if ((f = fopen(name, "w")) == NULL)
+    {
+        printf("Error opening file  %s !!\n", name);
+        return -1;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"version\": \"%s\",\n", G729A_Get_Version());
+    fprintf(f, "  \"runs\": %d,\n", runs);
+    json_side(f, "encoder", enc, SIDE_ENC, runs);
+    fprintf(f, ",\n");
+    json_side(f, "decoder", dec, SIDE_DEC, runs);
+    fprintf(f, ",\n");
+    fprintf(f, "  \"duplex_channels_per_core\": %.1f\n", (duplex > 0.0) ? FRAME_NS / duplex : 0.0);
+    fprintf(f, "}\n");
+
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, runs = 5;
+    const char *json = NULL;
+    bench_corpus enc, dec;
+    void *enc_state, *dec_state;
+
+    memset(&enc, 0, sizeof(enc));
+    memset(&dec, 0, sizeof(dec));
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            runs = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc))
+        {
+            bench_pst_mode = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-a") == 0)
+        {
+            bench_analyze = 1;
+        }
+        else if (strcmp(argv[i], "-d") == 0)
+        {
+            bench_dtx = 1;
+        }
+        else if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc))
+        {
+            json = argv[++i];
+        }
+        else if (is_bitstream(argv[i]))
+        {
+            if (load_file(&dec, argv[i], SERIALSIZE) != 0) return 1;
+        }
+        else
+        {
+            if (load_file(&enc, argv[i], FRAMESIZE) != 0) return 1;
+        }
+    }
+
+    if ((runs <= 0) || (enc.nFiles + dec.nFiles == 0))
+    {
+        printf("Usage : bench_codec [-r runs] [-p mode] [-a] [-d] [-j json_file] files...\n");
+        printf("\n");
+        printf("  -p mode : decoder output, 0 postfilter (default), 1 high-pass only, 2 raw\n");
+        printf("  -a      : decoder only extracts the parameters (G729A_Decoder_Analyze)\n");
+        printf("  -d      : encoder with the private VAD and DTX (G729A_Encoder_Process_Private_DTX)\n");
+        printf("  *.BIT files are ITU serial bitstreams (82 words per frame) given to the decoder,\n");
+        printf("  any other file is 16 bits PCM speech given to the encoder.\n");
+        printf("\n");
+        return 1;
+    }
+
+    enc_state = malloc(G729A_Encoder_Get_Size());
+    dec_state = malloc(G729A_Decoder_Get_Size());
+    if ((enc_state == NULL) || (dec_state == NULL)) return 1;
+    if (bench_dtx && (enc.nFiles > 0))
+    {
+        G729_UWord8 serial[10];
+
+        /* returns -1 unless the library is built with PRIVATE_DTX=1 */
+        G729A_Encoder_Init(enc_state);
+        if (G729A_Encoder_Process_Private_DTX(enc_state, enc.files[0].data, serial) < 0)
+        {
+            printf("Error: -d needs a library built with make PRIVATE_DTX=1 !!\n");
+            return 1;
+        }
+    }
+    for (i = 0; bench_analyze && (i < dec.nFiles); i++)
+    {
+        if (pack_file(&dec.files[i]) != 0) return 1;
+    }
+
+    time_corpus(&enc, SIDE_ENC, enc_state, runs);
+    time_corpus(&dec, SIDE_DEC, dec_state, runs);
+
+    print_side("Encoder", &enc, SIDE_ENC, runs);
+    if (bench_dtx && (enc.nFrames > 0))
+    {
+        printf("DTX : %.1f%% inactive frames, %.2f kbit/s\n\n", 100.0 * dtx_inactive / ((double)enc.nFrames * runs),
+               8.0 * dtx_bytes / ((double)enc.nFrames * runs) / (FRAME_NS / 1e6));
+    }
+    print_side("Decoder", &dec, SIDE_DEC, runs);
+    if ((enc.nFrames > 0) && (dec.nFrames > 0))
+    {
+        printf("Encoder + decoder : %.1f channels per core\n\n", FRAME_NS / (ns_per_frame(&enc) + ns_per_frame(&dec)));
+    }
+
+    if ((json != NULL) && (write_json(json, &enc, &dec, runs) != 0))
+    {
+        return 1;
+    }
+
+    free(enc_state);
+    free(dec_state);
+    for (i = 0; i < enc.nFiles; i++) free(enc.files[i].data);
+    for (i = 0; i < dec.nFiles; i++)
+    {
+        free(dec.files[i].data);
+        free(dec.files[i].bits);
+        free(dec.files[i].lost);
+    }
+    free(enc.files);
+    free(dec.files);
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Micro-benchmark of the correlation matrix builder of the fixed    *
+ * codebook search: g729_Cor_h() against the ITU loops of            *
+ * g729_Cor_h_ref(), in cycles (x86) or nanoseconds per subframe.    *
+ * Both outputs are compared on every impulse response.              *
+ *                                                                   *
+ *    Usage : bench_cor_h [subframes] [runs]                         *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#else
+#include <time.h>
+#define BENCH_UNIT  "ns"
+static unsigned long long bench_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+#endif
+
+typedef void (*Cor_h_func)(G729_Word16 *H, G729_Word16 *rr);
+
+/* Decaying Q12 impulse responses like the weighted synthesis filter */
+/* gives, one in 16 at full scale to exercise the saturating path.   */
+static void make_h(G729_Word16 *h, int n_sub)
+{
+    int s, i, amp;
+
+    srand(1);
+    for (s = 0; s < n_sub; s++, h += L_SUBFR)
+    {
+        amp = ((s & 15) == 15) ? 32767 : 4096;
+        h[0] = (G729_Word16)amp;
+        for (i = 1; i < L_SUBFR; i++)
+        {
+            amp = amp * 15 / 16;
+            h[i] = (G729_Word16)((rand() % (2 * amp + 1)) - amp);
+        }
+    }
+}
+
+static double run(Cor_h_func f, G729_Word16 *h, G729_Word16 *rr, int n_sub, int runs)
+{
+    int r, s;
+    unsigned long long t, best = 0;
+
+    for (r = 0; r < runs; r++)
+    {
+        t = bench_clock();
+        for (s = 0; s < n_sub; s++)
+        {
+            f(&h[s * L_SUBFR], &rr[s * DIM_RR]);
+        }
+        t = bench_clock() - t;
+        if ((r == 0) || (t < best))
+        {
+            best = t;
+        }
+    }
+
+    return (double)best / n_sub;
+}
+
+int main(int argc, char *argv[])
+{
+    int n_sub = (argc > 1) ? atoi(argv[1]) : 1000;
+    int runs = (argc > 2) ? atoi(argv[2]) : 50;
+    G729_Word16 *h, *rr_ref, *rr;
+    double t_ref, t_fast;
+
+    if ((n_sub <= 0) || (runs <= 0))
+    {
+        printf("Usage : bench_cor_h [subframes] [runs]\n");
+        return 1;
+    }
+
+    h = malloc(sizeof(G729_Word16) * L_SUBFR * n_sub);
+    rr_ref = malloc(sizeof(G729_Word16) * DIM_RR * n_sub);
+    rr = malloc(sizeof(G729_Word16) * DIM_RR * n_sub);
+    if ((h == NULL) || (rr_ref == NULL) || (rr == NULL))
+    {
+        return 1;
+    }
+
+    make_h(h, n_sub);
+
+    t_ref = run(g729_Cor_h_ref, h, rr_ref, n_sub, runs);
+    t_fast = run(g729_Cor_h, h, rr, n_sub, runs);
+
+    if (memcmp(rr_ref, rr, sizeof(G729_Word16) * DIM_RR * n_sub) != 0)
+    {
+        printf("g729_Cor_h() and g729_Cor_h_ref() differ\n");
+        return 1;
+    }
+
+    printf("Cor_h  %d subframes, best of %d runs, %s per subframe\n", n_sub, runs, BENCH_UNIT);
+    printf("  g729_Cor_h_ref : %8.0f\n", t_ref);
+    printf("  g729_Cor_h     : %8.0f\n", t_fast);
+    printf("  speedup        : %8.2f\n", t_ref / t_fast);
+
+    free(h);
+    free(rr_ref);
+    free(rr);
+
+    return 0;
+}
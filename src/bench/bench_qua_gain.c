@@ -0,0 +1,224 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Micro-benchmark of the gain quantizer: g729_Qua_gain() against    *
+ * the ITU codebook search loop of g729_Qua_gain_ref(), in cycles    *
+ * (x86) or nanoseconds per call. The inputs of every call are       *
+ * recorded while the encoder runs on a speech file (g729_Qua_gain   *
+ * is linked with -Wl,--wrap, see "make bench_qua_gain"), by default *
+ * test_vectors/IN/SPEECH.IN, then replayed; both outputs are        *
+ * compared on every call.                                           *
+ *                                                                   *
+ *    Usage : bench_qua_gain [speech file] [runs]                    *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g729a_typedef.h"
+#include "ld8a.h"
+#include "g729a_encoder.h"
+#include "g729a_interface.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT  "cycles"
+static unsigned long long bench_clock(void) { return __rdtsc(); }
+#else
+#include <time.h>
+#define BENCH_UNIT  "ns"
+static unsigned long long bench_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+#endif
+
+typedef G729_Word16 (*Qua_gain_func)(g729a_encoder_state *state, G729_Word16 code[], G729_Word16 g_coeff[],
+                                     G729_Word16 exp_coeff[], G729_Word16 L_subfr, G729_Word16 *gain_pit,
+                                     G729_Word16 *gain_cod, G729_Word16 tameflag);
+
+typedef struct
+{
+    G729_Word16 past_qua_en[4];
+    G729_Word16 code[L_SUBFR];
+    G729_Word16 g_coeff[5];
+    G729_Word16 exp_coeff[5];
+    G729_Word16 tameflag;
+} gain_call;
+
+typedef struct
+{
+    G729_Word16 index;
+    G729_Word16 gain_pit;
+    G729_Word16 gain_cod;
+    G729_Word16 past_qua_en[4];
+} gain_result;
+
+static gain_call *calls;
+static int n_call, cap_call;
+
+G729_Word16 __real_g729_Qua_gain(g729a_encoder_state *state, G729_Word16 code[], G729_Word16 g_coeff[],
+                                 G729_Word16 exp_coeff[], G729_Word16 L_subfr, G729_Word16 *gain_pit,
+                                 G729_Word16 *gain_cod, G729_Word16 tameflag);
+
+/* Records the inputs of the calls made by the encoder */
+G729_Word16 __wrap_g729_Qua_gain(g729a_encoder_state *state, G729_Word16 code[], G729_Word16 g_coeff[],
+                                 G729_Word16 exp_coeff[], G729_Word16 L_subfr, G729_Word16 *gain_pit,
+                                 G729_Word16 *gain_cod, G729_Word16 tameflag)
+{
+    gain_call *c;
+
+    if (n_call == cap_call)
+    {
+        cap_call = (cap_call == 0) ? 4096 : cap_call * 2;
+        calls = realloc(calls, sizeof(gain_call) * cap_call);
+    }
+    if ((calls != NULL) && (L_subfr == L_SUBFR))
+    {
+        c = &calls[n_call++];
+        memcpy(c->past_qua_en, state->past_qua_en, sizeof(c->past_qua_en));
+        memcpy(c->code, code, sizeof(c->code));
+        memcpy(c->g_coeff, g_coeff, sizeof(c->g_coeff));
+        memcpy(c->exp_coeff, exp_coeff, sizeof(c->exp_coeff));
+        c->tameflag = tameflag;
+    }
+
+    return __real_g729_Qua_gain(state, code, g_coeff, exp_coeff, L_subfr, gain_pit, gain_cod, tameflag);
+}
+
+static int record_calls(const char *path)
+{
+    FILE *f;
+    g729a_encoder_state *state;
+    G729_Word16 speech[L_FRAME];
+    G729_UWord8 bits[L_FRAME / 8];
+
+    if ((f = fopen(path, "rb")) == NULL)
+    {
+        return -1;
+    }
+
+    state = malloc(G729A_Encoder_Get_Size());
+    if ((state == NULL) || (G729A_Encoder_Init(state) != 0))
+    {
+        fclose(f);
+        return -1;
+    }
+
+    while (fread(speech, sizeof(G729_Word16), L_FRAME, f) == L_FRAME)
+    {
+        G729A_Encoder_Process(state, speech, bits);
+    }
+
+    fclose(f);
+    free(state);
+
+    return (calls != NULL) ? n_call : -1;
+}
+
+static double run(Qua_gain_func f, g729a_encoder_state *state, gain_result *res, int runs)
+{
+    int r, s;
+    unsigned long long t, best = 0;
+    gain_call *c;
+
+    for (r = 0; r < runs; r++)
+    {
+        t = bench_clock();
+        for (s = 0, c = calls; s < n_call; s++, c++)
+        {
+            memcpy(state->past_qua_en, c->past_qua_en, sizeof(c->past_qua_en));
+            res[s].index = f(state, c->code, c->g_coeff, c->exp_coeff, L_SUBFR,
+                             &res[s].gain_pit, &res[s].gain_cod, c->tameflag);
+            memcpy(res[s].past_qua_en, state->past_qua_en, sizeof(c->past_qua_en));
+        }
+        t = bench_clock() - t;
+        if ((r == 0) || (t < best))
+        {
+            best = t;
+        }
+    }
+
+    return (double)best / n_call;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "../test_vectors/IN/SPEECH.IN";
+    int runs = (argc > 2) ? atoi(argv[2]) : 20;
+    g729a_encoder_state *state;
+    gain_result *res_ref, *res;
+    double t_ref, t_fast;
+
+    if (runs <= 0)
+    {
+        printf("Usage : bench_qua_gain [speech file] [runs]\n");
+        return 1;
+    }
+
+    if (record_calls(path) <= 0)
+    {
+        printf("Cannot read frames from %s\n", path);
+        return 1;
+    }
+
+    state = malloc(G729A_Encoder_Get_Size());
+    res_ref = malloc(sizeof(gain_result) * n_call);
+    res = malloc(sizeof(gain_result) * n_call);
+    if ((state == NULL) || (res_ref == NULL) || (res == NULL) || (G729A_Encoder_Init(state) != 0))
+    {
+        return 1;
+    }
+
+    t_ref = run(g729_Qua_gain_ref, state, res_ref, runs);
+    t_fast = run(__real_g729_Qua_gain, state, res, runs);
+
+    if (memcmp(res_ref, res, sizeof(gain_result) * n_call) != 0)
+    {
+        printf("g729_Qua_gain() and g729_Qua_gain_ref() differ\n");
+        return 1;
+    }
+
+    printf("Qua_gain  %d calls of %s, best of %d runs, %s per call\n", n_call, path, runs, BENCH_UNIT);
+    printf("  g729_Qua_gain_ref : %8.0f\n", t_ref);
+    printf("  g729_Qua_gain     : %8.0f\n", t_fast);
+    printf("  speedup           : %8.2f\n", t_ref / t_fast);
+
+    free(calls);
+    free(state);
+    free(res_ref);
+    free(res);
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Multi-threaded stress test of the G.729A encoder and decoder.     *
+ *                                                                   *
+ * The files are loaded in memory and run once on the main thread   *
+ * to get the reference outputs:                                     *
+ *  - every *.IN file (16 bits PCM) is encoded frame by frame in the *
+ *    ITU serial format (G729A_Encoder_Process_Testing) and in the   *
+ *    compressed format (G729A_Encoder_Process_Frames), and the      *
+ *    compressed bitstream is decoded (G729A_Decoder_Process_Frames),*
+ *  - every *.BIT file (ITU serial bitstream) is decoded frame by    *
+ *    frame (G729A_Decoder_Process_Testing).                         *
+ * Then threads threads, each with its own encoder and decoder      *
+ * state, run the same work rounds times at the same time, every     *
+ * thread starting at a different file, and every output is compared *
+ * bit-exactly with the reference. A state shared by mistake between *
+ * two channels, or any other hidden global state, shows up as a     *
+ * mismatch; the exit status is 1 on any mismatch.                   *
+ *                                                                   *
+ *    Usage : stress_threads [-t threads] [-r rounds] files...       *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "g729a_typedef.h"
+#include "g729a_interface.h"
+
+#define FRAMESIZE       80
+#define SERIALSIZE      (80+2)
+#define BLOCKFRAMES     50      /* frames per G729A_xxx_Process_Frames call */
+
+typedef struct
+{
+    const char  *name;
+    int          bitstream;     /* 1: *.BIT file given to the decoder   */
+    long         nFrames;
+    G729_Word16 *data;          /* nFrames * (80 or 82) words          */
+    G729_Word16 *ref_serial;    /* *.IN: ITU serial bitstream           */
+    G729_UWord8 *ref_bits;      /* *.IN: compressed bitstream           */
+    G729_Word16 *ref_speech;    /* decoded speech                       */
+} stress_file;
+
+typedef struct
+{
+    pthread_t    thread;
+    int          id;
+    int          rounds;
+    long         frames;        /* frames processed                     */
+    long         errors;        /* mismatching outputs                  */
+} stress_job;
+
+static stress_file *stress_files = NULL;
+static int stress_nFiles = 0;
+
+static int is_bitstream(const char *name)
+{
+    size_t n = strlen(name);
+    return (n >= 4) && (name[n-4] == '.')
+        && ((name[n-3] | 0x20) == 'b') && ((name[n-2] | 0x20) == 'i') && ((name[n-1] | 0x20) == 't');
+}
+
+static int load_file(const char *name)
+{
+    FILE *f;
+    long size, frame_size;
+    stress_file *file;
+
+    if ((f = fopen(name, "rb")) == NULL)
+    {
+        printf("Error opening file  %s !!\n", name);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    stress_files = realloc(stress_files, sizeof(stress_file) * (stress_nFiles + 1));
+    if (stress_files == NULL)
+    {
+        fclose(f);
+        return -1;
+    }
+    file = &stress_files[stress_nFiles++];
+    memset(file, 0, sizeof(stress_file));
+    file->name = name;
+    file->bitstream = is_bitstream(name);
+
+    frame_size = file->bitstream ? SERIALSIZE : FRAMESIZE;
+    file->nFrames = size / (long)(sizeof(G729_Word16) * frame_size);
+    file->data = malloc(sizeof(G729_Word16) * frame_size * (file->nFrames + 1));
+    if ((file->data == NULL)
+        || ((long)fread(file->data, sizeof(G729_Word16) * frame_size, file->nFrames, f) != file->nFrames))
+    {
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+/*-------------------------------------------------------------------*
+ * Runs every path of one file with the given states, writing to the *
+ * given buffers; returns -1 if a call fails.                        *
+ *-------------------------------------------------------------------*/
+
+static int run_file(const stress_file *file, void *enc_state, void *dec_state,
+                    G729_Word16 *serial, G729_UWord8 *bits, G729_Word16 *speech)
+{
+    long k, n;
+
+    if (file->bitstream)
+    {
+        if (G729A_Decoder_Init(dec_state) != 0) return -1;
+        for (k = 0; k < file->nFrames; k++)
+        {
+            if (G729A_Decoder_Process_Testing(dec_state, &file->data[k * SERIALSIZE], &speech[k * FRAMESIZE]) != 0) return -1;
+        }
+        return 0;
+    }
+
+    if (G729A_Encoder_Init(enc_state) != 0) return -1;
+    for (k = 0; k < file->nFrames; k++)
+    {
+        if (G729A_Encoder_Process_Testing(enc_state, &file->data[k * FRAMESIZE], &serial[k * SERIALSIZE]) != 0) return -1;
+    }
+
+    if ((G729A_Encoder_Init(enc_state) != 0) || (G729A_Decoder_Init(dec_state) != 0)) return -1;
+    for (k = 0; k < file->nFrames; k += n)
+    {
+        n = file->nFrames - k;
+        if (n > BLOCKFRAMES) n = BLOCKFRAMES;
+        if (G729A_Encoder_Process_Frames(enc_state, &file->data[k * FRAMESIZE], (G729_Word32)n, &bits[k * 10]) != 0) return -1;
+        if (G729A_Decoder_Process_Frames(dec_state, &bits[k * 10], (G729_Word32)n, NULL, &speech[k * FRAMESIZE]) != 0) return -1;
+    }
+    return 0;
+}
+
+static void *stress_thread(void *arg)
+{
+    stress_job *job = (stress_job *)arg;
+    void *enc_state = malloc(G729A_Encoder_Get_Size());
+    void *dec_state = malloc(G729A_Decoder_Get_Size());
+    G729_Word16 *serial = NULL, *speech = NULL;
+    G729_UWord8 *bits = NULL;
+    long maxFrames = 0;
+    int r, i;
+
+    for (i = 0; i < stress_nFiles; i++)
+    {
+        if (stress_files[i].nFrames > maxFrames) maxFrames = stress_files[i].nFrames;
+    }
+    serial = malloc(sizeof(G729_Word16) * SERIALSIZE * (maxFrames + 1));
+    speech = malloc(sizeof(G729_Word16) * FRAMESIZE * (maxFrames + 1));
+    bits   = malloc(10 * (maxFrames + 1));
+
+    if ((enc_state == NULL) || (dec_state == NULL) || (serial == NULL) || (speech == NULL) || (bits == NULL))
+    {
+        job->errors++;
+    }
+    else for (r = 0; r < job->rounds; r++)
+    {
+        for (i = 0; i < stress_nFiles; i++)
+        {
+            const stress_file *file = &stress_files[(i + job->id) % stress_nFiles];
+            long n = file->nFrames;
+
+            if (run_file(file, enc_state, dec_state, serial, bits, speech) != 0)
+            {
+                printf("thread %d round %d: %s failed\n", job->id, r, file->name);
+                job->errors++;
+                continue;
+            }
+            if ((!file->bitstream)
+                && ((memcmp(serial, file->ref_serial, sizeof(G729_Word16) * SERIALSIZE * n) != 0)
+                    || (memcmp(bits, file->ref_bits, 10 * n) != 0)))
+            {
+                printf("thread %d round %d: %s bitstream differs\n", job->id, r, file->name);
+                job->errors++;
+            }
+            if (memcmp(speech, file->ref_speech, sizeof(G729_Word16) * FRAMESIZE * n) != 0)
+            {
+                printf("thread %d round %d: %s speech differs\n", job->id, r, file->name);
+                job->errors++;
+            }
+            job->frames += n;
+        }
+    }
+
+    free(enc_state);
+    free(dec_state);
+    free(serial);
+    free(speech);
+    free(bits);
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    int i, nThreads = 8, rounds = 4;
+    long frames = 0, errors = 0;
+    void *enc_state, *dec_state;
+    stress_job *jobs;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+        {
+            nThreads = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            rounds = atoi(argv[++i]);
+        }
+        else
+        {
+            if (load_file(argv[i]) != 0) return 1;
+        }
+    }
+
+    if ((nThreads <= 0) || (rounds <= 0) || (stress_nFiles == 0))
+    {
+        printf("Usage : stress_threads [-t threads] [-r rounds] files...\n");
+        printf("\n");
+        printf("  -t threads : threads running at the same time (default 8)\n");
+        printf("  -r rounds  : passes of each thread over the files (default 4)\n");
+        printf("  *.BIT files are ITU serial bitstreams (82 words per frame) given to the decoder,\n");
+        printf("  any other file is 16 bits PCM speech given to the encoder and back to the decoder.\n");
+        printf("\n");
+        return 1;
+    }
+
+    /* Single thread reference */
+
+    enc_state = malloc(G729A_Encoder_Get_Size());
+    dec_state = malloc(G729A_Decoder_Get_Size());
+    if ((enc_state == NULL) || (dec_state == NULL)) return 1;
+
+    for (i = 0; i < stress_nFiles; i++)
+    {
+        stress_file *file = &stress_files[i];
+
+        file->ref_serial = malloc(sizeof(G729_Word16) * SERIALSIZE * (file->nFrames + 1));
+        file->ref_bits   = malloc(10 * (file->nFrames + 1));
+        file->ref_speech = malloc(sizeof(G729_Word16) * FRAMESIZE * (file->nFrames + 1));
+        if ((file->ref_serial == NULL) || (file->ref_bits == NULL) || (file->ref_speech == NULL)
+            || (run_file(file, enc_state, dec_state, file->ref_serial, file->ref_bits, file->ref_speech) != 0))
+        {
+            printf("Error processing file  %s !!\n", file->name);
+            return 1;
+        }
+    }
+    free(enc_state);
+    free(dec_state);
+
+    /* Concurrent runs */
+
+    jobs = calloc(nThreads, sizeof(stress_job));
+    if (jobs == NULL) return 1;
+
+    for (i = 0; i < nThreads; i++)
+    {
+        jobs[i].id = i;
+        jobs[i].rounds = rounds;
+        if (pthread_create(&jobs[i].thread, NULL, stress_thread, &jobs[i]) != 0)
+        {
+            printf("Error creating thread %d !!\n", i);
+            return 1;
+        }
+    }
+    for (i = 0; i < nThreads; i++)
+    {
+        pthread_join(jobs[i].thread, NULL);
+        frames += jobs[i].frames;
+        errors += jobs[i].errors;
+    }
+    free(jobs);
+
+    printf("%d threads x %d rounds, %d files, %ld frames: %s (%ld mismatches)\n",
+           nThreads, rounds, stress_nFiles, frames, (errors == 0) ? "OK" : "FAILED", errors);
+
+    return (errors == 0) ? 0 : 1;
+}
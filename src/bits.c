@@ -61,6 +61,8 @@
 /*****************************************************************************/
 /* bit stream manipulation routines                                          */
 /*****************************************************************************/
+#include <string.h>
+
 #include "g729a_typedef.h"
 #include "ld8a.h"
 #include "tab_ld8a.h"
@@ -197,18 +199,57 @@ void g729_prm2bits_ld8k_compressed(
     flush_put_bits(&pb);
 }
 
+/*----------------------------------------------------------------------------
+ * The bit reader loads 32 bits at a time past the byte it reads from, so the
+ * frame is copied into a padded buffer first: bits[] may be the last 10 bytes
+ * of a caller's buffer or of a mapped file.
+ *----------------------------------------------------------------------------
+ */
+#define BITS_PADDING    8
+
 void g729_bits2prm_ld8k_compressed(
-    G729_UWord8  bits[],            /* input : serial bits (80)                       */
+    G729_UWord8  bits[],            /* input : packed frame (BITSTREAM_SIZE bytes)    */
     G729_Word16  prm[]              /* output: decoded parameters (11 parameters)     */
 )
 {
     GetBitContext gb;
+    G729_UWord8 frame[BITSTREAM_SIZE + BITS_PADDING];
     int i;
 
-    init_get_bits(&gb, bits, 10 /*buf_size*/);
+    memcpy(frame, bits, BITSTREAM_SIZE);
+    memset(&frame[BITSTREAM_SIZE], 0, BITS_PADDING);
+
+    init_get_bits(&gb, frame, 10 /*buf_size*/);
 
     for (i = 0; i < PRM_SIZE; ++i)
     {
         prm[i] = get_bits(&gb, g729_bitsno[i]);
     }
 }
+
+/*----------------------------------------------------------------------------
+ * Private SID frames (24 bits, not the 15-bit SID of G.729 Annex B): 8 bits
+ * of LSP first stage (with MA switch), 10 bits of LSP second stage, 6 bits
+ * of energy. Packed by hand, the bit readers above load 32 bits at a time
+ * past the end of a 3-byte frame.
+ *----------------------------------------------------------------------------
+ */
+void g729_prm2bits_sid(
+    G729_Word16 prm[],            /* input : SID parameters  (SID_PRM_SIZE parameters) */
+    G729_UWord8 bits[]            /* output: packed SID frame (SID_SIZE bytes)        */
+)
+{
+    bits[0] = (G729_UWord8)prm[0];
+    bits[1] = (G729_UWord8)(prm[1] >> 2);
+    bits[2] = (G729_UWord8)(((prm[1] & 0x03) << 6) | (prm[2] & 0x3f));
+}
+
+void g729_bits2prm_sid(
+    G729_UWord8  bits[],            /* input : packed SID frame (SID_SIZE bytes)      */
+    G729_Word16  prm[]              /* output: SID parameters (3 parameters)          */
+)
+{
+    prm[0] = bits[0];
+    prm[1] = (G729_Word16)((bits[1] << 2) | (bits[2] >> 6));
+    prm[2] = bits[2] & 0x3f;
+}
@@ -0,0 +1,81 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Excitation of the comfort noise. The encoder runs it on every     *
+ * inactive frame with the same seed and gains as the decoder, so    *
+ * that the adaptive codebook memory of both stays the same.         *
+ *                                                                   *
+ * The noise is the sum of 4 uniform values of g729_Random() >> 3,   *
+ * of rms about 4730. The gain moves 1/8 of the way to the gain of   *
+ * the last SID every subframe.                                      *
+ *                                                                   *
+ * The loop runs on plain integers: none of the operations of        *
+ * g729_Random(), of the sum or of g729_mult_r() can saturate here,  *
+ * so that they give the same values as the basic operators.         *
+ *-------------------------------------------------------------------*/
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+void g729_Calc_exc_rand(
+    G729_Word16 *cur_gain, /* (i/o) Q15 : smoothed noise gain                */
+    G729_Word16 sid_gain,  /* (i)   Q15 : noise gain of the last SID         */
+    G729_Word16 exc[],     /* (o)       : excitation of the frame (L_FRAME)  */
+    G729_Word16 *seed      /* (i/o)     : generator state                    */
+)
+{
+    G729_Word16 i, k, i_subfr;
+    G729_Word32 noise, gain, rnd;
+    
+    rnd = *seed;
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        /* cur_gain = 7/8 cur_gain + 1/8 sid_gain */
+        
+        *cur_gain = g729_add(g729_mult_r(*cur_gain, 28672), g729_mult_r(sid_gain, 4096));
+        gain = *cur_gain;
+        
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            noise = 0;
+            for (k = 0; k < 4; k++)
+            {
+                rnd = (G729_Word16)(rnd * 31821 + 13849);       /* g729_Random() */
+                noise += rnd >> 3;
+            }
+            exc[i_subfr + i] = (G729_Word16)((noise * gain + 0x4000) >> 15);   /* g729_mult_r() */
+        }
+    }
+    *seed = (G729_Word16)rnd;
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+/* end of file */
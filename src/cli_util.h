@@ -0,0 +1,277 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * File mapping, timing and file-level threads shared by the coder   *
+ * and decoder programs.                                             *
+ *                                                                   *
+ * Input files are mapped read-only and output files are created at  *
+ * their final size and mapped writable, so that a whole file is     *
+ * coded in place with no read or write call per frame. Without mmap *
+ * (G729A_CLI_MMAP=0, the default on Windows, or a file that cannot  *
+ * be mapped such as a pipe) the files are read and written whole    *
+ * through stdio instead.                                            *
+ *-------------------------------------------------------------------*/
+
+#ifndef __CLI_UTIL_H__
+#define __CLI_UTIL_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(G729A_CLI_MMAP)
+#if defined(_WIN32)
+#define G729A_CLI_MMAP      0
+#else
+#define G729A_CLI_MMAP      1
+#endif
+#endif
+
+#if !defined(G729A_CLI_THREADS)
+#if defined(_WIN32)
+#define G729A_CLI_THREADS   0
+#else
+#define G729A_CLI_THREADS   1
+#endif
+#endif
+
+#if defined(G729A_CLI_MMAP) && (G729A_CLI_MMAP == 1)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(G729A_CLI_THREADS) && (G729A_CLI_THREADS == 1)
+#include <pthread.h>
+#endif
+
+typedef struct _cli_map
+{
+    void *data;                 /* Contents of the file                  */
+    size_t size;                /* Bytes in data                         */
+    int mapped;                 /* data is mapped, else malloc'ed        */
+    FILE *f;                    /* Output file written at unmap, if not  */
+                                /* mapped                                */
+} cli_map;
+
+/* Wall clock time in seconds */
+static double cli_Time(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/* Maps or reads a whole input file, returns 0 or -1 */
+static int cli_Map_Read(cli_map *m, const char *path)
+{
+    FILE *f;
+    size_t n, cap;
+    char *p, *q;
+    
+    memset(m, 0, sizeof(cli_map));
+    
+#if defined(G729A_CLI_MMAP) && (G729A_CLI_MMAP == 1)
+    {
+        struct stat st;
+        int fd = open(path, O_RDONLY);
+    
+        if ( fd < 0 ) return -1;
+        if ( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 )
+        {
+            m->data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if ( m->data != MAP_FAILED )
+            {
+                madvise(m->data, (size_t)st.st_size, MADV_SEQUENTIAL);
+                m->size = (size_t)st.st_size;
+                m->mapped = 1;
+                close(fd);
+                return 0;
+            }
+            m->data = NULL;
+        }
+        close(fd);
+    }
+#endif
+    
+    if ( (f = fopen(path, "rb")) == NULL ) return -1;
+    
+    cap = 1 << 20;
+    p = (char *)malloc(cap);
+    while ( NULL != p && (n = fread(p + m->size, 1, cap - m->size, f)) > 0 )
+    {
+        m->size += n;
+        if ( m->size == cap )
+        {
+            q = (char *)realloc(p, cap * 2);
+            if ( NULL == q ) free(p);
+            p = q;
+            cap *= 2;
+        }
+    }
+    m->data = p;
+    n = ferror(f);
+    fclose(f);
+    return (NULL == p || n) ? -1 : 0;
+}
+
+/* Creates an output file of size bytes, to be filled through m->data */
+static int cli_Map_Write(cli_map *m, const char *path, size_t size)
+{
+    memset(m, 0, sizeof(cli_map));
+    m->size = size;
+    
+#if defined(G729A_CLI_MMAP) && (G729A_CLI_MMAP == 1)
+    {
+        struct stat st;
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    
+        if ( fd < 0 ) return -1;
+        if ( size > 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && ftruncate(fd, (off_t)size) == 0 )
+        {
+            m->data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if ( m->data != MAP_FAILED )
+            {
+                m->mapped = 1;
+                close(fd);
+                return 0;
+            }
+            m->data = NULL;
+        }
+        close(fd);
+    }
+#endif
+    
+    if ( (m->f = fopen(path, "wb")) == NULL ) return -1;
+    m->data = malloc(size + 1);
+    return NULL == m->data ? -1 : 0;
+}
+
+/* Unmaps or frees a file, writing it first if it is an output file */
+static int cli_Unmap(cli_map *m)
+{
+    int ret = 0;
+    
+    if ( m->mapped )
+    {
+#if defined(G729A_CLI_MMAP) && (G729A_CLI_MMAP == 1)
+        ret = munmap(m->data, m->size);
+#endif
+    }
+    else
+    {
+        if ( NULL != m->f )
+        {
+            if ( NULL != m->data && fwrite(m->data, 1, m->size, m->f) != m->size ) ret = -1;
+            if ( fclose(m->f) != 0 ) ret = -1;
+        }
+        free(m->data);
+    }
+    memset(m, 0, sizeof(cli_map));
+    return ret;
+}
+
+/*-------------------------------------------------------------------*
+ * Runs fn on the nJobs jobs of size jobSize at jobs, on up to       *
+ * nThreads threads that take the next job when done with one.       *
+ *-------------------------------------------------------------------*/
+
+typedef struct _cli_runner
+{
+    void (*fn)(void *);
+    char *jobs;
+    size_t jobSize;
+    int nJobs;
+    int next;
+#if defined(G729A_CLI_THREADS) && (G729A_CLI_THREADS == 1)
+    pthread_mutex_t lock;
+#endif
+} cli_runner;
+
+static void * cli_Worker(void *arg)
+{
+    cli_runner *r = (cli_runner *)arg;
+    int i;
+    
+    for ( ;; )
+    {
+#if defined(G729A_CLI_THREADS) && (G729A_CLI_THREADS == 1)
+        pthread_mutex_lock(&r->lock);
+        i = r->next++;
+        pthread_mutex_unlock(&r->lock);
+#else
+        i = r->next++;
+#endif
+        if ( i >= r->nJobs ) break;
+        r->fn(r->jobs + i * r->jobSize);
+    }
+    return NULL;
+}
+
+static void cli_Run_Jobs(void (*fn)(void *), void *jobs, size_t jobSize, int nJobs, int nThreads)
+{
+    cli_runner r;
+    
+    r.fn      = fn;
+    r.jobs    = (char *)jobs;
+    r.jobSize = jobSize;
+    r.nJobs   = nJobs;
+    r.next    = 0;
+    
+#if defined(G729A_CLI_THREADS) && (G729A_CLI_THREADS == 1)
+    {
+        pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * (nThreads > 1 ? nThreads : 1));
+        int i, n = 1;
+    
+        if ( nThreads > nJobs ) nThreads = nJobs;
+        pthread_mutex_init(&r.lock, NULL);
+        while ( NULL != threads && n < nThreads && pthread_create(&threads[n], NULL, cli_Worker, &r) == 0 )
+        {
+            n++;
+        }
+        cli_Worker(&r);
+        for ( i = 1; i < n; ++i )
+        {
+            pthread_join(threads[i], NULL);
+        }
+        pthread_mutex_destroy(&r.lock);
+        free(threads);
+    }
+#else
+    (void)nThreads;
+    cli_Worker(&r);
+#endif
+}
+
+#endif  /* __CLI_UTIL_H__ */
+/* end of file */
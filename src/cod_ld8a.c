@@ -67,9 +67,11 @@
 #include "g729a_typedef.h"
 #include "basic_op.h"
 #include "ld8a.h"
+#include "simd_func.h"
 
 #include "g729a_errors.h"
 #include "g729a_encoder.h"
+#include "stage_stats.h"
 
 /*-----------------------------------------------------------*
  *    Coder constant parameters (defined in "ld8a.h")        *
@@ -92,6 +94,13 @@
 
 static G729_Word16 g729_lsp_old[M]={30000, 26000, 21000, 15000, 8000, 0, -8000,-15000,-21000,-26000};
 
+static void Coder_lanes(
+    g729a_encoder_state * st[],
+    G729_Word16 n,
+    G729_Word16 * ana_l[],
+    G729_Word16 * lsp_l[]
+);
+
 /*-----------------------------------------------------------------*
  *   Function  g729_Init_Coder_ld8a                                     *
  *            ~~~~~~~~~~~~~~~                                      *
@@ -99,8 +108,6 @@ static G729_Word16 g729_lsp_old[M]={30000, 26000, 21000, 15000, 8000, 0, -8000,-
  *  g729_Init_Coder_ld8a(void);                                         *
  *                                                                 *
  *   ->Initialization of variables for the coder section.          *
- *       - initialize pointers to speech buffer                    *
- *       - initialize static  pointers                             *
  *       - set static vectors to zero                              *
  *                                                                 *
  *-----------------------------------------------------------------*/
@@ -111,31 +118,6 @@ void g729_Init_Coder_ld8a(g729a_encoder_state * state)
     
     state->error = G729A_NO_ERROR;
     
-    /*----------------------------------------------------------------------*
-     *      Initialize pointers to speech vector.                            *
-     *                                                                       *
-     *                                                                       *
-     *   |--------------------|-------------|-------------|------------|     *
-     *     previous speech           sf1           sf2         L_NEXT        *
-     *                                                                       *
-     *   <----------------  Total speech vector (L_TOTAL)   ----------->     *
-     *   <----------------  LPC analysis window (L_WINDOW)  ----------->     *
-     *   |                   <-- present frame (L_FRAME) -->                 *
-     * old_speech            |              <-- new speech (L_FRAME) -->     *
-     * p_window              |              |                                *
-     *                     speech           |                                *
-     *                             new_speech                                *
-     *-----------------------------------------------------------------------*/
-    
-    state->new_speech = state->old_speech + L_TOTAL - L_FRAME;         /* New speech     */
-    state->speech     = state->new_speech - L_NEXT;                    /* Present frame  */
-    state->p_window   = state->old_speech + L_TOTAL - L_WINDOW;        /* For LPC window */
-    
-    /* Initialize static pointers */
-    
-    state->wsp    = state->old_wsp + PIT_MAX;
-    state->exc    = state->old_exc + PIT_MAX + L_INTERPOL;
-    
     /* Static vectors to zero */
     
     g729_Set_zero(state->old_speech, L_TOTAL);
@@ -152,9 +134,19 @@ void g729_Init_Coder_ld8a(g729a_encoder_state * state)
     
     for ( i = 0; i < 4; ++i ) state->past_qua_en[i] = -14336;
     
+    /* Last A(z) for case of unstable filter */
+    state->old_A[0] = 4096;
+    g729_Set_zero(&(state->old_A[1]), M);
+    g729_Set_zero(state->old_rc, 2);
+    
     g729_Lsp_encw_reset(&(state->lspenc_state));
     g729_Init_exc_err(&(state->taming_state));
     
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+    g729_Init_Vad(&(state->vad_state));
+    g729_Init_Cod_cng(&(state->dtx_state));
+#endif
+    
     return;
 }
 
@@ -182,35 +174,161 @@ void g729_Coder_ld8a(
     G729_Word16 ana[]       /* output  : Analysis parameters */
 )
 {
+    g729_Coder_ld8a_lanes(&state, 1, &ana);
+}
+
+/*-----------------------------------------------------------------*
+ *   Function g729_Coder_ld8a_lanes                                *
+ *            ~~~~~~~~~~~~~~~~~~~~~                                *
+ *   ->Main coder function for n independent channels.             *
+ *                                                                 *
+ *   The channels run the steps of g729_Coder_ld8a() in lockstep:  *
+ *   the LPC residual and the weighting, impulse response, target  *
+ *   and adaptive codebook filters run for all channels in one     *
+ *   call, one channel per vector lane, and the searches run       *
+ *   channel by channel. Every channel gets exactly the output of  *
+ *   g729_Coder_ld8a().                                            *
+ *-----------------------------------------------------------------*/
+
+void g729_Coder_ld8a_lanes(
+    g729a_encoder_state * st[], /* (i/o) : states of the channels         */
+    G729_Word16 n,              /* (i)   : number of channels, 1..G729_LANES */
+    G729_Word16 * ana_l[]       /* (o)   : analysis parameters of each channel */
+)
+{
+    Coder_lanes(st, n, ana_l, NULL);
+}
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+/*-----------------------------------------------------------------*
+ *   Function g729_Coder_ld8a_dtx                                  *
+ *            ~~~~~~~~~~~~~~~~~~~                                  *
+ *   ->Main coder function with discontinuous transmission.        *
+ *                                                                 *
+ *   The voice activity detector classifies the frame from its LP  *
+ *   analysis. Active frames are coded as by g729_Coder_ld8a().    *
+ *   Inactive frames skip the LSP quantization and the pitch and   *
+ *   codebook searches: g729_Cod_cng() sends a SID frame or        *
+ *   nothing, and keeps the state in step with the decoder's       *
+ *   comfort noise.                                                *
+ *                                                                 *
+ *  Ouputs:                                                        *
+ *                                                                 *
+ *    ana[]      ->analysis parameters (PRM_SIZE) of a speech      *
+ *                 frame, or SID parameters (3) of a SID frame.    *
+ *                                                                 *
+ *  Return: FRAME_SPEECH, FRAME_SID or FRAME_NO_TX                 *
+ *-----------------------------------------------------------------*/
+
+G729_Word16 g729_Coder_ld8a_dtx(
+    g729a_encoder_state * state,
+    G729_Word16 ana[]       /* output  : Analysis parameters */
+)
+{
+    G729_Word16 A[MP1];                   /* Unquantized A(z) of the frame        */
+    G729_Word16 lsp_new[M];               /* LSPs at 2th subframe                 */
+    G729_Word16 *lsp_l;
+    G729_STATS_DECL
+    
+    G729_STATS_START;
+    g729_Lpc_ld8a(state, A, lsp_new);
+    G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_LPC);
+    
+    if (g729_Vad(&(state->vad_state), G729_ENC_SPEECH(state), lsp_new) == 0)
+    {
+        return g729_Cod_cng(state, A, lsp_new, ana);
+    }
+    
+    state->dtx_state.past_vad = 1;
+    
+    lsp_l = lsp_new;
+    Coder_lanes(&state, 1, &ana, &lsp_l);
+    
+    return FRAME_SPEECH;
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+/*-----------------------------------------------------------------*
+ *   Function g729_Lpc_ld8a                                        *
+ *            ~~~~~~~~~~~~~                                        *
+ *   ->LP analysis of the present frame: autocorrelation, lag      *
+ *     windowing, Levinson-Durbin and conversion of A(z) to LSPs.  *
+ *-----------------------------------------------------------------*/
+
+void g729_Lpc_ld8a(
+    g729a_encoder_state * state,
+    G729_Word16 A[],          /* (o) Q12 : LP filter coefficients (M+1) */
+    G729_Word16 lsp_new[]     /* (o) Q15 : LSPs of the frame             */
+)
+{
+    G729_Word16 r_l[MP1], r_h[MP1];       /* Autocorrelations low and hi          */
+    G729_Word16 rc[M];                    /* Reflection coefficients.             */
+    
+    g729_Autocorr(G729_ENC_P_WINDOW(state), M, r_h, r_l);       /* Autocorrelations */
+    g729_Lag_window(M, r_h, r_l);                      /* Lag windowing    */
+    g729_Levinson(r_h, r_l, A, rc, state->old_A, state->old_rc); /* Levinson Durbin */
+    g729_Az_lsp(A, lsp_new, state->lsp_old);           /* From A(z) to lsp */
+}
+
+/*-----------------------------------------------------------------*
+ *   Body of g729_Coder_ld8a_lanes(). With lsp_l != NULL, the LP   *
+ *   analysis of the channels has been done by g729_Lpc_ld8a() and *
+ *   lsp_l[] holds their LSPs.                                     *
+ *-----------------------------------------------------------------*/
+
+static void Coder_lanes(
+    g729a_encoder_state * st[], /* (i/o) : states of the channels         */
+    G729_Word16 n,              /* (i)   : number of channels, 1..G729_LANES */
+    G729_Word16 * ana_l[],      /* (o)   : analysis parameters of each channel */
+    G729_Word16 * lsp_l[]       /* (i)   : LSPs of each channel, or NULL       */
+)
+{
+    g729a_encoder_state * state;
     
     /* LPC analysis */
     
-    G729_Word16 Aq_t[(MP1)*2];         /* A(z)   quantized for the 2 subframes */
-    G729_Word16 Ap_t[(MP1)*2];         /* A(z/gamma)       for the 2 subframes */
-    G729_Word16 *Aq, *Ap;              /* Pointer on Aq_t and Ap_t             */
+    G729_Word16 Aq_t[G729_LANES][(MP1)*2]; /* A(z)   quantized for the 2 subframes */
+    G729_Word16 Ap_t[G729_LANES][(MP1)*2]; /* A(z/gamma)       for the 2 subframes */
+    G729_Word16 Ap1[G729_LANES][MP1];      /* A(z/gamma) of the weighting filter   */
     
     /* Other vectors */
     
-    G729_Word16 h1[L_SUBFR];            /* Impulse response h1[]              */
-    G729_Word16 xn[L_SUBFR];            /* Target vector for pitch search     */
-    G729_Word16 xn2[L_SUBFR];           /* Target vector for codebook search  */
-    G729_Word16 code[L_SUBFR];          /* Fixed codebook excitation          */
-    G729_Word16 y1[L_SUBFR];            /* Filtered adaptive excitation       */
-    G729_Word16 y2[L_SUBFR];            /* Filtered fixed codebook excitation */
-    G729_Word16 g_coeff[4];             /* Correlations between xn & y1       */
+    G729_Word16 h1[G729_LANES][L_SUBFR];   /* Impulse response h1[]              */
+    G729_Word16 xn[G729_LANES][L_SUBFR];   /* Target vector for pitch search     */
+    G729_Word16 xn2[L_SUBFR];              /* Target vector for codebook search  */
+    G729_Word16 code[L_SUBFR];             /* Fixed codebook excitation          */
+    G729_Word16 y1[G729_LANES][L_SUBFR];   /* Filtered adaptive excitation       */
+    G729_Word16 y2[L_SUBFR];               /* Filtered fixed codebook excitation */
+    G729_Word16 g_coeff[4];                /* Correlations between xn & y1       */
     
     G729_Word16 g_coeff_cs[5];
     G729_Word16 exp_g_coeff_cs[5];      /* Correlations between xn, y1, & y2
                                                  <y1,y1>, -2<xn,y1>,
                                                  <y2,y2>, -2<xn,y2>, 2<y1,y2> */
     
+    /* Filter arguments of each channel */
+    
+    G729_Word16 *f_a[G729_LANES], *f_x[G729_LANES], *f_y[G729_LANES], *f_mem[G729_LANES];
+    G729_Word16 *ana[G729_LANES];
+    
     /* Scalars */
     
-    G729_Word16 i, j, k, i_subfr;
-    G729_Word16 T_op, T0, T0_min, T0_max, T0_frac;
+    G729_Word16 i, j, k, l, i_subfr;
+    G729_Word16 T_op, T0[G729_LANES], T0_frac[G729_LANES];
+    G729_Word16 T0_min[G729_LANES], T0_max[G729_LANES];
     G729_Word16 gain_pit, gain_code, index;
     G729_Word16 temp, taming;
     G729_Word32 L_temp;
+    G729_STATS_DECL
+    
+    G729_STATS_START;
+    
+    for (l = 0; l < n; l++)
+    {
+        ana[l] = ana_l[l];
+    }
     
     /*------------------------------------------------------------------------*
      *  - Perform LPC analysis:                                               *
@@ -221,40 +339,47 @@ void g729_Coder_ld8a(
      *       * find the interpolated LSPs and convert to a[] for the 2        *
      *         subframes (both quantized and unquantized)                     *
      *------------------------------------------------------------------------*/
+    for (l = 0; l < n; l++)
     {
         /* Temporary vectors */
-        G729_Word16 r_l[MP1], r_h[MP1];       /* Autocorrelations low and hi          */
-        G729_Word16 rc[M];                    /* Reflection coefficients.             */
         G729_Word16 lsp_new[M], lsp_new_q[M]; /* LSPs at 2th subframe                 */
         
+        state = st[l];
+        
         /* LP analysis */
         
-        g729_Autocorr(state->p_window, M, r_h, r_l);       /* Autocorrelations */
-        g729_Lag_window(M, r_h, r_l);                      /* Lag windowing    */
-        g729_Levinson(r_h, r_l, Ap_t, rc);                 /* g729_Levinson Durbin  */
-        g729_Az_lsp(Ap_t, lsp_new, state->lsp_old);        /* From A(z) to lsp */
+        if (lsp_l == NULL) {
+            g729_Lpc_ld8a(state, Ap_t[l], lsp_new);
+        }
+        else {
+            g729_Copy(lsp_l[l], lsp_new, M);
+        }
+        
+        G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_LPC);
         
         /* LSP quantization */
         
-        g729_Qua_lsp(&(state->lspenc_state), lsp_new, lsp_new_q, ana);
-        ana += 2;                         /* Advance analysis parameters pointer */
+        g729_Qua_lsp(&(state->lspenc_state), lsp_new, lsp_new_q, ana[l]);
+        ana[l] += 2;                      /* Advance analysis parameters pointer */
         
         /*--------------------------------------------------------------------*
          * Find interpolated LPC parameters in all subframes                  *
          * The interpolated parameters are in array Aq_t[].                   *
          *--------------------------------------------------------------------*/
         
-        g729_Int_qlpc(state->lsp_old_q, lsp_new_q, Aq_t);
+        g729_Int_qlpc(state->lsp_old_q, lsp_new_q, Aq_t[l]);
         
         /* Compute A(z/gamma) */
         
-        g729_Weight_Az(&Aq_t[0],   GAMMA1, M, &Ap_t[0]);
-        g729_Weight_Az(&Aq_t[MP1], GAMMA1, M, &Ap_t[MP1]);
+        g729_Weight_Az(&Aq_t[l][0],   GAMMA1, M, &Ap_t[l][0]);
+        g729_Weight_Az(&Aq_t[l][MP1], GAMMA1, M, &Ap_t[l][MP1]);
         
         /* update the LSPs for the next frame */
         
         g729_Copy(lsp_new,   state->lsp_old,   M);
         g729_Copy(lsp_new_q, state->lsp_old_q, M);
+        
+        G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_LSP_QUANT);
     }
     
     /*----------------------------------------------------------------------*
@@ -262,43 +387,62 @@ void g729_Coder_ld8a(
      * - Find the open-loop pitch delay                                     *
      *----------------------------------------------------------------------*/
     
-    g729_Residu(&Aq_t[0], &(state->speech[0]), &(state->exc[0]), L_SUBFR);
-    g729_Residu(&Aq_t[MP1], &(state->speech[L_SUBFR]), &(state->exc[L_SUBFR]), L_SUBFR);
-    
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
     {
-        G729_Word16 Ap1[MP1];
-        
-        Ap = Ap_t;
-        Ap1[0] = 4096;
-        for(i=1; i<=M; i++)    /* Ap1[i] = Ap[i] - 0.7 * Ap[i-1]; */
-            Ap1[i] = g729_sub(Ap[i], g729_mult(Ap[i-1], 22938));
-        g729_Syn_filt(Ap1, &(state->exc[0]), &(state->wsp[0]), L_SUBFR, state->mem_w, 1);
-        
-        Ap += MP1;
-        for(i=1; i<=M; i++)    /* Ap1[i] = Ap[i] - 0.7 * Ap[i-1]; */
-            Ap1[i] = g729_sub(Ap[i], g729_mult(Ap[i-1], 22938));
-        g729_Syn_filt(Ap1, &(state->exc[L_SUBFR]), &(state->wsp[L_SUBFR]), L_SUBFR, state->mem_w, 1);
+        for (l = 0; l < n; l++)
+        {
+            f_a[l] = &Aq_t[l][i_subfr == 0 ? 0 : MP1];
+            f_x[l] = &G729_ENC_SPEECH(st[l])[i_subfr];
+            f_y[l] = &G729_ENC_EXC(st[l])[i_subfr];
+        }
+        g729_Residu_lanes(n, f_a, f_x, f_y, L_SUBFR);
     }
     
-    /* Find open loop pitch lag */
-    
-    T_op = g729_Pitch_ol_fast(state->wsp, PIT_MAX, L_FRAME);
-    
-    /* Range for closed loop pitch search in 1st subframe */
-    
-    T0_min = g729_sub(T_op, 3);
-    if (g729_sub(T0_min,PIT_MIN)<0) {
-        T0_min = PIT_MIN;
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        for (l = 0; l < n; l++)
+        {
+            G729_Word16 *Ap = &Ap_t[l][i_subfr == 0 ? 0 : MP1];
+            
+            Ap1[l][0] = 4096;
+            for(i=1; i<=M; i++)    /* Ap1[i] = Ap[i] - 0.7 * Ap[i-1]; */
+                Ap1[l][i] = g729_sub(Ap[i], g729_mult(Ap[i-1], 22938));
+            
+            f_a[l]   = Ap1[l];
+            f_x[l]   = &G729_ENC_EXC(st[l])[i_subfr];
+            f_y[l]   = &G729_ENC_WSP(st[l])[i_subfr];
+            f_mem[l] = st[l]->mem_w;
+        }
+        g729_Syn_filt_lanes(n, f_a, f_x, f_y, L_SUBFR, f_mem, 1);
     }
     
-    T0_max = g729_add(T0_min, 6);
-    if (g729_sub(T0_max ,PIT_MAX)>0)
+    G729_STATS_SHARE(st, n, G729A_ENC_STAGE_OL_PITCH);
+    
+    for (l = 0; l < n; l++)
     {
-        T0_max = PIT_MAX;
-        T0_min = g729_sub(T0_max, 6);
+        state = st[l];
+        
+        /* Find open loop pitch lag */
+        
+        T_op = g729_Pitch_ol_fast(G729_ENC_WSP(state), PIT_MAX, L_FRAME);
+        
+        /* Range for closed loop pitch search in 1st subframe */
+        
+        T0_min[l] = g729_sub(T_op, 3);
+        if (g729_sub(T0_min[l],PIT_MIN)<0) {
+            T0_min[l] = PIT_MIN;
+        }
+        
+        T0_max[l] = g729_add(T0_min[l], 6);
+        if (g729_sub(T0_max[l] ,PIT_MAX)>0)
+        {
+            T0_max[l] = PIT_MAX;
+            T0_min[l] = g729_sub(T0_max[l], 6);
+        }
+        
+        G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_OL_PITCH);
     }
     
-    
     /*------------------------------------------------------------------------*
      *          Loop for every subframe in the analysis frame                 *
      *------------------------------------------------------------------------*
@@ -316,9 +460,6 @@ void g729_Coder_ld8a(
      *     - update states of weighting filter                                *
      *------------------------------------------------------------------------*/
     
-    Aq = Aq_t;    /* pointer to interpolated quantized LPC parameters */
-    Ap = Ap_t;    /* pointer to weighted LPC coefficients             */
-    
     for (i_subfr = 0;  i_subfr < L_FRAME; i_subfr += L_SUBFR)
     {
         
@@ -326,29 +467,52 @@ void g729_Coder_ld8a(
          * Compute impulse response, h1[], of weighted synthesis filter  *
          *---------------------------------------------------------------*/
         
-        h1[0] = 4096;
-        g729_Set_zero(&h1[1], L_SUBFR-1);
-        g729_Syn_filt(Ap, h1, h1, L_SUBFR, &h1[1], 0);
+        for (l = 0; l < n; l++)
+        {
+            h1[l][0] = 4096;
+            g729_Set_zero(&h1[l][1], L_SUBFR-1);
+            
+            f_a[l]   = &Ap_t[l][i_subfr == 0 ? 0 : MP1];
+            f_x[l]   = h1[l];
+            f_y[l]   = h1[l];
+            f_mem[l] = &h1[l][1];
+        }
+        g729_Syn_filt_lanes(n, f_a, f_x, f_y, L_SUBFR, f_mem, 0);
         
         /*----------------------------------------------------------------------*
          *  Find the target vector for pitch search:                            *
          *----------------------------------------------------------------------*/
         
-        g729_Syn_filt(Ap, &(state->exc[i_subfr]), xn, L_SUBFR, state->mem_w0, 0);
+        for (l = 0; l < n; l++)
+        {
+            f_x[l]   = &G729_ENC_EXC(st[l])[i_subfr];
+            f_y[l]   = xn[l];
+            f_mem[l] = st[l]->mem_w0;
+        }
+        g729_Syn_filt_lanes(n, f_a, f_x, f_y, L_SUBFR, f_mem, 0);
+        
+        G729_STATS_SHARE(st, n, G729A_ENC_STAGE_CL_PITCH);
         
         /*---------------------------------------------------------------------*
          *                 Closed-loop fractional pitch search                 *
          *---------------------------------------------------------------------*/
         
-        T0 = g729_Pitch_fr3_fast(&(state->exc[i_subfr]), xn, h1, L_SUBFR, T0_min, T0_max,
-                                 i_subfr, &T0_frac);
-        
-        index = g729_Enc_lag3(T0, T0_frac, &T0_min, &T0_max,PIT_MIN,PIT_MAX,i_subfr);
-        
-        *ana++ = index;
-        
-        if (i_subfr == 0) {
-            *ana++ = g729_Parity_Pitch(index);
+        for (l = 0; l < n; l++)
+        {
+            state = st[l];
+            
+            T0[l] = g729_Pitch_fr3_fast(&G729_ENC_EXC(state)[i_subfr], xn[l], h1[l], L_SUBFR, T0_min[l], T0_max[l],
+                                        i_subfr, &T0_frac[l]);
+            
+            index = g729_Enc_lag3(T0[l], T0_frac[l], &T0_min[l], &T0_max[l],PIT_MIN,PIT_MAX,i_subfr);
+            
+            *ana[l]++ = index;
+            
+            if (i_subfr == 0) {
+                *ana[l]++ = g729_Parity_Pitch(index);
+            }
+            
+            G729_STATS_ADD(&(state->stats), G729A_ENC_STAGE_CL_PITCH);
         }
         
         /*-----------------------------------------------------------------*
@@ -357,96 +521,111 @@ void g729_Coder_ld8a(
          *   - update target vector for codebook search                    *
          *-----------------------------------------------------------------*/
         
-        g729_Syn_filt(Ap, &(state->exc[i_subfr]), y1, L_SUBFR, state->mem_zero, 0);
-        
-        gain_pit = g729_G_pitch(xn, y1, g_coeff, L_SUBFR);
-        
-        /* clip pitch gain if taming is necessary */
-        
-        taming = g729_test_err(&(state->taming_state), T0, T0_frac);
-        
-        if( taming == 1){
-            if (g729_sub(gain_pit, GPCLIP) > 0) {
-                gain_pit = GPCLIP;
-            }
-        }
-        
-        /* xn2[i]   = xn[i] - y1[i] * gain_pit  */
-        
-        for (i = 0; i < L_SUBFR; i++)
+        for (l = 0; l < n; l++)
         {
-            L_temp = g729_L_mult(y1[i], gain_pit);
-            L_temp = g729_L_shl(L_temp, 1);               /* gain_pit in Q14 */
-            xn2[i] = g729_sub(xn[i], g729_extract_h(L_temp));
+            f_y[l]   = y1[l];
+            f_mem[l] = st[l]->mem_zero;
         }
+        g729_Syn_filt_lanes(n, f_a, f_x, f_y, L_SUBFR, f_mem, 0);
         
+        G729_STATS_SHARE(st, n, G729A_ENC_STAGE_CL_PITCH);
         
-        /*-----------------------------------------------------*
-         * - Innovative codebook search.                       *
-         *-----------------------------------------------------*/
-        
-        index = g729_ACELP_Code_A(xn2, h1, T0, state->sharp, code, y2, &i);
-        
-        *ana++ = index;        /* Positions index */
-        *ana++ = i;            /* Signs index     */
-        
-        
-        /*-----------------------------------------------------*
-         * - Quantization of gains.                            *
-         *-----------------------------------------------------*/
-        
-        g_coeff_cs[0]     = g_coeff[0];            /* <y1,y1> */
-        exp_g_coeff_cs[0] = g729_negate(g_coeff[1]);    /* Q-Format:XXX -> JPN */
-        g_coeff_cs[1]     = g729_negate(g_coeff[2]);    /* (xn,y1) -> -2<xn,y1> */
-        exp_g_coeff_cs[1] = g729_negate(g729_add(g_coeff[3], 1)); /* Q-Format:XXX -> JPN */
-        
-        g729_Corr_xy2( xn, y1, y2, g_coeff_cs, exp_g_coeff_cs );  /* Q0 Q0 Q12 ^Qx ^Q0 */
-        /* g_coeff_cs[3]:exp_g_coeff_cs[3] = <y2,y2>   */
-        /* g_coeff_cs[4]:exp_g_coeff_cs[4] = -2<xn,y2> */
-        /* g_coeff_cs[5]:exp_g_coeff_cs[5] = 2<y1,y2>  */
-        
-        *ana++ = g729_Qua_gain(state, code, g_coeff_cs, exp_g_coeff_cs,
-                               L_SUBFR, &gain_pit, &gain_code, taming);
-        
-        
-        /*------------------------------------------------------------*
-         * - Update pitch sharpening "sharp" with quantized gain_pit  *
-         *------------------------------------------------------------*/
-        
-        state->sharp = gain_pit;
-        if (g729_sub(state->sharp, SHARPMAX) > 0) { state->sharp = SHARPMAX;         }
-        if (g729_sub(state->sharp, SHARPMIN) < 0) { state->sharp = SHARPMIN;         }
-        
-        /*------------------------------------------------------*
-         * - Find the total excitation                          *
-         * - update filters memories for finding the target     *
-         *   vector in the next subframe                        *
-         *------------------------------------------------------*/
-        
-        for (i = 0; i < L_SUBFR;  i++)
-        {
-            /* exc[i] = gain_pit*exc[i] + gain_code*code[i]; */
-            /* exc[i]  in Q0   gain_pit in Q14               */
-            /* code[i] in Q13  gain_cod in Q1                */
-            
-            L_temp = g729_L_mult(state->exc[i+i_subfr], gain_pit);
-            L_temp = g729_L_mac(L_temp, code[i], gain_code);
-            L_temp = g729_L_shl(L_temp, 1);
-            state->exc[i+i_subfr] = g729_round(L_temp);
-        }
-        
-        g729_update_exc_err(&(state->taming_state), gain_pit, T0);
-        
-        for (i = L_SUBFR-M, j = 0; i < L_SUBFR; i++, j++)
+        for (l = 0; l < n; l++)
         {
-            temp       = g729_extract_h(g729_L_shl( g729_L_mult(y1[i], gain_pit),  1) );
-            k          = g729_extract_h(g729_L_shl( g729_L_mult(y2[i], gain_code), 2) );
-            state->mem_w0[j]  = g729_sub(xn[i], g729_add(temp, k));
+            state = st[l];
+            
+            gain_pit = g729_G_pitch(xn[l], y1[l], g_coeff, L_SUBFR);
+            
+            G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_CL_PITCH);
+            
+            /* clip pitch gain if taming is necessary */
+            
+            taming = g729_test_err(&(state->taming_state), T0[l], T0_frac[l]);
+            
+            if( taming == 1){
+                if (g729_sub(gain_pit, GPCLIP) > 0) {
+                    gain_pit = GPCLIP;
+                }
+            }
+            
+            G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_TAMING);
+            
+            /* xn2[i]   = xn[i] - y1[i] * gain_pit  */
+            
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                L_temp = g729_L_mult(y1[l][i], gain_pit);
+                L_temp = g729_L_shl(L_temp, 1);               /* gain_pit in Q14 */
+                xn2[i] = g729_sub(xn[l][i], g729_extract_h(L_temp));
+            }
+            
+            
+            /*-----------------------------------------------------*
+             * - Innovative codebook search.                       *
+             *-----------------------------------------------------*/
+            
+            index = g729_ACELP_Code_A(xn2, h1[l], T0[l], state->sharp, code, y2, &i);
+            
+            *ana[l]++ = index;        /* Positions index */
+            *ana[l]++ = i;            /* Signs index     */
+            
+            G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_ACELP);
+            
+            /*-----------------------------------------------------*
+             * - Quantization of gains.                            *
+             *-----------------------------------------------------*/
+            
+            g_coeff_cs[0]     = g_coeff[0];            /* <y1,y1> */
+            exp_g_coeff_cs[0] = g729_negate(g_coeff[1]);    /* Q-Format:XXX -> JPN */
+            g_coeff_cs[1]     = g729_negate(g_coeff[2]);    /* (xn,y1) -> -2<xn,y1> */
+            exp_g_coeff_cs[1] = g729_negate(g729_add(g_coeff[3], 1)); /* Q-Format:XXX -> JPN */
+            
+            g729_Corr_xy2( xn[l], y1[l], y2, g_coeff_cs, exp_g_coeff_cs );  /* Q0 Q0 Q12 ^Qx ^Q0 */
+            /* g_coeff_cs[3]:exp_g_coeff_cs[3] = <y2,y2>   */
+            /* g_coeff_cs[4]:exp_g_coeff_cs[4] = -2<xn,y2> */
+            /* g_coeff_cs[5]:exp_g_coeff_cs[5] = 2<y1,y2>  */
+            
+            *ana[l]++ = g729_Qua_gain(state, code, g_coeff_cs, exp_g_coeff_cs,
+                                      L_SUBFR, &gain_pit, &gain_code, taming);
+            
+            
+            /*------------------------------------------------------------*
+             * - Update pitch sharpening "sharp" with quantized gain_pit  *
+             *------------------------------------------------------------*/
+            
+            state->sharp = gain_pit;
+            if (g729_sub(state->sharp, SHARPMAX) > 0) { state->sharp = SHARPMAX;         }
+            if (g729_sub(state->sharp, SHARPMIN) < 0) { state->sharp = SHARPMIN;         }
+            
+            /*------------------------------------------------------*
+             * - Find the total excitation                          *
+             * - update filters memories for finding the target     *
+             *   vector in the next subframe                        *
+             *------------------------------------------------------*/
+            
+            for (i = 0; i < L_SUBFR;  i++)
+            {
+                /* exc[i] = gain_pit*exc[i] + gain_code*code[i]; */
+                /* exc[i]  in Q0   gain_pit in Q14               */
+                /* code[i] in Q13  gain_cod in Q1                */
+                
+                L_temp = g729_L_mult(G729_ENC_EXC(state)[i+i_subfr], gain_pit);
+                L_temp = g729_L_mac(L_temp, code[i], gain_code);
+                L_temp = g729_L_shl(L_temp, 1);
+                G729_ENC_EXC(state)[i+i_subfr] = g729_round(L_temp);
+            }
+            
+            g729_update_exc_err(&(state->taming_state), gain_pit, T0[l]);
+            
+            for (i = L_SUBFR-M, j = 0; i < L_SUBFR; i++, j++)
+            {
+                temp       = g729_extract_h(g729_L_shl( g729_L_mult(y1[l][i], gain_pit),  1) );
+                k          = g729_extract_h(g729_L_shl( g729_L_mult(y2[i], gain_code), 2) );
+                state->mem_w0[j]  = g729_sub(xn[l][i], g729_add(temp, k));
+            }
+            
+            G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_GAIN);
         }
-        
-        Aq += MP1;           /* interpolated LPC parameters for next subframe */
-        Ap += MP1;
-        
     }
     
     /*--------------------------------------------------*
@@ -455,10 +634,14 @@ void g729_Coder_ld8a(
      *     speech[], wsp[] and  exc[]                   *
      *--------------------------------------------------*/
     
-    g729_Copy(&(state->old_speech[L_FRAME]), &(state->old_speech[0]), L_TOTAL-L_FRAME);
-    g729_Copy(&(state->old_wsp[L_FRAME]), &(state->old_wsp[0]), PIT_MAX);
-    g729_Copy(&(state->old_exc[L_FRAME]), &(state->old_exc[0]), PIT_MAX+L_INTERPOL);
+    for (l = 0; l < n; l++)
+    {
+        state = st[l];
+        
+        g729_Copy(&(state->old_speech[L_FRAME]), &(state->old_speech[0]), L_TOTAL-L_FRAME);
+        g729_Copy(&(state->old_wsp[L_FRAME]), &(state->old_wsp[0]), PIT_MAX);
+        g729_Copy(&(state->old_exc[L_FRAME]), &(state->old_exc[0]), PIT_MAX+L_INTERPOL);
+    }
     
     return;
 }
-
@@ -40,7 +40,9 @@
 /*-------------------------------------------------------------------*
  * Main program of the ITU-T G.729A  8 kbit/s encoder.               *
  *                                                                   *
- *    Usage : coder speech_file  bitstream_file                      *
+ *    Usage : coder [-q] [-s] [-t threads] [-w warmup]               *
+ *                  speech_file bitstream_file                       *
+ *                  [speech_file bitstream_file ...]                 *
  *-------------------------------------------------------------------*/
 
 #include <stdio.h>
@@ -49,49 +51,234 @@
 
 #include "g729a_typedef.h"
 #include "g729a_interface.h"
+#include "cli_util.h"
 
 #define FRAMESIZE      80
 
 #if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
 #define SERIALSIZE     (80+2)
+typedef G729_Word16    serial_word;
 #else
 #define SERIALSIZE     10
+typedef G729_UWord8    serial_word;
 #endif
 
-int main(int argc, char *argv[])
+#define WARMUPFRAMES   50       /* Default warm-up of a parallel block    */
+#define BLOCKFRAMES    1000     /* Frames coded between progress reports  */
+
+typedef struct _coder_job
 {
-    FILE *f_speech;               /* File of speech data                   */
-    FILE *f_serial;               /* File of serial bits for transmission  */
+    const char *speechFile;
+    const char *serialFile;
+    int nThreads;               /* Blocks coded in parallel in the file   */
+    int warmup;
+    int verbose;                /* Print the frame counter and joins      */
+    G729_Word64 frames;         /* Frames coded                           */
+    double seconds;             /* Wall time of the job                   */
+    int error;
+} coder_job;
+
+#if !defined(CONTROL_OPT_ITU) || (CONTROL_OPT_ITU != 1)
+/*--------------------------------------------------------------------------*
+ * Codes the whole speech file in blocks on nThreads threads                *
+ *--------------------------------------------------------------------------*/
+static int encode_parallel(coder_job *job, G729_Word16 *speech, serial_word *serial, G729_Word64 nFrames)
+{
+    G729A_Join *joins;
+    int nJoins, nMissed, i;
+    
+    if ( nFrames > 0x7FFFFFFF ) return -1;
     
-    G729_Word16 speechIn[FRAMESIZE];
+    joins = (G729A_Join *)malloc(job->nThreads * sizeof(G729A_Join));
+    if ( NULL == joins ) return -1;
     
+    nJoins = G729A_Encoder_Process_Parallel(speech, (G729_Word32)nFrames, serial, job->nThreads, job->warmup, joins);
+    
+    for ( i = 0, nMissed = 0; i < nJoins; ++i )
+    {
+        nMissed += joins[i].syncFrames < 0;
+    }
+    if ( nMissed > 0 )
+    {
+        fprintf(stderr, "Warning: in %d of %d joins the encoder states did not meet, the bitstream\n"
+                        "         may differ from serial coding past the warm-up (raise -w)\n", nMissed, nJoins);
+    }
+    
+    for ( i = 0; job->verbose && i < nJoins; ++i )
+    {
+        if ( joins[i].syncFrames >= 0 )
+        {
+            printf(" Join at frame %-7d:  %d frames differed, states met after %d frames\n",
+                   (int)joins[i].frame, (int)joins[i].diffFrames, (int)joins[i].syncFrames);
+        }
+        else if ( joins[i].diffFrames >= 0 )
+        {
+            printf(" Join at frame %-7d:  %d frames differed, states did not meet\n",
+                   (int)joins[i].frame, (int)joins[i].diffFrames);
+        }
+        else
+        {
+            printf(" Join at frame %-7d:  states did not meet, any frame of the block may differ\n",
+                   (int)joins[i].frame);
+        }
+    }
+    
+    free(joins);
+    return nJoins < 0 ? -1 : 0;
+}
+#endif
+
+/*--------------------------------------------------------------------------*
+ * Codes one speech file, mapped in memory, into a mapped bitstream file    *
+ *--------------------------------------------------------------------------*/
+static void encode_job(void *arg)
+{
+    coder_job *job = (coder_job *)arg;
+    cli_map in, out;
+    G729_Word16 *speech;
+    serial_word *serial;
+    G729_Word64 nFrames, frame, k;
 #if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
-    G729_Word16
+    G729_Word64 i;
+#endif
+    G729A_Enc_state state;
+    double start = cli_Time();
+    
+    job->error = -1;
+    
+    if ( cli_Map_Read(&in, job->speechFile) != 0 )
+    {
+        printf("coder - Error opening file  %s !!\n", job->speechFile);
+        cli_Unmap(&in);
+        return;
+    }
+    
+    /* A partial last frame is dropped */
+    
+    nFrames = (G729_Word64)(in.size / (FRAMESIZE * sizeof(G729_Word16)));
+    if ( cli_Map_Write(&out, job->serialFile, (size_t)nFrames * SERIALSIZE * sizeof(serial_word)) != 0 )
+    {
+        printf("coder - Error opening file  %s !!\n", job->serialFile);
+        cli_Unmap(&in);
+        cli_Unmap(&out);
+        return;
+    }
+    
+    speech = (G729_Word16 *)in.data;
+    serial = (serial_word *)out.data;
+    state  = malloc(G729A_Encoder_Get_Size());
+    
+    frame  = 0;
+    
+    if ( NULL != state && G729A_Encoder_Init(state) == 0 )
+    {
+#if !defined(CONTROL_OPT_ITU) || (CONTROL_OPT_ITU != 1)
+        if ( job->nThreads > 1 )
+        {
+            if ( encode_parallel(job, speech, serial, nFrames) == 0 ) frame = nFrames;
+        }
+        else
+#endif
+        for ( ; frame < nFrames; frame += k )
+        {
+            k = nFrames - frame;
+            if ( k > BLOCKFRAMES ) k = BLOCKFRAMES;
+            
+#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
+            for ( i = frame; i < frame + k; ++i )
+            {
+                G729A_Encoder_Process_Testing(state, &speech[i * FRAMESIZE], &serial[i * SERIALSIZE]);
+            }
 #else
-    G729_UWord8
+            if ( G729A_Encoder_Process_Frames(state, &speech[frame * FRAMESIZE], (G729_Word32)k, &serial[frame * SERIALSIZE]) != 0 ) break;
 #endif
-    serial[SERIALSIZE];     /* Output bitstream buffer               */
+            
+            if ( job->verbose )
+            {
+                printf("Frame =%lld\r", (long long)(frame + k));
+                fflush(stdout);
+            }
+        }
+        
+        if ( frame == nFrames ) job->error = 0;
+    }
+    
+    if ( job->verbose )
+    {
+        printf("Frame =%lld\n", (long long)frame);
+    }
     
-    G729_Word16 frame;                  /* frame counter */
+    free(state);
+    cli_Unmap(&in);
+    if ( cli_Unmap(&out) != 0 ) job->error = -1;
     
-    G729A_Enc_state state;
+    if ( job->error != 0 )
+    {
+        printf("coder - Error coding file  %s !!\n", job->speechFile);
+    }
     
-    printf("\n");
-    printf("***********    ITU G.729A 8 KBIT/S SPEECH CODER    ***********\n");
-    printf("\n");
-    printf("------------------- Fixed point C simulation -----------------\n");
-    printf("\n");
-    printf("------------ Version 1.1 (Release 2, November 2006) --------\n");
-    printf("\n");
+    job->frames  = frame;
+    job->seconds = cli_Time() - start;
+}
+
+int main(int argc, char *argv[])
+{
+    coder_job *jobs;
+    G729_Word64 frames = 0;
+    double start;
+    int nJobs, i, error = 0;
     
+    int quiet = 0;                      /* -q: no banner nor frame counter */
+    int stats = 0;                      /* -s: print the coding speed      */
+    int nThreads = 1;                   /* -t: threads                     */
+    int warmup = WARMUPFRAMES;          /* -w: warm-up of each block       */
     
     /*--------------------------------------------------------------------------*
-     * Open speech file and result file (output serial bit stream)              *
+     * Options, then pairs of speech file and result file (output serial bit    *
+     * stream)                                                                  *
      *--------------------------------------------------------------------------*/
     
-    if ( argc != 3 )
+    for ( i = 1; i < argc && argv[i][0] == '-'; ++i )
     {
-        printf("Usage : coder speech_file  bitstream_file\n");
+        if ( strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0 ) quiet = 1;
+        else if ( strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--stats") == 0 ) stats = 1;
+        else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) nThreads = atoi(argv[++i]);
+#if !defined(CONTROL_OPT_ITU) || (CONTROL_OPT_ITU != 1)
+        else if ( strcmp(argv[i], "-w") == 0 && i + 1 < argc ) warmup = atoi(argv[++i]);
+#endif
+        else break;
+    }
+    
+    nJobs = (argc - i) / 2;
+    
+    if ( !quiet )
+    {
+        printf("\n");
+        printf("***********    ITU G.729A 8 KBIT/S SPEECH CODER    ***********\n");
+        printf("\n");
+        printf("------------------- Fixed point C simulation -----------------\n");
+        printf("\n");
+        printf("------------ Version 1.1 (Release 2, November 2006) --------\n");
+        printf("\n");
+    }
+    
+    if ( nJobs < 1 || (argc - i) % 2 != 0 || nThreads < 1 || warmup < 0 )
+    {
+        printf("Usage : coder [-q] [-s] [-t threads] [-w warmup]\n");
+        printf("              speech_file  bitstream_file  [speech_file  bitstream_file ...]\n");
+        printf("\n");
+        printf("  -q, --quiet : print nothing but errors and statistics\n");
+        printf("  -s, --stats : print the frames, time and speed of each file\n");
+#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
+        printf("  -t threads  : code several files on this many threads\n");
+#else
+        printf("  -t threads  : code several files on this many threads, or a\n");
+        printf("                single file in blocks on this many threads; a\n");
+        printf("                single file is then not bit-exact with serial\n");
+        printf("                coding around the block joins\n");
+        printf("  -w warmup   : frames coded before each block to warm its\n");
+        printf("                encoder up (default %d)\n", WARMUPFRAMES);
+#endif
         printf("\n");
         printf("Format for speech_file:\n");
         printf("  Speech is read from a binary file of 16 bits PCM data.\n");
@@ -104,44 +291,51 @@ int main(int argc, char *argv[])
         exit(1);
     }
     
-    if ( (f_speech = fopen(argv[1], "rb")) == NULL) {
-        printf("%s - Error opening file  %s !!\n", argv[0], argv[1]);
-        exit(0);
-    }
-    printf(" Input speech file    :  %s\n", argv[1]);
+    jobs = (coder_job *)calloc(nJobs, sizeof(coder_job));
+    if ( NULL == jobs ) return -1;
     
-    if ( (f_serial = fopen(argv[2], "wb")) == NULL) {
-        printf("%s - Error opening file  %s !!\n", argv[0], argv[2]);
-        exit(0);
+    for ( nJobs = 0; i + 1 < argc; i += 2, ++nJobs )
+    {
+        jobs[nJobs].speechFile = argv[i];
+        jobs[nJobs].serialFile = argv[i + 1];
+        jobs[nJobs].nThreads   = nJobs == 0 && argc - i == 2 ? nThreads : 1;
+        jobs[nJobs].warmup     = warmup;
+        jobs[nJobs].verbose    = !quiet && argc - i == 2 && nJobs == 0;
+        
+        if ( !quiet )
+        {
+            printf(" Input speech file    :  %s\n", jobs[nJobs].speechFile);
+            printf(" Output bitstream file:  %s\n", jobs[nJobs].serialFile);
+        }
     }
-    printf(" Output bitstream file:  %s\n", argv[2]);
     
     /*--------------------------------------------------------------------------*
-     * Initialization of the coder.                                             *
+     * Code each file; several files are spread over the threads                *
      *--------------------------------------------------------------------------*/
     
-    state = malloc(G729A_Encoder_Get_Size());
-    if ( NULL == state ) return -1;
+    start = cli_Time();
+    cli_Run_Jobs(encode_job, jobs, sizeof(coder_job), nJobs, nThreads);
     
-    G729A_Encoder_Init(state);
-    
-    /* Loop for each "L_FRAME" speech data. */
-    
-    frame =0;
-    while( fread(speechIn, sizeof(G729_Word16), FRAMESIZE, f_speech) == FRAMESIZE)
+    for ( i = 0; i < nJobs; ++i )
     {
-        printf("Frame =%d\r", frame++);
+        if ( jobs[i].error != 0 ) error = 1;
+        frames += jobs[i].frames;
         
-#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
-        G729A_Encoder_Process_Testing(state, speechIn, serial);
-        fwrite(serial, sizeof(G729_Word16), SERIALSIZE, f_serial);
-#else
-        G729A_Encoder_Process(state, speechIn, serial);
-        fwrite(serial, sizeof(G729_UWord8), SERIALSIZE, f_serial);
-#endif
+        if ( stats )
+        {
+            printf(" %s: %lld frames, %.3f s, %.1f x real time\n", jobs[i].speechFile,
+                   (long long)jobs[i].frames, jobs[i].seconds,
+                   jobs[i].seconds > 0 ? jobs[i].frames * 0.01 / jobs[i].seconds : 0.0);
+        }
     }
     
-    printf("Frame =%d\n", frame);
-    return (0);
+    if ( stats && nJobs > 1 )
+    {
+        double seconds = cli_Time() - start;
+        printf(" Total: %lld frames, %.3f s, %.1f x real time on %d threads\n",
+               (long long)frames, seconds, seconds > 0 ? frames * 0.01 / seconds : 0.0, nThreads);
+    }
+    
+    free(jobs);
+    return error;
 }
-
@@ -42,6 +42,7 @@
 #include "g729a_typedef.h"
 #include "basic_op.h"
 #include "ld8a.h"
+#include "simd_func.h"
 
 /*---------------------------------------------------------------------------*
  * Function g729_Corr_xy2()                                                       *
@@ -74,9 +75,7 @@ void g729_Corr_xy2(
          scaled_y2[i] = g729_shr(y2[i], 3);        }
 
       /* Compute scalar product <y2[],y2[]> */
-      L_acc = 1;                       /* Avoid case of all zeros */
-      for(i=0; i<L_SUBFR; i++)
-         L_acc = g729_L_mac(L_acc, scaled_y2[i], scaled_y2[i]);    /* L_acc:Q19 */
+      L_acc = g729_Dot_mac(1, scaled_y2, scaled_y2, L_SUBFR, 0);   /* Avoid case of all zeros, L_acc:Q19 */
 
       exp      = g729_norm_l(L_acc);
       y2y2     = g729_round( g729_L_shl(L_acc, exp) );
@@ -86,9 +85,7 @@ void g729_Corr_xy2(
       exp_g_coeff[2] = exp_y2y2;
 
       /* Compute scalar product <xn[],y2[]> */
-      L_acc = 1;                       /* Avoid case of all zeros */
-      for(i=0; i<L_SUBFR; i++)
-         L_acc = g729_L_mac(L_acc, xn[i], scaled_y2[i]);           /* L_acc:Q10 */
+      L_acc = g729_Dot_mac(1, xn, scaled_y2, L_SUBFR, 0);   /* Avoid case of all zeros, L_acc:Q10 */
 
       exp      = g729_norm_l(L_acc);
       xny2     = g729_round( g729_L_shl(L_acc, exp) );
@@ -98,9 +95,7 @@ void g729_Corr_xy2(
       exp_g_coeff[3] = g729_sub(exp_xny2,1);                   /* -2<xn,y2> */
 
       /* Compute scalar product <y1[],y2[]> */
-      L_acc = 1;                       /* Avoid case of all zeros */
-      for(i=0; i<L_SUBFR; i++)
-         L_acc = g729_L_mac(L_acc, y1[i], scaled_y2[i]);           /* L_acc:Q10 */
+      L_acc = g729_Dot_mac(1, y1, scaled_y2, L_SUBFR, 0);   /* Avoid case of all zeros, L_acc:Q10 */
 
       exp      = g729_norm_l(L_acc);
       y1y2     = g729_round( g729_L_shl(L_acc, exp) );
@@ -136,9 +131,7 @@ void g729_Cor_h_X(
 
    for (i = 0; i < L_SUBFR; i++)
    {
-     s = 0;
-     for (j = i; j <  L_SUBFR; j++)
-       s = g729_L_mac(s, X[j], h[j-i]);
+     s = g729_Dot_mac(0, &X[i], h, (G729_Word16)(L_SUBFR-i), 0);
 
      y32[i] = s;
 
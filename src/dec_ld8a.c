@@ -64,10 +64,12 @@
 
 #include "g729a_typedef.h"
 #include "basic_op.h"
+#include "oper_32b.h"
 #include "ld8a.h"
 
 #include "g729a_errors.h"
 #include "g729a_decoder.h"
+#include "stage_stats.h"
 
 /*---------------------------------------------------------------*
  *   Decoder constant parameters (defined in "ld8a.h")           *
@@ -102,9 +104,6 @@ void g729_Init_Decod_ld8a(g729a_decoder_state * state)
     
     state->error = G729A_NO_ERROR;
     
-    /* Initialize static pointer */
-    state->exc = state->old_exc + PIT_MAX + L_INTERPOL;
-    
     /* Static vectors to zero */
     g729_Set_zero(state->old_exc, PIT_MAX+L_INTERPOL);
     g729_Set_zero(state->mem_syn, M);
@@ -116,10 +115,100 @@ void g729_Init_Decod_ld8a(g729a_decoder_state * state)
     state->old_T0 = 60;
     state->gain_code = 0;
     state->gain_pitch = 0;
+    state->bad_lsf = 0;
+    state->seed = 21845;
     
     for ( i = 0; i < 4; ++i ) state->past_qua_en[i] = -14336;
     
     g729_Lsp_decw_reset(&(state->lspdec_state));
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+    g729_Init_Dec_cng(state);
+#endif
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Dec_pitch: pitch lag of a subframe, or the lag of the previous  *
+ *   frame incremented when the lag is bad.                          *
+ *-----------------------------------------------------------------*/
+
+static void Dec_pitch(
+    g729a_decoder_state * state,
+    G729_Word16  index,       /* (i)   : pitch index                          */
+    G729_Word16  bad_pitch,   /* (i)   : bad pitch indicator                  */
+    G729_Word16  i_subfr,     /* (i)   : subframe flag                        */
+    G729_Word16  *T0,         /* (o)   : integer pitch lag                    */
+    G729_Word16  *T0_frac     /* (o)   : fraction of the lag                  */
+)
+{
+    if( bad_pitch == 0)
+    {
+        g729_Dec_lag3(index, PIT_MIN, PIT_MAX, i_subfr, T0, T0_frac);
+        state->old_T0 = *T0;
+    }
+    else        /* Bad frame, or parity error */
+    {
+        *T0  =  state->old_T0;
+        *T0_frac = 0;
+        state->old_T0 = g729_add( state->old_T0, 1);
+        if( g729_sub(state->old_T0, PIT_MAX) > 0) {
+            state->old_T0 = PIT_MAX;
+        }
+    }
+    
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Dec_code_gains: innovative codevector with the pitch          *
+ *   sharpening, pitch and codebook gains of a subframe, and the   *
+ *   update of the sharpening.                                     *
+ *-----------------------------------------------------------------*/
+
+static void Dec_code_gains(
+    g729a_decoder_state * state,
+    G729_Word16  parm[],      /* (i/o) : codebook indexes and index of energy VQ */
+    G729_Word16  T0,          /* (i)   : integer pitch lag                    */
+    G729_Word16  bfi,         /* (i)   : bad frame indicator                  */
+    G729_Word16  code[]       /* (o)   : ACELP codevector                     */
+)
+{
+    G729_Word16  i, j;
+    
+    /*-------------------------------------------------------*
+     * - Decode innovative codebook.                         *
+     * - Add the fixed-gain pitch contribution to code[].    *
+     *-------------------------------------------------------*/
+    
+    if(bfi != 0)        /* Bad frame */
+    {
+        
+        parm[0] = g729_Random(&(state->seed)) & (G729_Word16)0x1fff;     /* 13 bits random */
+        parm[1] = g729_Random(&(state->seed)) & (G729_Word16)0x000f;     /*  4 bits random */
+    }
+    g729_Decod_ACELP(parm[1], parm[0], code);
+    
+    j = g729_shl(state->sharp, 1);          /* From Q14 to Q15 */
+    if(g729_sub(T0, L_SUBFR) <0 ) {
+        for (i = T0; i < L_SUBFR; i++) {
+            code[i] = g729_add(code[i], g729_mult(code[i-T0], j));
+        }
+    }
+    
+    /*-------------------------------------------------*
+     * - Decode pitch and codebook gains.              *
+     *-------------------------------------------------*/
+    
+    g729_Dec_gain(state, parm[2], code, L_SUBFR, bfi, &(state->gain_pitch), &(state->gain_code));
+    
+    /*-------------------------------------------------------------*
+     * - Update pitch sharpening "sharp" with quantized gain_pitch *
+     *-------------------------------------------------------------*/
+    
+    state->sharp = state->gain_pitch;
+    if (g729_sub(state->sharp, SHARPMAX) > 0) { state->sharp = SHARPMAX;  }
+    if (g729_sub(state->sharp, SHARPMIN) < 0) { state->sharp = SHARPMIN;  }
+    
     return;
 }
 
@@ -146,12 +235,15 @@ void g729_Decod_ld8a(
     
     /* Scalars */
     
-    G729_Word16  i, j, i_subfr;
+    G729_Word16  i, i_subfr;
     G729_Word16  T0, T0_frac, index;
     G729_Word16  bfi;
     G729_Word32  L_temp;
     
     G729_Word16 bad_pitch;             /* bad pitch indicator */
+    G729_STATS_DECL
+    
+    G729_STATS_START;
     
     /* Test bad frame indicator (bfi) */
     
@@ -175,6 +267,8 @@ void g729_Decod_ld8a(
     
     g729_Copy(lsp_new, state->lsp_old, M);
     
+    G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_LSP);
+    
     /*------------------------------------------------------------------------*
      *          Loop for every subframe in the analysis frame                 *
      *------------------------------------------------------------------------*
@@ -197,82 +291,27 @@ void g729_Decod_ld8a(
         {
             i = *parm++;              /* get parity check result */
             bad_pitch = g729_add(bfi, i);
-            if( bad_pitch == 0)
-            {
-                g729_Dec_lag3(index, PIT_MIN, PIT_MAX, i_subfr, &T0, &T0_frac);
-                state->old_T0 = T0;
-            }
-            else        /* Bad frame, or parity error */
-            {
-                T0  =  state->old_T0;
-                T0_frac = 0;
-                state->old_T0 = g729_add( state->old_T0, 1);
-                if( g729_sub(state->old_T0, PIT_MAX) > 0) {
-                    state->old_T0 = PIT_MAX;
-                }
-            }
         }
         else                  /* second subframe */
         {
-            if( bfi == 0)
-            {
-                g729_Dec_lag3(index, PIT_MIN, PIT_MAX, i_subfr, &T0, &T0_frac);
-                state->old_T0 = T0;
-            }
-            else
-            {
-                T0  =  state->old_T0;
-                T0_frac = 0;
-                state->old_T0 = g729_add( state->old_T0, 1);
-                if( g729_sub(state->old_T0, PIT_MAX) > 0) {
-                    state->old_T0 = PIT_MAX;
-                }
-            }
+            bad_pitch = bfi;
         }
+        Dec_pitch(state, index, bad_pitch, i_subfr, &T0, &T0_frac);
         *T2++ = T0;
         
         /*-------------------------------------------------*
          * - Find the adaptive codebook vector.            *
          *-------------------------------------------------*/
         
-        g729_Pred_lt_3(&(state->exc[i_subfr]), T0, T0_frac, L_SUBFR);
-        
-        /*-------------------------------------------------------*
-         * - Decode innovative codebook.                         *
-         * - Add the fixed-gain pitch contribution to code[].    *
-         *-------------------------------------------------------*/
-        
-        if(bfi != 0)        /* Bad frame */
-        {
-            
-            parm[0] = g729_Random() & (G729_Word16)0x1fff;     /* 13 bits random */
-            parm[1] = g729_Random() & (G729_Word16)0x000f;     /*  4 bits random */
-        }
-        g729_Decod_ACELP(parm[1], parm[0], code);
-        parm +=2;
-        
-        j = g729_shl(state->sharp, 1);          /* From Q14 to Q15 */
-        if(g729_sub(T0, L_SUBFR) <0 ) {
-            for (i = T0; i < L_SUBFR; i++) {
-                code[i] = g729_add(code[i], g729_mult(code[i-T0], j));
-            }
-        }
+        g729_Pred_lt_3(&G729_DEC_EXC(state)[i_subfr], T0, T0_frac, L_SUBFR);
         
         /*-------------------------------------------------*
-         * - Decode pitch and codebook gains.              *
+         * - Decode innovative codebook, pitch and         *
+         *   codebook gains.                               *
          *-------------------------------------------------*/
         
-        index = *parm++;      /* index of energy VQ */
-        
-        g729_Dec_gain(state, index, code, L_SUBFR, bfi, &(state->gain_pitch), &(state->gain_code));
-        
-        /*-------------------------------------------------------------*
-         * - Update pitch sharpening "sharp" with quantized gain_pitch *
-         *-------------------------------------------------------------*/
-        
-        state->sharp = state->gain_pitch;
-        if (g729_sub(state->sharp, SHARPMAX) > 0) { state->sharp = SHARPMAX;  }
-        if (g729_sub(state->sharp, SHARPMIN) < 0) { state->sharp = SHARPMIN;  }
+        Dec_code_gains(state, parm, T0, bfi, code);
+        parm += 3;
         
         /*-------------------------------------------------------*
          * - Find the total excitation.                          *
@@ -285,31 +324,39 @@ void g729_Decod_ld8a(
             /* exc[i]  in Q0   gain_pitch in Q14               */
             /* code[i] in Q13  gain_codeode in Q1              */
             
-            L_temp = g729_L_mult(state->exc[i+i_subfr], state->gain_pitch);
+            L_temp = g729_L_mult(G729_DEC_EXC(state)[i+i_subfr], state->gain_pitch);
             L_temp = g729_L_mac(L_temp, code[i], state->gain_code);
             L_temp = g729_L_shl(L_temp, 1);
-            state->exc[i+i_subfr] = g729_round(L_temp);
+            G729_DEC_EXC(state)[i+i_subfr] = g729_round(L_temp);
         }
         
+        G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_EXCITATION);
+        
 #if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
         G729A_Overflow_Flag = 0;
-        g729_Syn_filt(Az, &(state->exc[i_subfr]), &synth[i_subfr], L_SUBFR, state->mem_syn, 0);
+        g729_Syn_filt(Az, &G729_DEC_EXC(state)[i_subfr], &synth[i_subfr], L_SUBFR, state->mem_syn, 0);
         if(G729A_Overflow_Flag != 0)
 #else
-        if (g729_Syn_filt_Overflow(Az, &(state->exc[i_subfr]), &synth[i_subfr], L_SUBFR, state->mem_syn))
+        if (g729_Syn_filt_Overflow(Az, &G729_DEC_EXC(state)[i_subfr], &synth[i_subfr], L_SUBFR, state->mem_syn))
 #endif
         {
             /* In case of overflow in the synthesis          */
             /* -> Scale down vector exc[] and redo synthesis */
             
+            G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_SYNTHESIS);
+            
             for(i=0; i<PIT_MAX+L_INTERPOL+L_FRAME; i++)
                 state->old_exc[i] = g729_shr(state->old_exc[i], 2);
             
-            g729_Syn_filt(Az, &(state->exc[i_subfr]), &synth[i_subfr], L_SUBFR, state->mem_syn, 1);
+            g729_Syn_filt(Az, &G729_DEC_EXC(state)[i_subfr], &synth[i_subfr], L_SUBFR, state->mem_syn, 1);
+            
+            G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_OVERFLOW);
         }
         else
         {
             g729_Copy(&synth[i_subfr+L_SUBFR-M], state->mem_syn, M);
+            
+            G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_SYNTHESIS);
         }
         
         Az += MP1;    /* interpolated LPC parameters for next subframe */
@@ -322,6 +369,108 @@ void g729_Decod_ld8a(
     
     g729_Copy(&(state->old_exc[L_FRAME]), &(state->old_exc[0]), PIT_MAX+L_INTERPOL);
     
+    state->past_ftyp = FRAME_SPEECH;
+    
     return;
 }
 
+/*-----------------------------------------------------------------*
+ *   Ener_code: energy of the codebook contribution gain_cod*code  *
+ *   of a subframe, in dB                                          *
+ *                                                                 *
+ *   = 20 log10(gain_cod/2) + 10 log10(ener_code/2^27/L_SUBFR)     *
+ *   = 3.0103 * (2 Log2(gain_cod) + Log2(ener_code) - 34.3219)     *
+ *     with ener_code in Q27, gain_cod in Q1                       *
+ *-----------------------------------------------------------------*/
+
+static G729_Word16 Ener_code(  /* (o) Q8 : energy in dB, MIN_16 if gain_cod <= 0 */
+    G729_Word16  code[],      /* (i) Q13 : ACELP codevector                 */
+    G729_Word16  gain_cod     /* (i) Q1  : codebook gain                    */
+)
+{
+    G729_Word16  i, exp, frac, hi, lo;
+    G729_Word32  L_tmp, L_log;
+    
+    if (gain_cod <= 0)
+    {
+        return G729A_MIN_16;
+    }
+    
+    g729_Log2(g729_L_deposit_l(gain_cod), &exp, &frac);
+    L_log = g729_L_shl(g729_L_mac(g729_L_deposit_l(frac), exp, 16384), 1);  /* Q15 */
+    
+    L_tmp = 0;
+    for(i=0; i<L_SUBFR; i++)
+        L_tmp = g729_L_mac(L_tmp, code[i], code[i]);
+    
+    g729_Log2(L_tmp, &exp, &frac);
+    L_log = g729_L_add(L_log, g729_L_mac(g729_L_deposit_l(frac), exp, 16384));
+    L_log = g729_L_sub(L_log, 1124661L);                  /* 34.3219 in Q15   */
+    
+    g729_L_Extract(L_log, &hi, &lo);
+    L_tmp = g729_Mpy_32_16(hi, lo, 24660);                 /* 3.0103 in Q13    */
+    
+    return g729_extract_l(g729_L_shr(L_tmp, 5));           /* Q13 -> Q8        */
+}
+
+/*-----------------------------------------------------------------*
+ *   Function g729_Decod_ld8a_params                               *
+ *            ~~~~~~~~~~~~~~~~~~~~~~                               *
+ *   ->Parameter part of g729_Decod_ld8a(): the LSPs, pitch lags   *
+ *     and gains of a frame, exactly as the full decoder gets      *
+ *     them, without the excitation, the synthesis and the         *
+ *     postfilter. The synthesis memories of the state are not     *
+ *     updated.                                                    *
+ *-----------------------------------------------------------------*/
+
+void g729_Decod_ld8a_params(
+    g729a_decoder_state * state,
+    G729_Word16  parm[],      /* (i)   : vector of synthesis parameters
+                                         parm[0] = bad frame indicator (bfi)  */
+    G729_Word16  lsp_new[],   /* (o)   : decoded LSPs                         */
+    G729_Word16  T[],         /* (o)   : integer pitch lag in 2 subframes     */
+    G729_Word16  T_frac[],    /* (o)   : fraction of the lag in 2 subframes   */
+    G729_Word16  gain_pit[],  /* (o) Q14 : pitch gain in 2 subframes          */
+    G729_Word16  gain_cod[],  /* (o) Q1  : codebook gain in 2 subframes       */
+    G729_Word16  ener[]       /* (o) Q8  : energy of the codebook contribution */
+                              /*           in dB in 2 subframes               */
+)
+{
+    G729_Word16  code[L_SUBFR];        /* ACELP codevector */
+    G729_Word16  i, i_subfr, index;
+    G729_Word16  T0, T0_frac;
+    G729_Word16  bfi, bad_pitch;
+    
+    bfi = *parm++;
+    
+    g729_D_lsp(&(state->lspdec_state), parm, lsp_new, g729_add(bfi, state->bad_lsf));
+    parm += 2;
+    g729_Copy(lsp_new, state->lsp_old, M);
+    
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        index = *parm++;            /* pitch index */
+        
+        if(i_subfr == 0)
+        {
+            i = *parm++;              /* get parity check result */
+            bad_pitch = g729_add(bfi, i);
+        }
+        else
+        {
+            bad_pitch = bfi;
+        }
+        Dec_pitch(state, index, bad_pitch, i_subfr, &T0, &T0_frac);
+        *T++ = T0;
+        *T_frac++ = T0_frac;
+        
+        Dec_code_gains(state, parm, T0, bfi, code);
+        parm += 3;
+        
+        *gain_pit++ = state->gain_pitch;
+        *gain_cod++ = state->gain_code;
+        *ener++ = Ener_code(code, state->gain_code);
+    }
+    
+    return;
+}
@@ -0,0 +1,114 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Comfort noise generation of the decoder, for the private SID      *
+ * frames of dtx.c (not G.729 Annex B).                              *
+ *                                                                   *
+ * A SID frame carries the LSPs, decoded with the MA predictor of    *
+ * the speech frames, and the energy index of the noise. Until the   *
+ * next SID, every frame that is not transmitted is synthesized      *
+ * from the random excitation of g729_Calc_exc_rand() through the    *
+ * LP filter of the SID, interpolated from the previous frame. The   *
+ * decoder state is left as the encoder leaves its own after an      *
+ * inactive frame (g729_Cod_cng), ready for the next speech frame.   *
+ *-------------------------------------------------------------------*/
+
+#include <stdlib.h>
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+#include "tab_ld8a.h"
+
+#include "g729a_decoder.h"
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+void g729_Init_Dec_cng(g729a_decoder_state * state)
+{
+    state->past_ftyp = FRAME_SPEECH;
+    state->sid_gain  = 0;
+    state->cur_gain  = 0;
+    state->cng_seed  = INIT_SEED;
+    g729_Copy(state->lsp_old, state->sid_lsp, M);
+}
+
+/*-------------------------------------------------------------------*
+ * g729_Decod_cng: decoding of a SID frame or of a frame not         *
+ * transmitted.                                                      *
+ *-------------------------------------------------------------------*/
+
+void g729_Decod_cng(
+    g729a_decoder_state * state,
+    G729_Word16  parm[],      /* (i)   : SID parameters, NULL if no frame     */
+    G729_Word16  synth[],     /* (o)   : synthesis speech                     */
+    G729_Word16  A_t[],       /* (o)   : LP filter in 2 subframes             */
+    G729_Word16  *T2          /* (o)   : pitch lag in 2 subframes             */
+)
+{
+    G729_Word16 *Az;
+    G729_Word16 i, i_subfr;
+    
+    if (parm != NULL)
+    {
+        g729_D_lsp(&(state->lspdec_state), parm, state->sid_lsp, 0);
+        state->sid_gain = g729_sid_gain[parm[2]];
+        
+        if (state->past_ftyp == FRAME_SPEECH) {
+            state->cur_gain = state->sid_gain;
+        }
+    }
+    
+    g729_Int_qlpc(state->lsp_old, state->sid_lsp, A_t);
+    g729_Copy(state->sid_lsp, state->lsp_old, M);
+    
+    g729_Calc_exc_rand(&(state->cur_gain), state->sid_gain, G729_DEC_EXC(state), &(state->cng_seed));
+    
+    Az = A_t;
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        g729_Syn_filt(Az, &G729_DEC_EXC(state)[i_subfr], &synth[i_subfr], L_SUBFR, state->mem_syn, 1);
+        *T2++ = state->old_T0;
+        Az += MP1;
+    }
+    
+    /* Reset the gain predictor and the pitch sharpening as the encoder */
+    
+    for (i = 0; i < 4; i++) state->past_qua_en[i] = -14336;
+    state->sharp      = SHARPMIN;
+    state->gain_code  = 0;
+    state->gain_pitch = 0;
+    state->past_ftyp  = FRAME_SID;
+    
+    /* Update the excitation for the next frame */
+    
+    g729_Copy(&(state->old_exc[L_FRAME]), &(state->old_exc[0]), PIT_MAX+L_INTERPOL);
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+/* end of file */
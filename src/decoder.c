@@ -40,24 +40,31 @@
 /*-----------------------------------------------------------------*
  * Main program of the G.729a 8.0 kbit/s decoder.                  *
  *                                                                 *
- *    Usage : decoder  bitstream_file  synth_file                  *
- *                                                                 *
+ *    Usage : decoder [-q] [-s] [-t threads] [-p mode]             *
+ *                    bitstream_file  synth_file                   *
+ *                    [bitstream_file  synth_file ...]             *
  *-----------------------------------------------------------------*/
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "g729a_typedef.h"
 #include "g729a_interface.h"
+#include "cli_util.h"
 
 #define FRAMESIZE      80
 
 #if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
 #define SERIALSIZE     (80+2)
+typedef G729_Word16    serial_word;
 #else
 #define SERIALSIZE     10
+typedef G729_UWord8    serial_word;
 #endif
 
+#define BLOCKFRAMES    1000     /* Frames decoded between progress reports */
+
 /*
  This variable should be always set to zero unless transmission errors
  in LSP indices are detected.
@@ -68,38 +75,154 @@
  (The flags should be set back to 0 for correct transmission).
  */
 
+typedef struct _decoder_job
+{
+    const char *serialFile;
+    const char *synthFile;
+    int verbose;                /* Print the frame counter                 */
+    int pstMode;                /* G729A_POSTFILTER_* output mode          */
+    G729_Word64 frames;         /* Frames decoded                          */
+    double seconds;             /* Wall time of the job                    */
+    int error;
+} decoder_job;
+
 /*-----------------------------------------------------------------*
- *            Main decoder routine                                 *
+ *   Decodes one bitstream file, mapped in memory, into a mapped   *
+ *   synthesis file                                                *
  *-----------------------------------------------------------------*/
-
-int main(int argc, char *argv[] )
+static void decode_job(void *arg)
 {
+    decoder_job *job = (decoder_job *)arg;
+    cli_map in, out;
+    serial_word *serial;
+    G729_Word16 *speech;
+    G729_Word64 nFrames, frame, k;
+#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
+    G729_Word64 i;
+#endif
+    G729A_Dec_state state;
+    double start = cli_Time();
+    
+    job->error = -1;
+    
+    if ( cli_Map_Read(&in, job->serialFile) != 0 )
+    {
+        printf("decoder - Error opening file  %s !!\n", job->serialFile);
+        cli_Unmap(&in);
+        return;
+    }
+    
+    /* A partial last frame is dropped */
+    
+    nFrames = (G729_Word64)(in.size / (SERIALSIZE * sizeof(serial_word)));
+    if ( cli_Map_Write(&out, job->synthFile, (size_t)nFrames * FRAMESIZE * sizeof(G729_Word16)) != 0 )
+    {
+        printf("decoder - Error opening file  %s !!\n", job->synthFile);
+        cli_Unmap(&in);
+        cli_Unmap(&out);
+        return;
+    }
+    
+    serial = (serial_word *)in.data;
+    speech = (G729_Word16 *)out.data;
+    state  = malloc(G729A_Decoder_Get_Size());
+    
+    frame  = 0;
+    
+    if ( NULL != state && G729A_Decoder_Init(state) == 0 && G729A_Decoder_Set_Postfilter(state, job->pstMode) == 0 )
+    {
+        for ( ; frame < nFrames; frame += k )
+        {
+            k = nFrames - frame;
+            if ( k > BLOCKFRAMES ) k = BLOCKFRAMES;
+            
 #if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
-    G729_Word16
+            for ( i = frame; i < frame + k; ++i )
+            {
+                G729A_Decoder_Process_Testing(state, &serial[i * SERIALSIZE], &speech[i * FRAMESIZE]);
+            }
 #else
-    G729_UWord8
+            if ( G729A_Decoder_Process_Frames(state, &serial[frame * SERIALSIZE], (G729_Word32)k, NULL, &speech[frame * FRAMESIZE]) != 0 ) break;
 #endif
-    serial[SERIALSIZE];
-    G729_Word16  speechOut[FRAMESIZE];
+            
+            if ( job->verbose )
+            {
+                printf("Frame =%lld\r", (long long)(frame + k));
+                fflush(stdout);
+            }
+        }
+        
+        if ( frame == nFrames ) job->error = 0;
+    }
     
-    G729_Word16 frame;
-    FILE   *f_syn, *f_serial;
+    if ( job->verbose )
+    {
+        printf("Frame =%lld\n", (long long)frame);
+    }
     
-    G729A_Dec_state state;
+    free(state);
+    cli_Unmap(&in);
+    if ( cli_Unmap(&out) != 0 ) job->error = -1;
     
-    printf("\n");
-    printf("************   G.729a 8.0 KBIT/S SPEECH DECODER  ************\n");
-    printf("\n");
-    printf("------------------- Fixed point C simulation ----------------\n");
-    printf("\n");
-    printf("------------ Version 1.1 (Release 2, November 2006) --------\n");
-    printf("\n");
+    if ( job->error != 0 )
+    {
+        printf("decoder - Error decoding file  %s !!\n", job->serialFile);
+    }
+    
+    job->frames  = frame;
+    job->seconds = cli_Time() - start;
+}
+
+/*-----------------------------------------------------------------*
+ *            Main decoder routine                                 *
+ *-----------------------------------------------------------------*/
+
+int main(int argc, char *argv[] )
+{
+    decoder_job *jobs;
+    G729_Word64 frames = 0;
+    double start;
+    int nJobs, i, error = 0;
+    
+    int quiet = 0;                      /* -q: no banner nor frame counter */
+    int stats = 0;                      /* -s: print the decoding speed    */
+    int nThreads = 1;                   /* -t: threads                     */
+    int pstMode = G729A_POSTFILTER_ON;  /* -p: output mode                 */
     
     /* Passed arguments */
     
-    if ( argc != 3)
+    for ( i = 1; i < argc && argv[i][0] == '-'; ++i )
+    {
+        if ( strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0 ) quiet = 1;
+        else if ( strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--stats") == 0 ) stats = 1;
+        else if ( strcmp(argv[i], "-t") == 0 && i + 1 < argc ) nThreads = atoi(argv[++i]);
+        else if ( strcmp(argv[i], "-p") == 0 && i + 1 < argc ) pstMode = atoi(argv[++i]);
+        else break;
+    }
+    
+    nJobs = (argc - i) / 2;
+    
+    if ( !quiet )
+    {
+        printf("\n");
+        printf("************   G.729a 8.0 KBIT/S SPEECH DECODER  ************\n");
+        printf("\n");
+        printf("------------------- Fixed point C simulation ----------------\n");
+        printf("\n");
+        printf("------------ Version 1.1 (Release 2, November 2006) --------\n");
+        printf("\n");
+    }
+    
+    if ( nJobs < 1 || (argc - i) % 2 != 0 || nThreads < 1 )
     {
-        printf("Usage :%s bitstream_file  outputspeech_file\n",argv[0]);
+        printf("Usage :%s [-q] [-s] [-t threads] [-p mode]\n", argv[0]);
+        printf("          bitstream_file  outputspeech_file  [bitstream_file  outputspeech_file ...]\n");
+        printf("\n");
+        printf("  -q, --quiet : print nothing but errors and statistics\n");
+        printf("  -s, --stats : print the frames, time and speed of each file\n");
+        printf("  -t threads  : decode several files on this many threads\n");
+        printf("  -p mode     : 0 postfilter (default), 1 high-pass filter only,\n");
+        printf("                2 raw synthesis, for machine consumers\n");
         printf("\n");
         printf("Format for bitstream_file:\n");
         printf("  One (2-byte) synchronization word \n");
@@ -111,55 +234,50 @@ int main(int argc, char *argv[] )
         exit( 1 );
     }
     
-    /* Open file for synthesis and packed serial stream */
-    
-    if( (f_serial = fopen(argv[1],"rb") ) == NULL )
-    {
-        printf("%s - Error opening file  %s !!\n", argv[0], argv[1]);
-        exit(0);
-    }
+    jobs = (decoder_job *)calloc(nJobs, sizeof(decoder_job));
+    if ( NULL == jobs ) return -1;
     
-    if( (f_syn = fopen(argv[2], "wb") ) == NULL )
+    for ( nJobs = 0; i + 1 < argc; i += 2, ++nJobs )
     {
-        printf("%s - Error opening file  %s !!\n", argv[0], argv[2]);
-        exit(0);
+        jobs[nJobs].serialFile = argv[i];
+        jobs[nJobs].synthFile  = argv[i + 1];
+        jobs[nJobs].verbose    = !quiet && argc - i == 2 && nJobs == 0;
+        jobs[nJobs].pstMode    = pstMode;
+        
+        if ( !quiet )
+        {
+            printf("Input bitstream file  :   %s\n", jobs[nJobs].serialFile);
+            printf("Synthesis speech file :   %s\n", jobs[nJobs].synthFile);
+        }
     }
     
-    printf("Input bitstream file  :   %s\n",argv[1]);
-    printf("Synthesis speech file :   %s\n",argv[2]);
-    
     /*-----------------------------------------------------------------*
-     *           Initialization of decoder                             *
+     *     Decode each file; several files are spread over threads     *
      *-----------------------------------------------------------------*/
     
-    state = malloc(G729A_Decoder_Get_Size());
-    if ( NULL == state ) return -1;
-    
-    G729A_Decoder_Init(state);
+    start = cli_Time();
+    cli_Run_Jobs(decode_job, jobs, sizeof(decoder_job), nJobs, nThreads);
     
-    /*-----------------------------------------------------------------*
-     *            Loop for each "L_FRAME" speech data                  *
-     *-----------------------------------------------------------------*/
-    
-    frame = 0;
-    
-#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
-    while( fread(serial, sizeof(G729_Word16), SERIALSIZE, f_serial) == SERIALSIZE)
-#else
-    while( fread(serial, sizeof(G729_UWord8), SERIALSIZE, f_serial) == SERIALSIZE)
-#endif
+    for ( i = 0; i < nJobs; ++i )
     {
-        printf("Frame =%d\r", frame++);
+        if ( jobs[i].error != 0 ) error = 1;
+        frames += jobs[i].frames;
         
-#if defined(CONTROL_OPT_ITU) && (CONTROL_OPT_ITU == 1)
-        G729A_Decoder_Process_Testing(state, serial, speechOut);
-#else
-        G729A_Decoder_Process(state, serial, speechOut);
-#endif
-        fwrite(speechOut, sizeof(G729_Word16), FRAMESIZE, f_syn);
+        if ( stats )
+        {
+            printf(" %s: %lld frames, %.3f s, %.1f x real time\n", jobs[i].serialFile,
+                   (long long)jobs[i].frames, jobs[i].seconds,
+                   jobs[i].seconds > 0 ? jobs[i].frames * 0.01 / jobs[i].seconds : 0.0);
+        }
     }
     
-    printf("Frame =%d\n", frame);
-    return(0);
+    if ( stats && nJobs > 1 )
+    {
+        double seconds = cli_Time() - start;
+        printf(" Total: %lld frames, %.3f s, %.1f x real time on %d threads\n",
+               (long long)frames, seconds, seconds > 0 ? frames * 0.01 / seconds : 0.0, nThreads);
+    }
+    
+    free(jobs);
+    return(error);
 }
-
@@ -0,0 +1,219 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Private discontinuous transmission of the encoder. The SID frame  *
+ * (3 bytes, see g729_prm2bits_sid) is specific to this library and  *
+ * does not interoperate with G.729 Annex B.                         *
+ *                                                                   *
+ * On inactive frames, the encoder keeps a running mean of the LSPs  *
+ * and of the energy of the LP residual. It sends a SID frame with   *
+ * them on the first inactive frame, and afterwards when the mean    *
+ * energy moves by 2 steps of the quantizer or the mean LSPs move by *
+ * SID_LSP_DIST, at most every SID_MIN frames. The LSPs of the SID   *
+ * go through the quantizer of the speech frames, so that its MA     *
+ * predictor stays in step with the one of the decoder.              *
+ *                                                                   *
+ * An inactive frame costs the LP analysis, the VAD, the residual    *
+ * energy and the weighting filters. The encoder takes the comfort   *
+ * noise of the decoder as excitation, as it would the excitation of *
+ * a coded frame, and resets the gain predictor and the taming like  *
+ * the decoder.                                                      *
+ *-------------------------------------------------------------------*/
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+#include "tab_ld8a.h"
+
+#include "g729a_encoder.h"
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+#define SID_MIN         3           /* frames between two SID frames                       */
+#define SID_LSP_DIST    16000000L   /* distance of g729_Lsp_dist() of a new SID            */
+#define SID_ENER_MIN    (-8*256)    /* Q8: energy of index 0                               */
+#define SID_ENER_STEP   320         /* Q8: 1.25 dB step of the energy quantizer            */
+
+void g729_Init_Cod_cng(g729a_dtx_state * state)
+{
+    state->past_vad  = 1;
+    state->count     = 0;
+    state->ener_mean = 0;
+    state->sid_index = 0;
+    state->sid_gain  = 0;
+    state->cur_gain  = 0;
+    state->seed      = INIT_SEED;
+    g729_Set_zero(state->lsp_mean, M);
+    g729_Set_zero(state->sid_lsp, M);
+}
+
+/*-------------------------------------------------------------------*
+ * Sid_index: index of the SID energy quantizer, 0..NB_SID_ENER-1.   *
+ *-------------------------------------------------------------------*/
+
+static G729_Word16 Sid_index(
+    G729_Word16 ener            /* (i) Q8 : energy in dB */
+)
+{
+    G729_Word16 x;
+    
+    x = g729_add(g729_sub(ener, SID_ENER_MIN), SID_ENER_STEP/2);
+    if (x <= 0) {
+        return 0;
+    }
+    
+    x = g729_extract_l(g729_L_shr(g729_L_mult(x, 6554), 22));   /* x / 320 */
+    if (g729_sub(x, NB_SID_ENER - 1) > 0) {
+        x = NB_SID_ENER - 1;
+    }
+    
+    return x;
+}
+
+/*-------------------------------------------------------------------*
+ * g729_Cod_cng: coding of an inactive frame.                        *
+ *-------------------------------------------------------------------*/
+
+G729_Word16 g729_Cod_cng(        /* (o)     : FRAME_SID or FRAME_NO_TX       */
+    g729a_encoder_state * state,
+    G729_Word16 A[],             /* (i) Q12 : unquantized A(z) of the frame  */
+    G729_Word16 lsp_new[],       /* (i) Q15 : LSPs of the frame              */
+    G729_Word16 ana[]            /* (o)     : SID parameters                 */
+)
+{
+    g729a_dtx_state * dtx = &(state->dtx_state);
+    G729_Word16 res[L_FRAME];           /* LP residual                            */
+    G729_Word16 Aq_t[(MP1)*2];          /* A(z) of the SID for the 2 subframes    */
+    G729_Word16 Ap[MP1], Ap1[MP1];      /* A(z/gamma) and weighting filter        */
+    G729_Word16 xn[L_SUBFR];
+    G729_Word16 *Aq, *speech, *exc;
+    G729_Word16 i, i_subfr, ener, ftyp;
+    
+    /* Energy of the LP residual */
+    
+    g729_Residu(A, G729_ENC_SPEECH(state), res, L_FRAME);
+    ener = g729_Ener_dB(res);
+    
+    if (dtx->past_vad != 0)
+    {
+        /* First inactive frame */
+        
+        g729_Copy(lsp_new, dtx->lsp_mean, M);
+        dtx->ener_mean = ener;
+        ftyp = FRAME_SID;
+    }
+    else
+    {
+        dtx->ener_mean = g729_add(dtx->ener_mean, g729_shr(g729_sub(ener, dtx->ener_mean), 2));
+        for (i = 0; i < M; i++)
+        {
+            dtx->lsp_mean[i] = g729_add(dtx->lsp_mean[i], g729_shr(g729_sub(lsp_new[i], dtx->lsp_mean[i]), 2));
+        }
+        
+        ftyp = FRAME_NO_TX;
+        if (g729_sub(dtx->count, SID_MIN) < 0)
+        {
+            dtx->count = g729_add(dtx->count, 1);
+        }
+        else if (g729_sub(g729_abs_s(g729_sub(Sid_index(dtx->ener_mean), dtx->sid_index)), 2) >= 0 ||
+                 g729_L_sub(g729_Lsp_dist(dtx->lsp_mean, dtx->sid_lsp), SID_LSP_DIST) > 0)
+        {
+            ftyp = FRAME_SID;
+        }
+    }
+    
+    if (ftyp == FRAME_SID)
+    {
+        g729_Qua_lsp(&(state->lspenc_state), dtx->lsp_mean, dtx->sid_lsp, ana);
+        
+        dtx->sid_index = Sid_index(dtx->ener_mean);
+        dtx->sid_gain  = g729_sid_gain[dtx->sid_index];
+        dtx->count     = 1;
+        ana[2] = dtx->sid_index;
+        
+        if (dtx->past_vad != 0) {
+            dtx->cur_gain = dtx->sid_gain;
+        }
+    }
+    dtx->past_vad = 0;
+    
+    /*------------------------------------------------------------*
+     * Same LSPs and excitation as the decoder (g729_Decod_cng)   *
+     *------------------------------------------------------------*/
+    
+    g729_Int_qlpc(state->lsp_old_q, dtx->sid_lsp, Aq_t);
+    g729_Copy(dtx->sid_lsp, state->lsp_old_q, M);
+    g729_Copy(lsp_new, state->lsp_old, M);
+    
+    g729_Calc_exc_rand(&(dtx->cur_gain), dtx->sid_gain, G729_ENC_EXC(state), &(dtx->seed));
+    
+    for (i = 0; i < 4; i++) state->past_qua_en[i] = -14336;
+    state->sharp = SHARPMIN;
+    g729_Init_exc_err(&(state->taming_state));
+    
+    /*------------------------------------------------------------*
+     * Weighted speech and weighting filter memories, as a coded  *
+     * frame leaves them, so that the pitch search and the target *
+     * of the next speech frame carry on from this one:           *
+     *  - wsp[] and mem_w: speech through A(z) / Ap1(z),          *
+     *  - mem_w0: weighted error between the speech and the       *
+     *    comfort noise, (speech through A(z) - exc) / A(z/gamma) *
+     *------------------------------------------------------------*/
+    
+    Aq     = Aq_t;
+    speech = G729_ENC_SPEECH(state);
+    exc    = G729_ENC_EXC(state);
+    
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        g729_Residu(Aq, &speech[i_subfr], xn, L_SUBFR);
+        g729_Weight_Az(Aq, GAMMA1, M, Ap);
+        
+        Ap1[0] = 4096;
+        for (i = 1; i <= M; i++)    /* Ap1[i] = Ap[i] - 0.7 * Ap[i-1]; */
+            Ap1[i] = g729_sub(Ap[i], g729_mult(Ap[i-1], 22938));
+        g729_Syn_filt(Ap1, xn, &G729_ENC_WSP(state)[i_subfr], L_SUBFR, state->mem_w, 1);
+        
+        for (i = 0; i < L_SUBFR; i++)
+            xn[i] = g729_sub(xn[i], exc[i_subfr + i]);
+        g729_Syn_filt(Ap, xn, xn, L_SUBFR, state->mem_w0, 1);
+        
+        Aq += MP1;
+    }
+    
+    /* Shift speech[], wsp[] and exc[] for the next frame */
+    
+    g729_Copy(&(state->old_speech[L_FRAME]), &(state->old_speech[0]), L_TOTAL-L_FRAME);
+    g729_Copy(&(state->old_wsp[L_FRAME]), &(state->old_wsp[0]), PIT_MAX);
+    g729_Copy(&(state->old_exc[L_FRAME]), &(state->old_exc[0]), PIT_MAX+L_INTERPOL);
+    
+    return ftyp;
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+/* end of file */
@@ -42,6 +42,7 @@
 
 #include "g729a_typedef.h"
 #include "g729a_defines.h"
+#include "g729a_stats.h"
 
 typedef struct _g729a_lspdec_state
 {
@@ -62,9 +63,7 @@ typedef struct _g729a_post_filter_state
     
     /* inverse filtered synthesis (with A(z/GAMMA2_PST))   */
     G729_Word16 res2_buf[PIT_MAX + L_SUBFR];
-    G729_Word16 *res2;
     G729_Word16 scal_res2_buf[PIT_MAX + L_SUBFR];
-    G729_Word16 *scal_res2;
     
     /* memory of filter 1/A(z/GAMMA1_PST) */
     G729_Word16 mem_syn_pst[M];
@@ -97,7 +96,6 @@ typedef struct _g729a_decoder_state
     
     /* Excitation vector */
     G729_Word16 old_exc[L_FRAME+PIT_MAX+L_INTERPOL];
-    G729_Word16 *exc;
     
     /* Lsp (Line spectral pairs) */
     G729_Word16 lsp_old[M];
@@ -111,7 +109,16 @@ typedef struct _g729a_decoder_state
     G729_Word16 gain_pitch;      /* Pitch gain                         */
     
     G729_Word16 synth_buf[L_FRAME + M];
-    G729_Word16 *synth;
+    
+    G729_Word16 bad_lsf;         /* bad LSF indicator                  */
+    
+    G729_Word16 pst_mode;        /* G729A_POSTFILTER_* output mode     */
+    
+    /*--------------------------------------------------------------------------*
+     * util.c
+     *--------------------------------------------------------------------------*/
+    
+    G729_Word16 seed;            /* g729_Random generator state        */
     
     /*--------------------------------------------------------------------------*
      * dec_gain.c
@@ -120,14 +127,42 @@ typedef struct _g729a_decoder_state
     /* Gain predictor, Past quantized energies = -14.0 in Q10 */
     G729_Word16 past_qua_en[4];
     
+    /*--------------------------------------------------------------------------*
+     * dec_sid.c
+     *--------------------------------------------------------------------------*/
+    
+    G729_Word16 past_ftyp;       /* FRAME_SPEECH or FRAME_SID          */
+    G729_Word16 sid_lsp[M];      /* Q15: LSPs of the last SID          */
+    G729_Word16 sid_gain;        /* Q15: noise gain of the last SID    */
+    G729_Word16 cur_gain;        /* Q15: smoothed noise gain           */
+    G729_Word16 cng_seed;        /* noise generator, as in the encoder */
+    
     /*--------------------------------------------------------------------------*
      *--------------------------------------------------------------------------*/
     
     g729a_lspdec_state        lspdec_state;
     g729a_post_filter_state   post_filter_state;
     g729a_post_process_state  post_process_state;
+    
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+    /*--------------------------------------------------------------------------*
+     * Per-stage cycle counters, see stage_stats.h                              *
+     *--------------------------------------------------------------------------*/
+    
+    G729A_Stats stats;
+#endif
 } g729a_decoder_state;
 
+/*--------------------------------------------------------------------------*
+ * Vectors inside the buffers of the decoder state, which holds no pointers *
+ * (see g729a_encoder.h)                                                    *
+ *--------------------------------------------------------------------------*/
+
+#define G729_DEC_EXC(st)        (&(st)->old_exc[PIT_MAX + L_INTERPOL])
+#define G729_DEC_SYNTH(st)      (&(st)->synth_buf[M])
+#define G729_PST_RES2(st)       (&(st)->res2_buf[PIT_MAX])           /* post_filter_state */
+#define G729_PST_SCAL_RES2(st)  (&(st)->scal_res2_buf[PIT_MAX])      /* post_filter_state */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -148,6 +183,33 @@ void g729_Decod_ld8a(
     G729_Word16  *T2,         /* (o)   : decoded pitch lag in 2 subframes     */
     G729_Word16 bad_lsf       /* (i)   : bad LSF indicator   */
 );
+
+void g729_Decod_ld8a_params(
+    g729a_decoder_state * state,
+    G729_Word16  parm[],      /* (i)   : vector of synthesis parameters
+                                         parm[0] = bad frame indicator (bfi)  */
+    G729_Word16  lsp_new[],   /* (o)   : decoded LSPs                         */
+    G729_Word16  T[],         /* (o)   : integer pitch lag in 2 subframes     */
+    G729_Word16  T_frac[],    /* (o)   : fraction of the lag in 2 subframes   */
+    G729_Word16  gain_pit[],  /* (o) Q14 : pitch gain in 2 subframes          */
+    G729_Word16  gain_cod[],  /* (o) Q1  : codebook gain in 2 subframes       */
+    G729_Word16  ener[]       /* (o) Q8  : energy of the codebook contribution */
+                              /*           in dB in 2 subframes               */
+);
+    
+/*-------------------------------*
+ * Comfort noise                 *
+ *-------------------------------*/
+
+void g729_Init_Dec_cng(g729a_decoder_state * state);
+
+void g729_Decod_cng(
+    g729a_decoder_state * state,
+    G729_Word16  parm[],      /* (i)   : SID parameters, NULL if no frame     */
+    G729_Word16  synth[],     /* (o)   : synthesis speech                     */
+    G729_Word16  A_t[],       /* (o)   : LP filter in 2 subframes             */
+    G729_Word16  *T2          /* (o)   : pitch lag in 2 subframes             */
+);
     
 /*-------------------------------*
  * Post filter                   *
@@ -174,6 +236,12 @@ void g729_Post_Process(
     G729_Word16 signal_out[],   /* Output signal       */
     G729_Word16 lg              /* Length of signal    */
 );
+
+void g729_Post_Scale(
+    G729_Word16 signal_in[],    /* Input signal        */
+    G729_Word16 signal_out[],   /* Output signal       */
+    G729_Word16 lg              /* Length of signal    */
+);
     
 /*-------------------------------*
  * lspdec                        *
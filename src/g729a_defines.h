@@ -62,6 +62,14 @@
 
 #define  PRM_SIZE     11      /* Size of vector of analysis parameters.     */
 #define  SERIAL_SIZE  (80+2)  /* bfi+ number of speech bits                 */
+#define  BITSTREAM_SIZE 10    /* Bytes of a packed (compressed) frame.      */
+#define  SID_PRM_SIZE 3       /* Size of vector of SID parameters.          */
+#define  SID_SIZE     3       /* Bytes of a packed SID frame.               */
+#define  NB_SID_ENER  64      /* Levels of the SID energy quantizer.        */
+
+#define  FRAME_NO_TX  0       /* DTX frame types: nothing transmitted,      */
+#define  FRAME_SPEECH 1       /*                  speech frame,             */
+#define  FRAME_SID    2       /*                  silence descriptor.       */
 
 #define SHARPMAX  13017   /* Maximum value of pitch sharpening     0.8  Q14 */
 #define SHARPMIN  3277    /* Minimum value of pitch sharpening     0.2  Q14 */
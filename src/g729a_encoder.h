@@ -42,6 +42,7 @@
 
 #include "g729a_typedef.h"
 #include "g729a_defines.h"
+#include "g729a_stats.h"
 
 typedef struct _g729a_pre_process_state
 {
@@ -75,6 +76,36 @@ typedef struct _g729a_taming_state
     G729_Word32 L_exc_err[4];
 } g729a_taming_state;
 
+typedef struct _g729a_vad_state
+{
+    /*--------------------------------------------------------------------------*
+     * vad.c                                                                    *
+     *--------------------------------------------------------------------------*/
+    
+    G729_Word16 first;        /* no frame analysed yet                     */
+    G729_Word16 ener_mean;    /* Q8 dB: short term mean of frame energy    */
+    G729_Word16 floor;        /* Q8 dB: noise floor                        */
+    G729_Word16 lsp_noise[M]; /* Q15: mean LSPs of the inactive frames     */
+    G729_Word16 hangover;     /* active frames left after the last onset   */
+} g729a_vad_state;
+
+typedef struct _g729a_dtx_state
+{
+    /*--------------------------------------------------------------------------*
+     * dtx.c                                                                    *
+     *--------------------------------------------------------------------------*/
+    
+    G729_Word16 past_vad;     /* previous frame active                     */
+    G729_Word16 count;        /* frames since the last SID frame           */
+    G729_Word16 lsp_mean[M];  /* Q15: mean LSPs of the inactive frames     */
+    G729_Word16 ener_mean;    /* Q8 dB: mean residual energy               */
+    G729_Word16 sid_lsp[M];   /* Q15: quantized LSPs of the last SID       */
+    G729_Word16 sid_index;    /* energy index of the last SID              */
+    G729_Word16 sid_gain;     /* Q15: noise gain of the last SID           */
+    G729_Word16 cur_gain;     /* Q15: smoothed noise gain                  */
+    G729_Word16 seed;         /* noise generator, as in the decoder        */
+} g729a_dtx_state;
+
 typedef struct _g729a_encoder_state
 {
     G729_Word32 error;  /* TODO */
@@ -85,17 +116,12 @@ typedef struct _g729a_encoder_state
     
     /* Speech vector */
     G729_Word16 old_speech[L_TOTAL];
-    G729_Word16 *speech;
-    G729_Word16 *p_window;
-    G729_Word16 *new_speech;                    /* Global variable */
     
     /* Weighted speech vector */
     G729_Word16 old_wsp[L_FRAME+PIT_MAX];
-    G729_Word16 *wsp;
     
     /* Excitation vector */
     G729_Word16 old_exc[L_FRAME+PIT_MAX+L_INTERPOL];
-    G729_Word16 *exc;
     
     /* Lsp (Line spectral pairs) */
     G729_Word16 lsp_old[M];
@@ -107,6 +133,14 @@ typedef struct _g729a_encoder_state
     G729_Word16 mem_zero[M];
     G729_Word16 sharp;
     
+    /*--------------------------------------------------------------------------*
+     * lpc.c                                                                    *
+     *--------------------------------------------------------------------------*/
+    
+    /* Last A(z) for case of unstable filter */
+    G729_Word16 old_A[M+1];
+    G729_Word16 old_rc[2];
+    
     /*--------------------------------------------------------------------------*
      * qua_gain.c                                                               *
      *--------------------------------------------------------------------------*/
@@ -120,8 +154,40 @@ typedef struct _g729a_encoder_state
     g729a_pre_process_state  pre_process_state;
     g729a_lspenc_state       lspenc_state;
     g729a_taming_state       taming_state;
+    g729a_vad_state          vad_state;
+    g729a_dtx_state          dtx_state;
+    
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+    /*--------------------------------------------------------------------------*
+     * Per-stage cycle counters, see stage_stats.h                              *
+     *--------------------------------------------------------------------------*/
+    
+    G729A_Stats stats;
+#endif
 } g729a_encoder_state;
 
+/*--------------------------------------------------------------------------*
+ * Vectors inside the buffers of the encoder state. The state holds no      *
+ * pointers, so that it can be copied like any block of memory.             *
+ *                                                                          *
+ *   |--------------------|-------------|-------------|------------|        *
+ *     previous speech           sf1           sf2         L_NEXT           *
+ *                                                                          *
+ *   <----------------  Total speech vector (L_TOTAL)   ----------->        *
+ *   <----------------  LPC analysis window (L_WINDOW)  ----------->        *
+ *   |                   <-- present frame (L_FRAME) -->                    *
+ * old_speech            |              <-- new speech (L_FRAME) -->        *
+ * p_window              |              |                                   *
+ *                     speech           |                                   *
+ *                             new_speech                                   *
+ *--------------------------------------------------------------------------*/
+
+#define G729_ENC_NEW_SPEECH(st) (&(st)->old_speech[L_TOTAL - L_FRAME])          /* New speech     */
+#define G729_ENC_SPEECH(st)     (&(st)->old_speech[L_TOTAL - L_FRAME - L_NEXT]) /* Present frame  */
+#define G729_ENC_P_WINDOW(st)   (&(st)->old_speech[L_TOTAL - L_WINDOW])         /* For LPC window */
+#define G729_ENC_WSP(st)        (&(st)->old_wsp[PIT_MAX])
+#define G729_ENC_EXC(st)        (&(st)->old_exc[PIT_MAX + L_INTERPOL])
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -137,6 +203,23 @@ void g729_Coder_ld8a(
     g729a_encoder_state * state,
     G729_Word16 ana[]                    /* output  : Analysis parameters */
 );
+
+void g729_Coder_ld8a_lanes(
+    g729a_encoder_state * st[],          /* (i/o) : states of the channels               */
+    G729_Word16 n,                       /* (i)   : number of channels, 1..G729_LANES    */
+    G729_Word16 * ana_l[]                /* (o)   : analysis parameters of each channel  */
+);
+
+G729_Word16 g729_Coder_ld8a_dtx(
+    g729a_encoder_state * state,
+    G729_Word16 ana[]                    /* output  : Analysis parameters */
+);
+
+void g729_Lpc_ld8a(
+    g729a_encoder_state * state,
+    G729_Word16 A[],          /* (o) Q12 : LP filter coefficients (M+1) */
+    G729_Word16 lsp_new[]     /* (o) Q15 : LSPs of the frame             */
+);
     
 /*-------------------------------*
  * Pre-process.                  *
@@ -171,6 +254,36 @@ void   g729_Init_exc_err(g729a_taming_state * state);
 void   g729_update_exc_err(g729a_taming_state * state, G729_Word16 gain_pit, G729_Word16 t0);
 G729_Word16 g729_test_err(g729a_taming_state * state, G729_Word16 t0, G729_Word16 t0_frac);
     
+/*-------------------------------*
+ * VAD and DTX                   *
+ *-------------------------------*/
+
+void g729_Init_Vad(g729a_vad_state * state);
+
+G729_Word16 g729_Vad(             /* (o)     : 1 active, 0 inactive frame     */
+    g729a_vad_state * state,
+    G729_Word16 speech[],         /* (i)     : present frame (L_FRAME)        */
+    G729_Word16 lsp[]             /* (i) Q15 : LSPs of the frame              */
+);
+
+G729_Word16 g729_Ener_dB(         /* (o) Q8  : 10*log10 of the mean power     */
+    G729_Word16 x[]               /* (i)     : frame (L_FRAME)                */
+);
+
+G729_Word32 g729_Lsp_dist(        /* (o)     : sum of (lsp1-lsp2)^2, Q31      */
+    G729_Word16 lsp1[],           /* (i) Q15 : first LSP vector               */
+    G729_Word16 lsp2[]            /* (i) Q15 : second LSP vector              */
+);
+
+void g729_Init_Cod_cng(g729a_dtx_state * state);
+
+G729_Word16 g729_Cod_cng(         /* (o)     : FRAME_SID or FRAME_NO_TX       */
+    g729a_encoder_state * state,
+    G729_Word16 A[],              /* (i) Q12 : unquantized A(z) of the frame  */
+    G729_Word16 lsp_new[],        /* (i) Q15 : LSPs of the frame              */
+    G729_Word16 ana[]             /* (o)     : SID parameters                 */
+);
+    
 /*--------------------------------------------------------------------------*
  * gain VQ functions.                                                       *
  *--------------------------------------------------------------------------*/
@@ -185,6 +298,18 @@ G729_Word16 g729_Qua_gain(
     G729_Word16 *gain_cod,     /* (o) Q1  : Code gain.                                 */
     G729_Word16 tameflag       /* (i)     : flag set to 1 if taming is needed          */
 );
+
+G729_Word16 g729_Qua_gain_ref(   /* g729_Qua_gain() with the ITU search loop only */
+    g729a_encoder_state * state,
+    G729_Word16 code[],        /* (i) Q13 : Innovative vector.                         */
+    G729_Word16 g_coeff[],     /* (i)     : Correlations <xn y1> -2<y1 y1>             */
+                               /*            <y2,y2>, -2<xn,y2>, 2<y1,y2>              */
+    G729_Word16 exp_coeff[],   /* (i)    : Q-Format g_coeff[]                         */
+    G729_Word16 L_subfr,       /* (i)     : Subframe length.                           */
+    G729_Word16 *gain_pit,     /* (o) Q14 : Pitch gain.                                */
+    G729_Word16 *gain_cod,     /* (o) Q1  : Code gain.                                 */
+    G729_Word16 tameflag       /* (i)     : flag set to 1 if taming is needed          */
+);
     
 #ifdef __cplusplus
 }
@@ -0,0 +1,292 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Streaming file converters.                                        *
+ *                                                                   *
+ * Files are coded FILE_BLOCK_FRAMES frames at a time through two    *
+ * buffers allocated once, so memory use does not depend on the      *
+ * length of the file. Speech files are 8 kHz mono 16-bit WAV files  *
+ * or raw PCM; bitstream files hold 10 bytes per frame.              *
+ *                                                                   *
+ * Samples are read and written in host byte order, as by the coder  *
+ * and decoder programs; WAV headers are always little-endian.       *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g729a_interface.h"
+
+#define FRAMESIZE           80
+#define BITSTREAM_SIZE      10
+#define FILE_BLOCK_FRAMES   1000    /* Frames per read (10 s, 160 KB of PCM) */
+
+#define WAV_HEADER_SIZE     44
+#define WAV_SAMPLE_RATE     8000
+#define WAV_FORMAT_PCM      1
+#define WAV_FORMAT_EXT      0xFFFE  /* WAVE_FORMAT_EXTENSIBLE            */
+#define WAV_SIZE_UNKNOWN    0xFFFFFFFFu
+
+static G729_UWord32 g729a_Get_Le16(const G729_UWord8 *p)
+{
+    return (G729_UWord32)p[0] | ((G729_UWord32)p[1] << 8);
+}
+
+static G729_UWord32 g729a_Get_Le32(const G729_UWord8 *p)
+{
+    return g729a_Get_Le16(p) | (g729a_Get_Le16(p + 2) << 16);
+}
+
+static void g729a_Put_Le16(G729_UWord8 *p, G729_UWord32 x)
+{
+    p[0] = (G729_UWord8)x;
+    p[1] = (G729_UWord8)(x >> 8);
+}
+
+static void g729a_Put_Le32(G729_UWord8 *p, G729_UWord32 x)
+{
+    g729a_Put_Le16(p, x);
+    g729a_Put_Le16(p + 2, x >> 16);
+}
+
+/* Reads and drops n bytes of f, returns 0 or -1 at end of file */
+static G729_Word32 g729a_Skip(FILE *f, G729_UWord32 n, G729_UWord8 *buf, G729_UWord32 bufSize)
+{
+    G729_UWord32 k;
+    
+    while ( n > 0 )
+    {
+        k = n < bufSize ? n : bufSize;
+        if ( fread(buf, 1, k, f) != k ) return -1;
+        n -= k;
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------*
+ * Reads the header of a speech file up to the samples.              *
+ *                                                                   *
+ * A RIFF/WAVE file must hold 8 kHz mono 16-bit PCM; *dataSize gets  *
+ * the size of its data chunk, WAV_SIZE_UNKNOWN if it runs to the    *
+ * end of the file. Any other file is raw PCM: its first *nRead      *
+ * bytes, already read into buf, are samples.                        *
+ *-------------------------------------------------------------------*/
+static G729_Word32 g729a_Read_Wav_Header(FILE *f, G729_UWord8 *buf, G729_UWord32 bufSize, G729_UWord32 *nRead, G729_UWord32 *dataSize)
+{
+    G729_UWord8 chunk[8], fmt[40];
+    G729_UWord32 size, k, format;
+    G729_Word32 hasFmt = 0;
+    
+    *nRead = (G729_UWord32)fread(buf, 1, 12, f);
+    *dataSize = WAV_SIZE_UNKNOWN;
+    
+    if ( *nRead < 12 || memcmp(buf, "RIFF", 4) != 0 || memcmp(buf + 8, "WAVE", 4) != 0 )
+    {
+        return 0;
+    }
+    *nRead = 0;
+    
+    for ( ;; )
+    {
+        if ( fread(chunk, 1, 8, f) != 8 ) return -1;
+        size = g729a_Get_Le32(chunk + 4);
+        k = 0;
+    
+        if ( memcmp(chunk, "data", 4) == 0 )
+        {
+            if ( !hasFmt ) return -1;
+            /* 0 is left by writers that could not seek back */
+            if ( size != 0 ) *dataSize = size;
+            return 0;
+        }
+    
+        if ( memcmp(chunk, "fmt ", 4) == 0 && size >= 16 )
+        {
+            k = size < sizeof(fmt) ? size : sizeof(fmt);
+            if ( fread(fmt, 1, k, f) != k ) return -1;
+            format = g729a_Get_Le16(fmt);
+            if ( format == WAV_FORMAT_EXT && size >= 26 ) format = g729a_Get_Le16(fmt + 24);
+    
+            if ( format != WAV_FORMAT_PCM
+              || g729a_Get_Le16(fmt + 2) != 1
+              || g729a_Get_Le32(fmt + 4) != WAV_SAMPLE_RATE
+              || g729a_Get_Le16(fmt + 14) != 16 )
+            {
+                return -1;
+            }
+            hasFmt = 1;
+        }
+    
+        /* Rest of the chunk (k bytes read), padded to an even size */
+        if ( g729a_Skip(f, size - k + (size & 1), buf, bufSize) != 0 ) return -1;
+    }
+}
+
+/* Writes the 44-byte header of an 8 kHz mono 16-bit WAV file */
+static G729_Word32 g729a_Write_Wav_Header(FILE *f, G729_UWord32 dataSize)
+{
+    G729_UWord8 h[WAV_HEADER_SIZE];
+    
+    memcpy(h, "RIFF", 4);
+    g729a_Put_Le32(h + 4, dataSize == WAV_SIZE_UNKNOWN ? dataSize : dataSize + WAV_HEADER_SIZE - 8);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    g729a_Put_Le32(h + 16, 16);
+    g729a_Put_Le16(h + 20, WAV_FORMAT_PCM);
+    g729a_Put_Le16(h + 22, 1);
+    g729a_Put_Le32(h + 24, WAV_SAMPLE_RATE);
+    g729a_Put_Le32(h + 28, WAV_SAMPLE_RATE * 2);
+    g729a_Put_Le16(h + 32, 2);
+    g729a_Put_Le16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    g729a_Put_Le32(h + 40, dataSize);
+    
+    return fwrite(h, 1, WAV_HEADER_SIZE, f) == WAV_HEADER_SIZE ? 0 : -1;
+}
+
+/*---------------------------------------------*
+ * File functions                              *
+ *---------------------------------------------*/
+
+G729_Word32 G729A_Encode_File(const char * inPath, const char * outPath, G729_Word64 * nFrames)
+{
+    FILE *fin = NULL, *fout = NULL;
+    G729A_Enc_state state = NULL;
+    G729_UWord8 *inBuf = NULL, *outBuf = NULL;
+    G729_UWord32 inSize = FILE_BLOCK_FRAMES * FRAMESIZE * sizeof(G729_Word16);
+    G729_UWord32 n, want, dataSize;
+    G729_Word64 frames = 0;
+    G729_Word32 ret = -1, k;
+    
+    if ( NULL != nFrames ) *nFrames = 0;
+    if ( NULL == inPath || NULL == outPath ) return -1;
+    
+    fin    = fopen(inPath, "rb");
+    state  = malloc(G729A_Encoder_Get_Size());
+    inBuf  = (G729_UWord8 *)malloc(inSize);
+    outBuf = (G729_UWord8 *)malloc(FILE_BLOCK_FRAMES * BITSTREAM_SIZE);
+    
+    if ( NULL == fin || NULL == state || NULL == inBuf || NULL == outBuf ) goto done;
+    if ( G729A_Encoder_Init(state) != 0 ) goto done;
+    if ( g729a_Read_Wav_Header(fin, inBuf, inSize, &n, &dataSize) != 0 ) goto done;
+    
+    fout = fopen(outPath, "wb");
+    if ( NULL == fout ) goto done;
+    
+    /* n bytes of speech are already in inBuf */
+    
+    for ( ;; )
+    {
+        want = inSize - n;
+        if ( want > dataSize ) want = dataSize;
+        if ( want > 0 ) want = (G729_UWord32)fread(inBuf + n, 1, want, fin);
+        if ( dataSize != WAV_SIZE_UNKNOWN ) dataSize -= want;
+        n += want;
+        if ( n == 0 ) break;
+    
+        /* Partial last frame padded with zeros */
+        k = (G729_Word32)((n + FRAMESIZE * sizeof(G729_Word16) - 1) / (FRAMESIZE * sizeof(G729_Word16)));
+        memset(inBuf + n, 0, k * FRAMESIZE * sizeof(G729_Word16) - n);
+    
+        if ( G729A_Encoder_Process_Frames(state, (G729_Word16 *)inBuf, k, outBuf) != 0 ) goto done;
+        if ( fwrite(outBuf, BITSTREAM_SIZE, k, fout) != (size_t)k ) goto done;
+        frames += k;
+    
+        if ( n < inSize ) break;
+        n = 0;
+    }
+    
+    if ( ferror(fin) ) goto done;
+    ret = 0;
+    
+done:
+    if ( NULL != nFrames ) *nFrames = frames;
+    if ( NULL != fout && fclose(fout) != 0 ) ret = -1;
+    if ( NULL != fin ) fclose(fin);
+    free(state);
+    free(inBuf);
+    free(outBuf);
+    return ret;
+}
+
+G729_Word32 G729A_Decode_File(const char * inPath, const char * outPath, G729_Word32 wavOut, G729_Word64 * nFrames)
+{
+    FILE *fin = NULL, *fout = NULL;
+    G729A_Dec_state state = NULL;
+    G729_UWord8 *inBuf = NULL, *outBuf = NULL;
+    G729_UWord32 outSize = FILE_BLOCK_FRAMES * FRAMESIZE * sizeof(G729_Word16);
+    G729_Word64 frames = 0, dataSize;
+    G729_Word32 ret = -1, k;
+    
+    if ( NULL != nFrames ) *nFrames = 0;
+    if ( NULL == inPath || NULL == outPath ) return -1;
+    
+    fin    = fopen(inPath, "rb");
+    state  = malloc(G729A_Decoder_Get_Size());
+    inBuf  = (G729_UWord8 *)malloc(FILE_BLOCK_FRAMES * BITSTREAM_SIZE);
+    outBuf = (G729_UWord8 *)malloc(outSize);
+    
+    if ( NULL == fin || NULL == state || NULL == inBuf || NULL == outBuf ) goto done;
+    if ( G729A_Decoder_Init(state) != 0 ) goto done;
+    
+    fout = fopen(outPath, "wb");
+    if ( NULL == fout ) goto done;
+    
+    /* Sizes unknown until the end, patched then if the file can seek */
+    
+    if ( wavOut && g729a_Write_Wav_Header(fout, WAV_SIZE_UNKNOWN) != 0 ) goto done;
+    
+    while ( (k = (G729_Word32)fread(inBuf, BITSTREAM_SIZE, FILE_BLOCK_FRAMES, fin)) > 0 )
+    {
+        if ( G729A_Decoder_Process_Frames(state, inBuf, k, NULL, (G729_Word16 *)outBuf) != 0 ) goto done;
+        if ( fwrite(outBuf, FRAMESIZE * sizeof(G729_Word16), k, fout) != (size_t)k ) goto done;
+        frames += k;
+    }
+    
+    /* A partial last frame is dropped */
+    
+    if ( ferror(fin) ) goto done;
+    
+    if ( wavOut )
+    {
+        dataSize = frames * FRAMESIZE * sizeof(G729_Word16);
+        if ( dataSize <= WAV_SIZE_UNKNOWN - WAV_HEADER_SIZE && fseek(fout, 0, SEEK_SET) == 0 )
+        {
+            if ( g729a_Write_Wav_Header(fout, (G729_UWord32)dataSize) != 0 ) goto done;
+        }
+    }
+    ret = 0;
+    
+done:
+    if ( NULL != nFrames ) *nFrames = frames;
+    if ( NULL != fout && fclose(fout) != 0 ) ret = -1;
+    if ( NULL != fin ) fclose(fin);
+    free(state);
+    free(inBuf);
+    free(outBuf);
+    return ret;
+}
@@ -38,6 +38,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "g729a_interface.h"
 
@@ -45,6 +46,8 @@
 #include "g729a_decoder.h"
 
 #include "ld8a.h"
+#include "simd_func.h"
+#include "stage_stats.h"
 
 /*---------------------------------------------*
  * Encoder functions                           *
@@ -62,12 +65,27 @@ G729_Word32 G729A_Encoder_Init(G729A_Enc_state encState)
     
     state = (g729a_encoder_state *)encState;
     
+    /* Clears the padding too, so that snapshots of equal states are equal */
+    memset(state, 0, sizeof(g729a_encoder_state));
+    
     g729_Init_Pre_Process(&(state->pre_process_state));
     g729_Init_Coder_ld8a(state);
     
     return 0;
 }
 
+static void g729a_Encode_Frame(g729a_encoder_state * state, G729_Word16 * speechIn, G729_Word16 * prm)
+{
+    G729_STATS_DECL
+    
+    G729_STATS_START;
+    g729_Pre_Process(&(state->pre_process_state), speechIn, G729_ENC_NEW_SPEECH(state), L_FRAME);
+    G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_PRE_PROCESS);
+    
+    g729_Coder_ld8a(state, prm);
+    G729_STATS_FRAME(&(state->stats));
+}
+
 G729_Word32 G729A_Encoder_Process(G729A_Enc_state encState, G729_Word16 * speechIn, G729_UWord8 * outData)
 {
     g729a_encoder_state * state;
@@ -77,13 +95,127 @@ G729_Word32 G729A_Encoder_Process(G729A_Enc_state encState, G729_Word16 * speech
     
     state = (g729a_encoder_state *)encState;
     
-    g729_Pre_Process(&(state->pre_process_state), speechIn, state->new_speech, L_FRAME);
-    g729_Coder_ld8a(state, prm);
+    g729a_Encode_Frame(state, speechIn, prm);
     g729_prm2bits_ld8k_compressed(prm, outData);
     
     return 0;
 }
 
+G729_Word32 G729A_Encoder_Process_Frames(G729A_Enc_state encState, G729_Word16 * speechIn, G729_Word32 nFrames, G729_UWord8 * outData)
+{
+    g729a_encoder_state * state;
+    G729_Word16 prm[PRM_SIZE];  /* Analysis parameters. */
+    G729_Word32 i;
+    
+    if ( NULL == encState ) return -1;
+    if ( nFrames < 0 ) return -1;
+    if ( nFrames > 0 && (NULL == speechIn || NULL == outData) ) return -1;
+    
+    state = (g729a_encoder_state *)encState;
+    
+    /* Checks are done once for the block, the loop only runs the codec. */
+    
+    for ( i = 0; i < nFrames; ++i )
+    {
+        g729a_Encode_Frame(state, speechIn, prm);
+        g729_prm2bits_ld8k_compressed(prm, outData);
+        
+        speechIn += L_FRAME;
+        outData  += BITSTREAM_SIZE;
+    }
+    
+    return 0;
+}
+
+G729_Word32 G729A_Encoder_Process_Private_DTX(G729A_Enc_state encState, G729_Word16 * speechIn, G729_UWord8 * outData)
+{
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+    g729a_encoder_state * state;
+    G729_Word16 prm[PRM_SIZE];  /* Analysis parameters. */
+    G729_Word16 ftyp;
+    G729_STATS_DECL
+    
+    if ( NULL == encState || NULL == speechIn || NULL == outData ) return -1;
+    
+    state = (g729a_encoder_state *)encState;
+    
+    G729_STATS_START;
+    g729_Pre_Process(&(state->pre_process_state), speechIn, G729_ENC_NEW_SPEECH(state), L_FRAME);
+    G729_STATS_STOP(&(state->stats), G729A_ENC_STAGE_PRE_PROCESS);
+    
+    ftyp = g729_Coder_ld8a_dtx(state, prm);
+    G729_STATS_FRAME(&(state->stats));
+    
+    if ( ftyp == FRAME_SPEECH )
+    {
+        g729_prm2bits_ld8k_compressed(prm, outData);
+        return BITSTREAM_SIZE;
+    }
+    if ( ftyp == FRAME_SID )
+    {
+        g729_prm2bits_sid(prm, outData);
+        return SID_SIZE;
+    }
+    
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+G729_Word32 G729A_Encoder_Process_Lanes(G729A_Enc_state * encStates, G729_Word32 nStates, G729_Word16 * speechIn, G729_UWord8 * outData)
+{
+    g729a_encoder_state * st[G729_LANES];
+    G729_Word16 prm[G729_LANES][PRM_SIZE];  /* Analysis parameters. */
+    G729_Word16 * ana[G729_LANES];
+    G729_Word32 i, j;
+    G729_Word16 l, n;
+    G729_STATS_DECL
+    
+    if ( nStates < 0 ) return -1;
+    if ( nStates == 0 ) return 0;
+    if ( NULL == encStates || NULL == speechIn || NULL == outData ) return -1;
+    
+    /* A state given twice would be updated by two lanes at once */
+    
+    for ( i = 0; i < nStates; ++i )
+    {
+        if ( NULL == encStates[i] ) return -1;
+        for ( j = 0; j < i; ++j )
+        {
+            if ( encStates[j] == encStates[i] ) return -1;
+        }
+    }
+    
+    /* The channels are coded G729_LANES at a time, their filters sharing */
+    /* the vector registers.                                              */
+    
+    for ( i = 0; i < nStates; i += n )
+    {
+        n = (G729_Word16)((nStates - i < G729_LANES) ? (nStates - i) : G729_LANES);
+        
+        for ( l = 0; l < n; ++l )
+        {
+            st[l]  = (g729a_encoder_state *)encStates[i + l];
+            ana[l] = prm[l];
+            
+            G729_STATS_START;
+            g729_Pre_Process(&(st[l]->pre_process_state), &speechIn[(i + l) * L_FRAME], G729_ENC_NEW_SPEECH(st[l]), L_FRAME);
+            G729_STATS_STOP(&(st[l]->stats), G729A_ENC_STAGE_PRE_PROCESS);
+        }
+        
+        g729_Coder_ld8a_lanes(st, n, ana);
+        
+        for ( l = 0; l < n; ++l )
+        {
+            G729_STATS_FRAME(&(st[l]->stats));
+            g729_prm2bits_ld8k_compressed(prm[l], &outData[(i + l) * BITSTREAM_SIZE]);
+        }
+    }
+    
+    return 0;
+}
+
 G729_Word32 G729A_Encoder_Get_Error(G729A_Enc_state encState)
 {
     g729a_encoder_state * state;
@@ -94,6 +226,48 @@ G729_Word32 G729A_Encoder_Get_Error(G729A_Enc_state encState)
     return state->error;
 }
 
+G729_UWord32 G729A_Encoder_Get_Snapshot_Size()
+{
+    return sizeof(g729a_encoder_state);
+}
+
+G729_Word32 G729A_Encoder_Snapshot(G729A_Enc_state encState, void * snapshot)
+{
+    if ( NULL == encState || NULL == snapshot ) return -1;
+    
+    /* The state holds no pointers, a copy is complete */
+    memcpy(snapshot, encState, sizeof(g729a_encoder_state));
+    
+    return 0;
+}
+
+G729_Word32 G729A_Encoder_Restore(G729A_Enc_state encState, const void * snapshot)
+{
+    if ( NULL == encState || NULL == snapshot ) return -1;
+    
+    memcpy(encState, snapshot, sizeof(g729a_encoder_state));
+    
+    return 0;
+}
+
+G729_Word32 G729A_Encoder_Get_Stats(G729A_Enc_state encState, G729A_Stats * stats)
+{
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+    g729a_encoder_state * state;
+    if ( NULL == encState || NULL == stats ) return -1;
+    
+    state = (g729a_encoder_state *)encState;
+    
+    *stats = state->stats;
+    
+    return 0;
+#else
+    (void)encState;
+    (void)stats;
+    return -1;
+#endif
+}
+
 /*---------------------------------------------*
  * Decoder functions                           *
  *---------------------------------------------*/
@@ -110,8 +284,8 @@ G729_Word32 G729A_Decoder_Init(G729A_Enc_state decState)
     
     state = (g729a_decoder_state *)decState;
     
-    g729_Set_zero(state->synth_buf, M);
-    state->synth = state->synth_buf + M;
+    /* Clears the padding too, so that snapshots of equal states are equal */
+    memset(state, 0, sizeof(g729a_decoder_state));
     
     g729_Init_Decod_ld8a(state);
     g729_Init_Post_Filter(&(state->post_filter_state));
@@ -120,13 +294,65 @@ G729_Word32 G729A_Decoder_Init(G729A_Enc_state decState)
     return 0;
 }
 
-G729_Word32 G729A_Decoder_Process(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word16 * speechOut)
+/* Post-filter and post-process of the synthesis of a decoded frame */
+static void g729a_Output_Frame(g729a_decoder_state * state, G729_Word16 * Az_dec, G729_Word16 * T2, G729_Word16 * speechOut)
 {
-    static G729_Word16 bad_lsf = 0;          /* Initialize bad LSF indicator */
+    G729_STATS_DECL
     
-    G729_Word16  parm[PRM_SIZE+1];           /* Synthesis parameters        */
+    G729_STATS_START;
+    if ( state->pst_mode == G729A_POSTFILTER_ON )
+    {
+        g729_Post_Filter(&(state->post_filter_state), G729_DEC_SYNTH(state), Az_dec, T2);
+    }
+    else
+    {
+        /* update of the synthesis history, as by g729_Post_Filter() */
+        g729_Copy(&G729_DEC_SYNTH(state)[L_FRAME-M], &G729_DEC_SYNTH(state)[-M], M);
+    }
+    G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_POSTFILTER);
+    if ( state->pst_mode == G729A_POSTFILTER_OFF )
+    {
+        g729_Post_Scale(G729_DEC_SYNTH(state), speechOut, L_FRAME);
+    }
+    else
+    {
+        g729_Post_Process(&(state->post_process_state), G729_DEC_SYNTH(state), speechOut, L_FRAME);
+    }
+    G729_STATS_STOP(&(state->stats), G729A_DEC_STAGE_POST_PROCESS);
+    G729_STATS_FRAME(&(state->stats));
+}
+
+static void g729a_Decode_Frame(g729a_decoder_state * state, G729_Word16 * parm, G729_Word16 * speechOut)
+{
     G729_Word16  Az_dec[MP1*2];              /* Decoded Az for post-filter  */
     G729_Word16  T2[2];                      /* Pitch lag for 2 subframes   */
+    
+    /* check pitch parity and put 1 in parm[4] if parity error */
+    parm[4] = g729_Check_Parity_Pitch(parm[3], parm[4]);
+    
+    g729_Decod_ld8a(state, parm, G729_DEC_SYNTH(state), Az_dec, T2, state->bad_lsf);
+    
+    g729a_Output_Frame(state, Az_dec, T2, speechOut);
+}
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+/* Comfort noise of a SID frame, or of a frame not transmitted if parm is NULL */
+static void g729a_Decode_Cng(g729a_decoder_state * state, G729_Word16 * parm, G729_Word16 * speechOut)
+{
+    G729_Word16  Az_dec[MP1*2];              /* Az for post-filter          */
+    G729_Word16  T2[2];                      /* Pitch lag for 2 subframes   */
+    
+    g729_Decod_cng(state, parm, G729_DEC_SYNTH(state), Az_dec, T2);
+    
+    g729a_Output_Frame(state, Az_dec, T2, speechOut);
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+G729_Word32 G729A_Decoder_Process(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word16 * speechOut)
+{
+    G729_Word16  parm[PRM_SIZE+1];           /* Synthesis parameters        */
 
     g729a_decoder_state *state;
     if ( NULL == decState ) return -1;
@@ -137,12 +363,145 @@ G729_Word32 G729A_Decoder_Process(G729A_Dec_state decState, G729_UWord8 * inData
     
     parm[0] = 0;           /* No frame erasure */
     
-    /* check pitch parity and put 1 in parm[4] if parity error */
-    parm[4] = g729_Check_Parity_Pitch(parm[3], parm[4]);
+    g729a_Decode_Frame(state, parm, speechOut);
+    
+    return 0;
+}
+
+G729_Word32 G729A_Decoder_Process_Frames(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729_Word16 * speechOut)
+{
+    G729_Word16  parm[PRM_SIZE+1];           /* Synthesis parameters        */
+    G729_Word32  i;
+    
+    g729a_decoder_state *state;
+    if ( NULL == decState ) return -1;
+    if ( nFrames < 0 ) return -1;
+    if ( nFrames > 0 && (NULL == inData || NULL == speechOut) ) return -1;
+    
+    state = (g729a_decoder_state *)decState;
+    
+    for ( i = 0; i < nFrames; ++i )
+    {
+        if ( NULL != lostMask && (lostMask[i >> 3] & (1 << (i & 7))) )
+        {
+            /* Lost frame: the payload is not read, all indexes are replaced */
+            g729_Set_zero(&parm[1], PRM_SIZE);
+            parm[0] = 1;       /* frame erased */
+        }
+        else
+        {
+            g729_bits2prm_ld8k_compressed(inData, &parm[1]);
+            parm[0] = 0;       /* No frame erasure */
+        }
+        
+        g729a_Decode_Frame(state, parm, speechOut);
+        
+        inData    += BITSTREAM_SIZE;
+        speechOut += L_FRAME;
+    }
+    
+    return 0;
+}
+
+G729_Word32 G729A_Decoder_Process_Private_DTX(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 inSize, G729_Word16 * speechOut)
+{
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+    G729_Word16  parm[PRM_SIZE+1];           /* Synthesis parameters        */
+    
+    g729a_decoder_state *state;
+    if ( NULL == decState || NULL == speechOut ) return -1;
+    if ( inSize != 0 && NULL == inData ) return -1;
+    
+    state = (g729a_decoder_state *)decState;
+    
+    if ( inSize == BITSTREAM_SIZE )
+    {
+        g729_bits2prm_ld8k_compressed(inData, &parm[1]);
+        parm[0] = 0;           /* No frame erasure */
+        g729a_Decode_Frame(state, parm, speechOut);
+    }
+    else if ( inSize == SID_SIZE )
+    {
+        g729_bits2prm_sid(inData, parm);
+        g729a_Decode_Cng(state, parm, speechOut);
+    }
+    else if ( inSize == 0 )
+    {
+        if ( state->past_ftyp == FRAME_SPEECH )
+        {
+            /* No SID since the last speech frame: the frame was lost */
+            g729_Set_zero(&parm[1], PRM_SIZE);
+            parm[0] = 1;       /* frame erased */
+            g729a_Decode_Frame(state, parm, speechOut);
+        }
+        else
+        {
+            g729a_Decode_Cng(state, NULL, speechOut);
+        }
+    }
+    else
+    {
+        return -1;
+    }
+    
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+G729_Word32 G729A_Decoder_Analyze(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729A_Params * params)
+{
+    G729_Word16  parm[PRM_SIZE+1];           /* Synthesis parameters        */
+    G729_Word16  lsp[M];
+    G729_Word16  T[2], T_frac[2], gain_pit[2], gain_cod[2], ener[2];
+    G729_Word32  i;
     
-    g729_Decod_ld8a(state, parm, state->synth, Az_dec, T2, bad_lsf);
-    g729_Post_Filter(&(state->post_filter_state), state->synth, Az_dec, T2);
-    g729_Post_Process(&(state->post_process_state), state->synth, speechOut, L_FRAME);
+    g729a_decoder_state *state;
+    if ( NULL == decState || NULL == params ) return -1;
+    if ( nFrames < 0 ) return -1;
+    if ( nFrames > 0 && NULL == inData ) return -1;
+    
+    state = (g729a_decoder_state *)decState;
+    
+    for ( i = 0; i < nFrames; ++i )
+    {
+        if ( NULL != lostMask && (lostMask[i >> 3] & (1 << (i & 7))) )
+        {
+            g729_Set_zero(&parm[1], PRM_SIZE);
+            parm[0] = 1;       /* frame erased */
+        }
+        else
+        {
+            g729_bits2prm_ld8k_compressed(inData, &parm[1]);
+            parm[0] = 0;       /* No frame erasure */
+        }
+        parm[4] = g729_Check_Parity_Pitch(parm[3], parm[4]);
+        
+        g729_Decod_ld8a_params(state, parm, lsp, T, T_frac, gain_pit, gain_cod, ener);
+        
+        if ( NULL != params->lsp )       g729_Copy(lsp, &params->lsp[i * M], M);
+        if ( NULL != params->pitchLag )  g729_Copy(T, &params->pitchLag[i * 2], 2);
+        if ( NULL != params->pitchFrac ) g729_Copy(T_frac, &params->pitchFrac[i * 2], 2);
+        if ( NULL != params->gainPitch ) g729_Copy(gain_pit, &params->gainPitch[i * 2], 2);
+        if ( NULL != params->gainCode )  g729_Copy(gain_cod, &params->gainCode[i * 2], 2);
+        if ( NULL != params->energy )    g729_Copy(ener, &params->energy[i * 2], 2);
+        
+        inData += BITSTREAM_SIZE;
+    }
+    
+    return 0;
+}
+
+G729_Word32 G729A_Decoder_Set_Postfilter(G729A_Dec_state decState, G729_Word32 mode)
+{
+    g729a_decoder_state * state;
+    if ( NULL == decState ) return -1;
+    if ( mode != G729A_POSTFILTER_ON && mode != G729A_POSTFILTER_OFF_HP && mode != G729A_POSTFILTER_OFF ) return -1;
+    
+    state = (g729a_decoder_state *)decState;
+    
+    state->pst_mode = (G729_Word16)mode;
     
     return 0;
 }
@@ -157,6 +516,48 @@ G729_Word32 G729A_Decoder_Get_Error(G729A_Enc_state decState)
     return state->error;
 }
 
+G729_Word32 G729A_Decoder_Get_Stats(G729A_Dec_state decState, G729A_Stats * stats)
+{
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+    g729a_decoder_state * state;
+    if ( NULL == decState || NULL == stats ) return -1;
+    
+    state = (g729a_decoder_state *)decState;
+    
+    *stats = state->stats;
+    
+    return 0;
+#else
+    (void)decState;
+    (void)stats;
+    return -1;
+#endif
+}
+
+G729_UWord32 G729A_Decoder_Get_Snapshot_Size()
+{
+    return sizeof(g729a_decoder_state);
+}
+
+G729_Word32 G729A_Decoder_Snapshot(G729A_Dec_state decState, void * snapshot)
+{
+    if ( NULL == decState || NULL == snapshot ) return -1;
+    
+    /* The state holds no pointers, a copy is complete */
+    memcpy(snapshot, decState, sizeof(g729a_decoder_state));
+    
+    return 0;
+}
+
+G729_Word32 G729A_Decoder_Restore(G729A_Dec_state decState, const void * snapshot)
+{
+    if ( NULL == decState || NULL == snapshot ) return -1;
+    
+    memcpy(decState, snapshot, sizeof(g729a_decoder_state));
+    
+    return 0;
+}
+
 /*---------------------------------------------*
  * Generic functions                           *
  *---------------------------------------------*/
@@ -180,8 +581,7 @@ G729_Word32 G729A_Encoder_Process_Testing(G729A_Enc_state encState, G729_Word16
     
     state = (g729a_encoder_state *)encState;
     
-    g729_Pre_Process(&(state->pre_process_state), speechIn, state->new_speech, L_FRAME);
-    g729_Coder_ld8a(state, prm);
+    g729a_Encode_Frame(state, speechIn, prm);
     g729_prm2bits_ld8k(prm, outData);
     
     return 0;
@@ -189,12 +589,8 @@ G729_Word32 G729A_Encoder_Process_Testing(G729A_Enc_state encState, G729_Word16
 
 G729_Word32 G729A_Decoder_Process_Testing(G729A_Dec_state decState, G729_Word16 * inData, G729_Word16 * speechOut)
 {
-    static G729_Word16 bad_lsf = 0;          /* Initialize bad LSF indicator */
-    
     G729_Word16 i;
     G729_Word16 parm[PRM_SIZE+1];           /* Synthesis parameters        */
-    G729_Word16 Az_dec[MP1*2];              /* Decoded Az for post-filter  */
-    G729_Word16 T2[2];                      /* Pitch lag for 2 subframes   */
     
     g729a_decoder_state *state;
     if ( NULL == decState ) return -1;
@@ -209,12 +605,7 @@ G729_Word32 G729A_Decoder_Process_Testing(G729A_Dec_state decState, G729_Word16
         if (inData[i] == 0 ) parm[0] = 1;  /* frame erased */
     }
     
-    /* check pitch parity and put 1 in parm[4] if parity error */
-    parm[4] = g729_Check_Parity_Pitch(parm[3], parm[4]);
-    
-    g729_Decod_ld8a(state, parm, state->synth, Az_dec, T2, bad_lsf);
-    g729_Post_Filter(&(state->post_filter_state), state->synth, Az_dec, T2);
-    g729_Post_Process(&(state->post_process_state), state->synth, speechOut, L_FRAME);
+    g729a_Decode_Frame(state, parm, speechOut);
     
     return 0;
 }
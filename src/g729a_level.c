@@ -0,0 +1,250 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Level and voice activity of G.729A streams, estimated from the    *
+ * 10 bytes frames without decoding them.                            *
+ *                                                                   *
+ * The gain VQ index GA/GB of a subframe gives the correction factor *
+ * gamma of the predicted codebook gain and the pitch gain gp. The   *
+ * decoder scales the codevector c by gc = gamma * gcode0, where     *
+ * gcode0 cancels the energy of c (g729_Gain_predict), so that the   *
+ * energy of the codebook contribution is, in dB,                    *
+ *                                                                   *
+ *    MEAN_ENER + Sum(i=0,3) g729_pred[i]*past_qua_en[i]             *
+ *              + 20 log10(gamma)                                    *
+ *                                                                   *
+ * with the past quantized energies kept as in the decoder. The      *
+ * adaptive codebook adds about -10 log10(1 - gp^2) dB to it. Both   *
+ * terms of the index are in tables (g729_gbk_qua_en,                *
+ * g729_gbk_pit_boost). The level is that of the excitation (LP      *
+ * residual), before the synthesis filter, which is enough to        *
+ * compare talkers.                                                  *
+ *                                                                   *
+ * A frame is active when the short term mean of the level is        *
+ * ACTIVE_MARGIN above a noise floor that follows its minimum, and   *
+ * above ACTIVE_MIN (digital silence would drag the floor down to    *
+ * where any noise is taken for speech). It stays active for         *
+ * HANGOVER frames after that.                                       *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+
+#include "g729a_interface.h"
+#include "basic_op.h"
+#include "ld8a.h"
+#include "tab_ld8a.h"
+
+#define MEAN_ENER       503316480L  /* Q24: 30 dB, mean energy of the codebook contribution */
+#define LOST_DECAY      256         /* Q8: 1 dB per lost frame                             */
+#define FLOOR_INIT      (20*256)    /* Q8: noise floor at start                            */
+#define FLOOR_RISE      13          /* Q8: 0.05 dB per frame, 5 dB/s                       */
+#define ACTIVE_MARGIN   (9*256)     /* Q8: level above the noise floor of an active frame  */
+#define ACTIVE_MIN      (10*256)    /* Q8: lowest level of an active frame (about -65 dBov) */
+#define HANGOVER        20          /* frames still active after the level dropped         */
+
+typedef struct _g729a_level_state
+{
+    G729_Word16 past_qua_en[4];     /* Q10: past quantized energies, as in the decoder */
+    G729_Word16 level;              /* Q8: level of the last frame, dB                 */
+    G729_Word16 smooth;             /* Q8: level with a slow release, for the ranking  */
+    G729_Word16 mean;               /* Q8: short term mean of the level, for the VAD   */
+    G729_Word16 floor;              /* Q8: noise floor                                 */
+    G729_Word16 hangover;           /* frames left to stay active                      */
+    G729_Word16 active;             /* voice activity of the last frame                */
+} g729a_level_state;
+
+/*-------------------------------------------------------------------*
+ * Level_frame: level and voice activity of one frame.               *
+ *-------------------------------------------------------------------*/
+
+static void Level_frame(
+    g729a_level_state *state,
+    G729_UWord8 *bits,              /* (i) : frame, 10 bytes           */
+    G729_Word16 bfi                 /* (i) : bad frame indicator       */
+)
+{
+    G729_Word16 index[2], i, sf, ga, gb;
+    G729_Word32 L_tmp, L_level;
+    
+    if ( bfi != 0 )
+    {
+        g729_Gain_update_erasure(state->past_qua_en);
+        g729_Gain_update_erasure(state->past_qua_en);
+        state->level = g729_sub(state->level, LOST_DECAY);
+    }
+    else
+    {
+        /* GA/GB of the 2 subframes: bits 44..50 and 73..79 of the frame */
+        index[0] = (G729_Word16)(((bits[5] & 0x0f) << 3) | (bits[6] >> 5));
+        index[1] = (G729_Word16)(bits[9] & 0x7f);
+        
+        L_level = 0;
+        for ( sf = 0; sf < 2; sf++ )
+        {
+            ga = g729_shr(index[sf], NCODE2_B);
+            gb = index[sf] & (NCODE2-1);
+            
+            L_tmp = MEAN_ENER;
+            for ( i = 0; i < 4; i++ )
+                L_tmp = g729_L_mac(L_tmp, g729_pred[i], state->past_qua_en[i]);     /* Q24 */
+            
+            /* g729_Gain_update() */
+            for ( i = 3; i > 0; i-- )
+                state->past_qua_en[i] = state->past_qua_en[i-1];
+            state->past_qua_en[0] = g729_gbk_qua_en[ga][gb];
+            L_tmp = g729_L_mac(L_tmp, state->past_qua_en[0], 8192);                 /* + 20 log10(gamma) */
+            
+            L_tmp = g729_L_add(g729_L_deposit_l(g729_extract_h(L_tmp)), g729_L_deposit_l(g729_gbk_pit_boost[ga][gb]));
+            L_level = g729_L_add(L_level, L_tmp);
+        }
+        state->level = g729_extract_l(g729_L_shr(L_level, 1));                      /* mean of the subframes */
+    }
+    
+    /* Slow release of the level used for the ranking */
+    if ( g729_sub(state->level, state->smooth) > 0 )
+    {
+        state->smooth = state->level;
+    }
+    else
+    {
+        state->smooth = g729_sub(state->smooth, g729_shr(g729_sub(state->smooth, state->level), 4));
+    }
+    
+    /* Noise floor and voice activity, on the mean level: the level of */
+    /* a single frame of background noise swings by 10 dB or more       */
+    state->mean = g729_add(state->mean, g729_shr(g729_sub(state->level, state->mean), 2));
+    
+    if ( g729_sub(state->mean, state->floor) < 0 )
+    {
+        state->floor = state->mean;
+    }
+    else if ( bfi == 0 )
+    {
+        state->floor = g729_add(state->floor, FLOOR_RISE);
+    }
+    
+    if ( (bfi == 0) && (g729_sub(state->mean, g729_add(state->floor, ACTIVE_MARGIN)) > 0)
+                    && (g729_sub(state->mean, ACTIVE_MIN) > 0) )
+    {
+        state->hangover = HANGOVER;
+        state->active = 1;
+    }
+    else if ( state->hangover > 0 )
+    {
+        state->hangover--;
+        state->active = 1;
+    }
+    else
+    {
+        state->active = 0;
+    }
+}
+
+G729_UWord32 G729A_Level_Get_Size()
+{
+    return sizeof(g729a_level_state);
+}
+
+G729_Word32 G729A_Level_Init(G729A_Level_state levelState)
+{
+    g729a_level_state *state;
+    G729_Word16 i;
+    
+    if ( NULL == levelState ) return -1;
+    
+    state = (g729a_level_state *)levelState;
+    
+    for ( i = 0; i < 4; i++ )
+        state->past_qua_en[i] = -14336;                 /* -14 dB in Q10, as in the decoder */
+    state->level    = FLOOR_INIT;
+    state->smooth   = FLOOR_INIT;
+    state->mean     = FLOOR_INIT;
+    state->floor    = FLOOR_INIT;
+    state->hangover = 0;
+    state->active   = 0;
+    
+    return 0;
+}
+
+G729_Word32 G729A_Level_Process(G729A_Level_state levelState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729_Word16 * level, G729_Word16 * active)
+{
+    g729a_level_state *state;
+    G729_Word32 i;
+    
+    if ( NULL == levelState ) return -1;
+    if ( nFrames < 0 ) return -1;
+    if ( nFrames > 0 && NULL == inData ) return -1;
+    
+    state = (g729a_level_state *)levelState;
+    
+    for ( i = 0; i < nFrames; ++i )
+    {
+        Level_frame(state, &inData[i * BITSTREAM_SIZE],
+                    (NULL != lostMask && (lostMask[i >> 3] & (1 << (i & 7)))) ? 1 : 0);
+        
+        if ( NULL != level )  level[i]  = state->level;
+        if ( NULL != active ) active[i] = state->active;
+    }
+    
+    return 0;
+}
+
+G729_Word32 G729A_Level_Rank(G729A_Level_state * levelStates, G729_Word32 nStates, G729_UWord8 * inData, G729_UWord8 * lostMask, G729_Word32 nLoudest, G729_Word32 * loudest)
+{
+    g729a_level_state *state;
+    G729_Word32 i, k, n;
+    
+    if ( NULL == levelStates || NULL == inData || NULL == loudest ) return -1;
+    if ( nStates < 0 || nLoudest < 0 ) return -1;
+    
+    n = 0;
+    for ( i = 0; i < nStates; ++i )
+    {
+        state = (g729a_level_state *)levelStates[i];
+        if ( NULL == state ) return -1;
+        
+        Level_frame(state, &inData[i * BITSTREAM_SIZE],
+                    (NULL != lostMask && (lostMask[i >> 3] & (1 << (i & 7)))) ? 1 : 0);
+        
+        if ( !state->active ) continue;
+        
+        /* Insert stream i in the list of the loudest ones, loudest first */
+        for ( k = n; k > 0; --k )
+        {
+            if ( ((g729a_level_state *)levelStates[loudest[k-1]])->smooth >= state->smooth ) break;
+            if ( k < nLoudest ) loudest[k] = loudest[k-1];
+        }
+        if ( k < nLoudest )
+        {
+            loudest[k] = i;
+            if ( n < nLoudest ) n++;
+        }
+    }
+    
+    return n;
+}
+/* end of file */
@@ -0,0 +1,320 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------------------*
+ * Block-parallel coding of a long signal.                                   *
+ *                                                                           *
+ * The signal is cut at frame boundaries into one block per thread, each     *
+ * join moved into the quietest stretch nearby. Each block but the first     *
+ * gets a fresh encoder that codes the warm-up frames preceding the block,   *
+ * throwing their bits away, and then codes the block; it keeps a snapshot   *
+ * of its state before each of the first JOIN_CHECK_FRAMES frames.           *
+ *                                                                           *
+ * When all blocks are coded, the encoder of each block carries on into the  *
+ * next block, as serial coding would, and counts the frames it codes        *
+ * differently. It stops as soon as its state equals the snapshot of the     *
+ * next block's encoder: from there on both encoders code the same bits, so  *
+ * the frames before are replaced by its own and the join is exact. The      *
+ * analysis-by-synthesis loop (excitation, gain and LSP predictors) seldom   *
+ * forgets its past to the last bit, so the states often never meet; the     *
+ * next block then keeps its bits and the seam stays in the pause, and the    *
+ * divergence from serial coding is reported as unbounded (diffFrames -1).   *
+ *--------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "g729a_interface.h"
+#include "g729a_encoder.h"
+
+#if !defined(G729A_PARALLEL_THREADS)
+#if defined(_WIN32)
+#define G729A_PARALLEL_THREADS  0
+#else
+#define G729A_PARALLEL_THREADS  1
+#endif
+#endif
+
+#if defined(G729A_PARALLEL_THREADS) && (G729A_PARALLEL_THREADS == 1)
+#include <pthread.h>
+#endif
+
+#define FRAMESIZE           L_FRAME
+#define JOIN_CHECK_FRAMES   200     /* Frames checked after a join (2 s)     */
+#define MIN_BLOCK_FRAMES    500     /* Shortest block worth a thread (5 s)   */
+#define JOIN_MOVE_FRAMES    125     /* A join moves this far to find a pause */
+#define PAUSE_FRAMES        30      /* Frames of a pause                     */
+
+/* Part of the snapshot that decides the coding, the counters excepted */
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+#define SNAPSHOT_CMP_SIZE   offsetof(g729a_encoder_state, stats)
+#else
+#define SNAPSHOT_CMP_SIZE   sizeof(g729a_encoder_state)
+#endif
+
+typedef struct _g729a_block
+{
+    G729_Word32 first;          /* First frame of the block              */
+    G729_Word32 last;           /* Frame after the block                 */
+    G729_Word32 nChecks;        /* Snapshots in checks                   */
+    G729A_Enc_state state;
+    G729_UWord8 *checks;        /* State before frames first, first+1... */
+    G729A_Join join;            /* Join with the next block              */
+    
+    /* Whole signal */
+    G729_Word16 *speechIn;
+    G729_UWord8 *outData;
+    G729_Word32 warmupFrames;
+    struct _g729a_block *next;
+} g729a_block;
+
+/* Warm-up and coding of a block */
+static void * g729a_Block_Encode(void *arg)
+{
+    g729a_block *block = (g729a_block *)arg;
+    G729_UWord8 bits[BITSTREAM_SIZE];
+    G729_UWord32 size = G729A_Encoder_Get_Snapshot_Size();
+    G729_Word32 i;
+    
+    i = block->first - block->warmupFrames;
+    if ( i < 0 ) i = 0;
+    
+    for ( ; i < block->first; ++i )
+    {
+        G729A_Encoder_Process(block->state, &block->speechIn[i * FRAMESIZE], bits);
+    }
+    
+    for ( ; i < block->last; ++i )
+    {
+        if ( i - block->first < block->nChecks )
+        {
+            G729A_Encoder_Snapshot(block->state, &block->checks[(i - block->first) * size]);
+        }
+        G729A_Encoder_Process(block->state, &block->speechIn[i * FRAMESIZE], &block->outData[i * BITSTREAM_SIZE]);
+    }
+    
+    return NULL;
+}
+
+/* Serial coding from the end of a block into the next one */
+static void * g729a_Block_Join(void *arg)
+{
+    g729a_block *block = (g729a_block *)arg;
+    g729a_block *next = block->next;
+    G729_UWord32 size = G729A_Encoder_Get_Snapshot_Size();
+    G729_UWord8 *snapshot, *bits;
+    G729_Word32 j, i;
+    
+    block->join.frame      = next->first;
+    block->join.diffFrames = 0;
+    block->join.syncFrames = -1;
+    
+    snapshot = (G729_UWord8 *)malloc(size);
+    bits     = (G729_UWord8 *)malloc(BITSTREAM_SIZE * (next->nChecks + 1));
+    
+    for ( j = 0; NULL != snapshot && NULL != bits && j < next->nChecks; ++j )
+    {
+        G729A_Encoder_Snapshot(block->state, snapshot);
+        if ( memcmp(snapshot, &next->checks[j * size], SNAPSHOT_CMP_SIZE) == 0 )
+        {
+            block->join.syncFrames = j;
+            break;
+        }
+        
+        i = next->first + j;
+        G729A_Encoder_Process(block->state, &block->speechIn[i * FRAMESIZE], &bits[j * BITSTREAM_SIZE]);
+        if ( memcmp(&bits[j * BITSTREAM_SIZE], &block->outData[i * BITSTREAM_SIZE], BITSTREAM_SIZE) != 0 )
+        {
+            block->join.diffFrames++;
+        }
+    }
+    
+    /* Serial bits up to where the states meet; if they do not, the */
+    /* next block keeps its own bits and the seam stays at the join */
+    /* and any of its frames past the checked ones may differ too   */
+    
+    if ( block->join.syncFrames < 0 && next->nChecks < next->last - next->first )
+    {
+        block->join.diffFrames = -1;
+    }
+    
+    if ( block->join.syncFrames > 0 )
+    {
+        memcpy(&block->outData[next->first * BITSTREAM_SIZE], bits, BITSTREAM_SIZE * block->join.syncFrames);
+    }
+    
+    free(snapshot);
+    free(bits);
+    return NULL;
+}
+
+/* Frame near the center whose PAUSE_FRAMES following frames are the quietest */
+static G729_Word32 g729a_Find_Pause(G729_Word16 *speechIn, G729_Word32 nFrames, G729_Word32 center)
+{
+    G729_Word32 lo, hi, f, k, best;
+    G729_Word64 energy, bestEnergy = -1;
+    G729_Word16 *x;
+    
+    lo = center - JOIN_MOVE_FRAMES;
+    hi = center + JOIN_MOVE_FRAMES;
+    if ( hi > nFrames - PAUSE_FRAMES ) hi = nFrames - PAUSE_FRAMES;
+    best = center;
+    
+    for ( f = lo; f <= hi; ++f )
+    {
+        energy = 0;
+        x = &speechIn[f * FRAMESIZE];
+        for ( k = 0; k < PAUSE_FRAMES * FRAMESIZE; ++k )
+        {
+            energy += (G729_Word32)x[k] * x[k];
+        }
+        if ( bestEnergy < 0 || energy < bestEnergy )
+        {
+            bestEnergy = energy;
+            best = f;
+        }
+    }
+    
+    return best;
+}
+
+/* Runs fn on blocks 0 .. nBlocks-1, on one thread each when possible */
+static void g729a_Run_Blocks(void * (*fn)(void *), g729a_block *blocks, G729_Word32 nBlocks)
+{
+    G729_Word32 i;
+#if defined(G729A_PARALLEL_THREADS) && (G729A_PARALLEL_THREADS == 1)
+    pthread_t *threads;
+    G729_Word32 *started;
+    
+    if ( nBlocks <= 0 ) return;
+    
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * nBlocks);
+    started = (G729_Word32 *)calloc(nBlocks, sizeof(G729_Word32));
+    
+    if ( NULL != threads && NULL != started )
+    {
+        for ( i = 1; i < nBlocks; ++i )
+        {
+            started[i] = (pthread_create(&threads[i], NULL, fn, &blocks[i]) == 0);
+        }
+        fn(&blocks[0]);
+        for ( i = 1; i < nBlocks; ++i )
+        {
+            if ( started[i] ) pthread_join(threads[i], NULL);
+            else fn(&blocks[i]);
+        }
+        free(threads);
+        free(started);
+        return;
+    }
+    free(threads);
+    free(started);
+#endif
+    
+    for ( i = 0; i < nBlocks; ++i )
+    {
+        fn(&blocks[i]);
+    }
+}
+
+/*---------------------------------------------*
+ * Parallel file functions                     *
+ *---------------------------------------------*/
+
+G729_Word32 G729A_Encoder_Process_Parallel(G729_Word16 * speechIn, G729_Word32 nFrames, G729_UWord8 * outData, G729_Word32 nThreads, G729_Word32 warmupFrames, G729A_Join * joins)
+{
+    g729a_block *blocks;
+    G729_UWord32 size = G729A_Encoder_Get_Snapshot_Size();
+    G729_Word32 nBlocks, i, ret = 0;
+    
+    if ( nFrames < 0 || warmupFrames < 0 ) return -1;
+    if ( nFrames == 0 ) return 0;
+    if ( NULL == speechIn || NULL == outData ) return -1;
+    
+    nBlocks = nFrames / MIN_BLOCK_FRAMES;
+    if ( nBlocks > nThreads ) nBlocks = nThreads;
+    if ( nBlocks < 1 ) nBlocks = 1;
+    
+    blocks = (g729a_block *)calloc(nBlocks, sizeof(g729a_block));
+    if ( NULL == blocks ) return -1;
+    
+    for ( i = 0; i < nBlocks; ++i )
+    {
+        blocks[i].first = (i == 0) ? 0 : blocks[i - 1].last;
+        blocks[i].last  = nFrames;
+        if ( i + 1 < nBlocks )
+        {
+            /* Joins in pauses meet sooner */
+            blocks[i].last = g729a_Find_Pause(speechIn, nFrames,
+                                              (G729_Word32)(((G729_Word64)nFrames * (i + 1)) / nBlocks));
+        }
+        blocks[i].nChecks = 0;
+        if ( i > 0 )
+        {
+            blocks[i].nChecks = blocks[i].last - blocks[i].first;
+            if ( blocks[i].nChecks > JOIN_CHECK_FRAMES ) blocks[i].nChecks = JOIN_CHECK_FRAMES;
+        }
+        blocks[i].speechIn     = speechIn;
+        blocks[i].outData      = outData;
+        blocks[i].warmupFrames = warmupFrames;
+        blocks[i].next         = (i + 1 < nBlocks) ? &blocks[i + 1] : NULL;
+    
+        blocks[i].state = malloc(G729A_Encoder_Get_Size());
+        if ( blocks[i].nChecks > 0 )
+        {
+            blocks[i].checks = (G729_UWord8 *)malloc((size_t)size * blocks[i].nChecks);
+        }
+        if ( NULL == blocks[i].state || (blocks[i].nChecks > 0 && NULL == blocks[i].checks) )
+        {
+            ret = -1;
+            break;
+        }
+        G729A_Encoder_Init(blocks[i].state);
+    }
+    
+    if ( ret == 0 )
+    {
+        g729a_Run_Blocks(g729a_Block_Encode, blocks, nBlocks);
+        g729a_Run_Blocks(g729a_Block_Join, blocks, nBlocks - 1);
+    
+        for ( i = 0; i + 1 < nBlocks; ++i )
+        {
+            if ( NULL != joins ) joins[i] = blocks[i].join;
+        }
+        ret = nBlocks - 1;
+    }
+    
+    for ( i = 0; i < nBlocks; ++i )
+    {
+        free(blocks[i].state);
+        free(blocks[i].checks);
+    }
+    free(blocks);
+    
+    return ret;
+}
@@ -0,0 +1,359 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Channel pool: many independent encoders driven by one call per    *
+ * 10 ms tick.                                                       *
+ *                                                                   *
+ * The encoder states of all channels live in one block, each state  *
+ * starting on its own cache line so that two threads never write to *
+ * the same line. A tick is split in nThreads contiguous slices of   *
+ * the channel list; the calling thread encodes the first slice and  *
+ * nThreads-1 persistent worker threads the others.                  *
+ *                                                                   *
+ * Threads use POSIX threads; build with G729A_POOL_THREADS=0 (the   *
+ * default on Windows) to encode every tick on the calling thread.   *
+ *-------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g729a_interface.h"
+#include "g729a_encoder.h"
+#include "simd_func.h"
+
+#if !defined(G729A_POOL_THREADS)
+#if defined(_WIN32)
+#define G729A_POOL_THREADS  0
+#else
+#define G729A_POOL_THREADS  1
+#endif
+#endif
+
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+#include <pthread.h>
+#endif
+
+#define POOL_ALIGN      64      /* Cache line size */
+#define FRAMESIZE       L_FRAME
+
+typedef struct _g729a_pool
+{
+    G729_Word32 nChannels;
+    G729_Word32 nThreads;
+    G729_UWord32 stride;        /* Bytes from one state to the next  */
+    G729_UWord8 *states;        /* nChannels states, POOL_ALIGN bytes aligned */
+    void *mem;                  /* Block holding the states          */
+    G729_UWord32 *marks;        /* Call that last used each channel  */
+    G729_UWord32 calls;         /* Number of G729A_Pool_Encode calls */
+    
+    /* Current tick */
+    const G729_Word32 *channelIds;
+    G729_Word16 *pcmFrames;
+    G729_UWord8 *outData;
+    G729_Word32 nIds;
+    
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+    pthread_t *threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t start;       /* Signaled when a tick is posted    */
+    pthread_cond_t done;        /* Signaled when a worker is done    */
+    G729_Word32 nStarted;       /* Workers successfully created      */
+    G729_UWord32 tick;          /* Number of ticks posted            */
+    G729_Word32 pending;        /* Workers still busy with the tick  */
+    G729_Word32 quit;
+#endif
+} g729a_pool;
+
+typedef struct _g729a_pool_worker
+{
+    g729a_pool *pool;
+    G729_Word32 index;          /* Slice of the channel list, 1..nThreads-1 */
+} g729a_pool_worker;
+
+static G729A_Enc_state g729a_Pool_State(g729a_pool *pool, G729_Word32 channel)
+{
+    return (G729A_Enc_state)(pool->states + (G729_UWord32)channel * pool->stride);
+}
+
+/* Encodes the slice-th of nSlices parts of the current tick */
+static void g729a_Pool_Encode_Slice(g729a_pool *pool, G729_Word32 slice, G729_Word32 nSlices)
+{
+    G729A_Enc_state states[G729_LANES];
+    G729_Word32 i, n, l, first, last;
+    
+    first = (G729_Word32)(((G729_Word64)pool->nIds * slice) / nSlices);
+    last  = (G729_Word32)(((G729_Word64)pool->nIds * (slice + 1)) / nSlices);
+    
+    for ( i = first; i < last; i += n )
+    {
+        n = (last - i < G729_LANES) ? (last - i) : G729_LANES;
+        
+        for ( l = 0; l < n; ++l )
+        {
+            states[l] = g729a_Pool_State(pool, pool->channelIds[i + l]);
+        }
+        
+        G729A_Encoder_Process_Lanes(states, n, &pool->pcmFrames[i * FRAMESIZE],
+                                    &pool->outData[i * BITSTREAM_SIZE]);
+    }
+}
+
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+
+static void * g729a_Pool_Worker(void *arg)
+{
+    g729a_pool_worker *worker = (g729a_pool_worker *)arg;
+    g729a_pool *pool = worker->pool;
+    G729_UWord32 tick = 0;
+    
+    pthread_mutex_lock(&pool->mutex);
+    for ( ;; )
+    {
+        while ( !pool->quit && pool->tick == tick )
+        {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if ( pool->quit ) break;
+        tick = pool->tick;
+        pthread_mutex_unlock(&pool->mutex);
+        
+        g729a_Pool_Encode_Slice(pool, worker->index, pool->nThreads);
+        
+        pthread_mutex_lock(&pool->mutex);
+        if ( --pool->pending == 0 )
+        {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    
+    free(worker);
+    return NULL;
+}
+
+static void g729a_Pool_Stop_Threads(g729a_pool *pool)
+{
+    G729_Word32 i;
+    
+    pthread_mutex_lock(&pool->mutex);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+    
+    for ( i = 0; i < pool->nStarted; ++i )
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+    
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->threads);
+}
+
+static G729_Word32 g729a_Pool_Start_Threads(g729a_pool *pool)
+{
+    G729_Word32 i;
+    g729a_pool_worker *worker;
+    
+    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * pool->nThreads);
+    if ( NULL == pool->threads ) return -1;
+    
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->nStarted = 0;
+    pool->tick = 0;
+    pool->pending = 0;
+    pool->quit = 0;
+    
+    for ( i = 1; i < pool->nThreads; ++i )
+    {
+        worker = (g729a_pool_worker *)malloc(sizeof(g729a_pool_worker));
+        if ( NULL == worker ) break;
+        worker->pool = pool;
+        worker->index = i;
+        if ( pthread_create(&pool->threads[pool->nStarted], NULL, g729a_Pool_Worker, worker) != 0 )
+        {
+            free(worker);
+            break;
+        }
+        pool->nStarted++;
+    }
+    
+    if ( pool->nStarted != pool->nThreads - 1 )
+    {
+        g729a_Pool_Stop_Threads(pool);
+        return -1;
+    }
+    
+    return 0;
+}
+
+#endif
+
+/*---------------------------------------------*
+ * Pool functions                              *
+ *---------------------------------------------*/
+
+G729A_Pool G729A_Pool_Create(G729_Word32 nChannels, G729_Word32 nThreads)
+{
+    g729a_pool *pool;
+    G729_Word32 i;
+    
+    if ( nChannels <= 0 ) return NULL;
+    if ( nThreads <= 0 ) nThreads = 1;
+    
+#if !defined(G729A_POOL_THREADS) || (G729A_POOL_THREADS != 1)
+    nThreads = 1;
+#endif
+    
+    pool = (g729a_pool *)calloc(1, sizeof(g729a_pool));
+    if ( NULL == pool ) return NULL;
+    
+    pool->nChannels = nChannels;
+    pool->nThreads  = nThreads;
+    pool->stride    = (G729_UWord32)((sizeof(g729a_encoder_state) + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1));
+    
+    pool->mem   = malloc((size_t)pool->stride * nChannels + POOL_ALIGN - 1);
+    pool->marks = (G729_UWord32 *)calloc(nChannels, sizeof(G729_UWord32));
+    if ( NULL == pool->mem || NULL == pool->marks )
+    {
+        free(pool->mem);
+        free(pool->marks);
+        free(pool);
+        return NULL;
+    }
+    pool->states = (G729_UWord8 *)(((size_t)pool->mem + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1));
+    
+    for ( i = 0; i < nChannels; ++i )
+    {
+        G729A_Encoder_Init(g729a_Pool_State(pool, i));
+    }
+    
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+    if ( nThreads > 1 && g729a_Pool_Start_Threads(pool) != 0 )
+    {
+        free(pool->mem);
+        free(pool->marks);
+        free(pool);
+        return NULL;
+    }
+#endif
+    
+    return (G729A_Pool)pool;
+}
+
+G729_Word32 G729A_Pool_Encode(G729A_Pool encPool, const G729_Word32 * channelIds, G729_Word32 nIds, G729_Word16 * pcmFrames, G729_UWord8 * outData)
+{
+    g729a_pool *pool;
+    G729_Word32 i;
+    
+    if ( NULL == encPool ) return -1;
+    if ( nIds < 0 ) return -1;
+    if ( nIds == 0 ) return 0;
+    if ( NULL == channelIds || NULL == pcmFrames || NULL == outData ) return -1;
+    
+    pool = (g729a_pool *)encPool;
+    
+    /* A channel given twice would be encoded by two lanes or threads at once */
+    
+    if ( ++pool->calls == 0 )
+    {
+        memset(pool->marks, 0, sizeof(G729_UWord32) * pool->nChannels);
+        pool->calls = 1;
+    }
+    for ( i = 0; i < nIds; ++i )
+    {
+        if ( channelIds[i] < 0 || channelIds[i] >= pool->nChannels ) return -1;
+        if ( pool->marks[channelIds[i]] == pool->calls ) return -1;
+        pool->marks[channelIds[i]] = pool->calls;
+    }
+    
+    pool->channelIds = channelIds;
+    pool->pcmFrames  = pcmFrames;
+    pool->outData    = outData;
+    pool->nIds       = nIds;
+    
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+    if ( pool->nThreads > 1 )
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pool->pending = pool->nThreads - 1;
+        pool->tick++;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->mutex);
+        
+        g729a_Pool_Encode_Slice(pool, 0, pool->nThreads);
+        
+        pthread_mutex_lock(&pool->mutex);
+        while ( pool->pending > 0 )
+        {
+            pthread_cond_wait(&pool->done, &pool->mutex);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+        
+        return 0;
+    }
+#endif
+    
+    g729a_Pool_Encode_Slice(pool, 0, 1);
+    
+    return 0;
+}
+
+G729A_Enc_state G729A_Pool_Get_Encoder(G729A_Pool encPool, G729_Word32 channel)
+{
+    g729a_pool *pool;
+    if ( NULL == encPool ) return NULL;
+    
+    pool = (g729a_pool *)encPool;
+    if ( channel < 0 || channel >= pool->nChannels ) return NULL;
+    
+    return g729a_Pool_State(pool, channel);
+}
+
+void G729A_Pool_Destroy(G729A_Pool encPool)
+{
+    g729a_pool *pool;
+    if ( NULL == encPool ) return;
+    
+    pool = (g729a_pool *)encPool;
+    
+#if defined(G729A_POOL_THREADS) && (G729A_POOL_THREADS == 1)
+    if ( pool->nThreads > 1 )
+    {
+        g729a_Pool_Stop_Threads(pool);
+    }
+#endif
+    
+    free(pool->mem);
+    free(pool->marks);
+    free(pool);
+}
+/* end of file */
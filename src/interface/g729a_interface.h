@@ -29,9 +29,47 @@
 
 #include "g729a_typedef.h"
 #include "g729a_errors.h"
+#include "g729a_stats.h"
 
 typedef void * G729A_Enc_state;
 typedef void * G729A_Dec_state;
+typedef void * G729A_Pool;
+typedef void * G729A_Level_state;
+
+/* Output of the decoder, see G729A_Decoder_Set_Postfilter */
+#define G729A_POSTFILTER_ON      0  /* Postfilter and high-pass filter (G.729A) */
+#define G729A_POSTFILTER_OFF_HP  1  /* High-pass filter of the raw synthesis    */
+#define G729A_POSTFILTER_OFF     2  /* Raw synthesis, only scaled by 2          */
+
+/* Sizes of the frames of G729A_Encoder_Process_Private_DTX, in bytes; */
+/* the SID frame is not the 2-byte SID of G.729 Annex B                 */
+#define G729A_SPEECH_FRAME_SIZE       10  /* Speech frame                             */
+#define G729A_PRIVATE_SID_FRAME_SIZE   3  /* Silence descriptor, comfort noise update */
+
+/* Decoded parameters of G729A_Decoder_Analyze, one array per parameter   */
+/* over the frames. An array left NULL is not written.                     */
+typedef struct _G729A_Params
+{
+    G729_Word16 * lsp;          /* 10 per frame: quantized LSPs, cosine domain Q15   */
+    G729_Word16 * pitchLag;     /* 2 per frame: integer pitch lag of each subframe   */
+    G729_Word16 * pitchFrac;    /* 2 per frame: fraction of the lag, -1, 0 or 1 /3   */
+    G729_Word16 * gainPitch;    /* 2 per frame: adaptive codebook gain, Q14          */
+    G729_Word16 * gainCode;     /* 2 per frame: fixed codebook gain, Q1              */
+    G729_Word16 * energy;       /* 2 per frame: energy of the fixed codebook         */
+                                /* contribution in dB, Q8, -32768 if the gain is 0   */
+} G729A_Params;
+
+/* Join of two blocks of G729A_Encoder_Process_Parallel */
+typedef struct _G729A_Join
+{
+    G729_Word32 frame;          /* First frame after the join                        */
+    G729_Word32 diffFrames;     /* Frames the warmed-up encoder coded differently    */
+                                /* from serial coding up to where the states met,    */
+                                /* -1 (unbounded) if they did not meet before the    */
+                                /* end of the block                                  */
+    G729_Word32 syncFrames;     /* Frames after the join until the encoder states    */
+                                /* met, -1 if they did not within 200 frames         */
+} G729A_Join;
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +108,70 @@ G729_Word32 G729A_Encoder_Init(G729A_Enc_state encState);
  *               and you can use G729A_Encoder_Get_Error to get the last error code.
  */
 G729_Word32 G729A_Encoder_Process(G729A_Enc_state encState, G729_Word16 * speechIn, G729_UWord8 * outData);
+
+/**
+ *  @brief  Encode several consecutive frames of 16-bit linear PCM data with g729a.
+ *
+ *  Equivalent to calling G729A_Encoder_Process nFrames times, but the whole
+ *  block (e.g. a 20/40/60 ms RTP packet or a complete file) costs one call.
+ *
+ *  @param encState,  Encoder state.
+ *  @param speechIn,  Speech sample input vector (nFrames * 80 samples).
+ *  @param nFrames,   Number of frames to encode.
+ *  @param outData,   Encoded output vector (nFrames * 10 Bytes).
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs,
+ *               and you can use G729A_Encoder_Get_Error to get the last error code.
+ */
+G729_Word32 G729A_Encoder_Process_Frames(G729A_Enc_state encState, G729_Word16 * speechIn, G729_Word32 nFrames, G729_UWord8 * outData);
+
+/**
+ *  @brief  Encode a frame with the private voice activity detection and
+ *          discontinuous transmission (DTX) of this library.
+ *
+ *  Active frames are encoded as by G729A_Encoder_Process. Inactive frames
+ *  skip the LSP quantization and the pitch and codebook searches: the
+ *  encoder sends a silence descriptor (SID) on the first one and when the
+ *  background noise changes, and nothing otherwise. The decoder fills the
+ *  gaps with comfort noise (G729A_Decoder_Process_Private_DTX).
+ *
+ *  This is not G.729 Annex B: the VAD differs and the SID frame is 3 bytes,
+ *  so the stream does not interoperate with G.729B decoders or encoders
+ *  (e.g. RTP payload G729 with annexb=yes). Use it only when both ends run
+ *  this library; a stream encoded with this function must be decoded by
+ *  G729A_Decoder_Process_Private_DTX. G.729 Annex B itself is not
+ *  implemented. The feature is only built with USE_PRIVATE_DTX=1
+ *  (make PRIVATE_DTX=1); otherwise the function returns -1.
+ *
+ *  @param encState,  Encoder state.
+ *  @param speechIn,  Speech sample input vector (80 samples).
+ *  @param outData,   Encoded output vector (up to 10 Bytes).
+ *
+ *  @return   G729A_SPEECH_FRAME_SIZE (10), speech frame
+ *            G729A_PRIVATE_SID_FRAME_SIZE (3), SID frame
+ *            0, nothing to send
+ *           -1, if an error occurs,
+ *               and you can use G729A_Encoder_Get_Error to get the last error code.
+ */
+G729_Word32 G729A_Encoder_Process_Private_DTX(G729A_Enc_state encState, G729_Word16 * speechIn, G729_UWord8 * outData);
+
+/**
+ *  @brief  Encode one frame for each of several independent channels.
+ *
+ *  Frame i is encoded by encStates[i] exactly as with G729A_Encoder_Process,
+ *  but the filters of up to 8 channels run side by side in the vector unit.
+ *  A state must not appear twice in encStates; such a call is rejected.
+ *
+ *  @param encStates, Encoder states (nStates entries).
+ *  @param nStates,   Number of channels.
+ *  @param speechIn,  Speech sample input vector (nStates * 80 samples).
+ *  @param outData,   Encoded output vector (nStates * 10 Bytes).
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs (no frame is encoded)
+ */
+G729_Word32 G729A_Encoder_Process_Lanes(G729A_Enc_state * encStates, G729_Word32 nStates, G729_Word16 * speechIn, G729_UWord8 * outData);
     
 /**
  *  @brief  Get last error code of encoder.
@@ -81,6 +183,58 @@ G729_Word32 G729A_Encoder_Process(G729A_Enc_state encState, G729_Word16 * speech
  */
 G729_Word32 G729A_Encoder_Get_Error(G729A_Enc_state encState);
 
+/**
+ *  @brief  Get the per-stage cycle counters of the encoder (G729A_ENC_STAGE_*
+ *          entries of stats), accumulated since G729A_Encoder_Init.
+ *
+ *  @param encState,  Encoder state.
+ *  @param stats,     Output counters.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs or the library was built without
+ *               USE_STAGE_STATS=1
+ */
+G729_Word32 G729A_Encoder_Get_Stats(G729A_Enc_state encState, G729A_Stats * stats);
+
+/**
+ *  @brief  Get size in bytes of an encoder snapshot.
+ *
+ *  @return  Number of bytes written by G729A_Encoder_Snapshot.
+ */
+G729_UWord32 G729A_Encoder_Get_Snapshot_Size();
+
+/**
+ *  @brief  Save the complete state of an encoder, so that coding can later
+ *          resume from this point, in this or another encoder state.
+ *
+ *  The state holds no pointers: the snapshot is a plain copy of it, of
+ *  G729A_Encoder_Get_Snapshot_Size() bytes (the size depends on the build
+ *  flags), and an encoder state may as well be copied, moved to another
+ *  thread or process, or written to a file with memcpy/fwrite. Encoders
+ *  whose snapshots compare equal with memcmp, the counters of
+ *  G729A_Encoder_Get_Stats excepted, code the following frames identically.
+ *  A snapshot is only valid for the library build that wrote it.
+ *
+ *  @param encState,  Encoder state.
+ *  @param snapshot,  Output buffer of G729A_Encoder_Get_Snapshot_Size() bytes.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Encoder_Snapshot(G729A_Enc_state encState, void * snapshot);
+
+/**
+ *  @brief  Load a snapshot taken with G729A_Encoder_Snapshot into an encoder
+ *          state, which need not be initialized.
+ *
+ *  @param encState,  Encoder state.
+ *  @param snapshot,  Snapshot of G729A_Encoder_Get_Snapshot_Size() bytes.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Encoder_Restore(G729A_Enc_state encState, const void * snapshot);
+
 
 /*---------------------------------------------*
  * Decoder functions                           *
@@ -107,7 +261,7 @@ G729_Word32 G729A_Decoder_Init(G729A_Dec_state decState);
  *  @brief  Decode a frame of g729a encoded bitstream data.
  *
  *  @param decState,   Decoder state.
- *  @param inData,     Encoded input vector (10 Bytes).
+ *  @param inData,     Encoded input vector (10 Bytes, no padding needed).
  *  @param speechOut,  Decoded output speech vector (80 samples).
  *
  *  @return   0, succeeded
@@ -116,6 +270,96 @@ G729_Word32 G729A_Decoder_Init(G729A_Dec_state decState);
  */
 G729_Word32 G729A_Decoder_Process(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word16 * speechOut);
 
+/**
+ *  @brief  Decode several consecutive frames of g729a encoded bitstream data.
+ *
+ *  Equivalent to calling G729A_Decoder_Process nFrames times, except that
+ *  frames flagged in lostMask are not read and are concealed with the
+ *  frame erasure recovery of the decoder instead.
+ *
+ *  @param decState,   Decoder state.
+ *  @param inData,     Encoded input vector (nFrames * 10 Bytes); nothing
+ *                     is read past the last frame, no padding is needed.
+ *  @param nFrames,    Number of frames to decode.
+ *  @param lostMask,   Frame loss bitmask, bit (i & 7) of byte (i >> 3) set
+ *                     means frame i is lost. NULL if no frame is lost.
+ *  @param speechOut,  Decoded output speech vector (nFrames * 80 samples).
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs,
+ *               and you can use G729A_Decoder_Get_Error to get the last error code.
+ */
+G729_Word32 G729A_Decoder_Process_Frames(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729_Word16 * speechOut);
+
+/**
+ *  @brief  Decode a frame of a stream of G729A_Encoder_Process_Private_DTX.
+ *
+ *  The stream is private to this library, not G.729 Annex B (see
+ *  G729A_Encoder_Process_Private_DTX).
+ *
+ *  The frame type follows from its size: a speech frame is decoded as by
+ *  G729A_Decoder_Process, a SID frame updates the comfort noise and
+ *  returns a frame of it. A frame not transmitted (inSize 0) continues
+ *  the comfort noise after a SID frame, and is concealed as a lost frame
+ *  after a speech frame.
+ *
+ *  @param decState,   Decoder state.
+ *  @param inData,     Encoded input vector, may be NULL if inSize is 0.
+ *  @param inSize,     Size of the frame in bytes: 10, 3 or 0.
+ *  @param speechOut,  Decoded output speech vector (80 samples).
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs,
+ *               and you can use G729A_Decoder_Get_Error to get the last error code.
+ */
+G729_Word32 G729A_Decoder_Process_Private_DTX(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 inSize, G729_Word16 * speechOut);
+
+/**
+ *  @brief  Decode only the parameters of several consecutive frames.
+ *
+ *  Walks the bitstream as G729A_Decoder_Process_Frames does, with the same
+ *  lost frame handling, and writes the LSPs, pitch lags and gains of each
+ *  frame, equal to those of a full decode, without computing the
+ *  excitation, the synthesis or the postfilter. This is more than 10 times
+ *  faster than decoding, for analytics that do not need the waveform.
+ *  The synthesis memories of the state are not updated: initialize the
+ *  state again before decoding speech with it.
+ *
+ *  @param decState,  Decoder state.
+ *  @param inData,    Encoded input vector (nFrames * 10 Bytes); nothing
+ *                    is read past the last frame, no padding is needed.
+ *  @param nFrames,   Number of frames to analyze.
+ *  @param lostMask,  Frame loss bitmask as in G729A_Decoder_Process_Frames,
+ *                    NULL if no frame is lost.
+ *  @param params,    Output arrays, of the sizes given in G729A_Params
+ *                    times nFrames.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Decoder_Analyze(G729A_Dec_state decState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729A_Params * params);
+
+/**
+ *  @brief  Select what the decoder outputs, for the frames decoded from now on.
+ *
+ *  G729A_POSTFILTER_ON is the G.729A output and the default after
+ *  G729A_Decoder_Init. The other modes skip the adaptive postfilter, which
+ *  is meant for human listeners, and output the synthesis at the same level
+ *  for speech recognition and analytics: G729A_POSTFILTER_OFF_HP keeps the
+ *  100 Hz high-pass filter, G729A_POSTFILTER_OFF skips it too. On speech
+ *  this decodes about 1.8 and 2.3 times as many frames per second.
+ *  The postfilter memories are not updated while it is off, so switching it
+ *  back on in the middle of a stream may give a short transient.
+ *
+ *  @param decState,  Decoder state.
+ *  @param mode,      G729A_POSTFILTER_ON, G729A_POSTFILTER_OFF_HP or
+ *                    G729A_POSTFILTER_OFF.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Decoder_Set_Postfilter(G729A_Dec_state decState, G729_Word32 mode);
+
 /**
  *  @brief  Get last error code of decoder.
  *
@@ -125,7 +369,236 @@ G729_Word32 G729A_Decoder_Process(G729A_Dec_state decState, G729_UWord8 * inData
  *           otherwise, return the last error code of decoder
  */
 G729_Word32 G729A_Decoder_Get_Error(G729A_Dec_state decState);
+
+/**
+ *  @brief  Get the per-stage cycle counters of the decoder (G729A_DEC_STAGE_*
+ *          entries of stats), accumulated since G729A_Decoder_Init.
+ *
+ *  @param decState,  Decoder state.
+ *  @param stats,     Output counters.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs or the library was built without
+ *               USE_STAGE_STATS=1
+ */
+G729_Word32 G729A_Decoder_Get_Stats(G729A_Dec_state decState, G729A_Stats * stats);
+
+/**
+ *  @brief  Get size in bytes of a decoder snapshot.
+ *
+ *  @return  Number of bytes written by G729A_Decoder_Snapshot.
+ */
+G729_UWord32 G729A_Decoder_Get_Snapshot_Size();
+
+/**
+ *  @brief  Save the complete state of a decoder, so that decoding can later
+ *          resume from this point, in this or another decoder state.
+ *
+ *  Like the encoder state, the decoder state holds no pointers and the
+ *  snapshot is a plain copy of it, of G729A_Decoder_Get_Snapshot_Size()
+ *  bytes.
+ *
+ *  @param decState,  Decoder state.
+ *  @param snapshot,  Output buffer of G729A_Decoder_Get_Snapshot_Size() bytes.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Decoder_Snapshot(G729A_Dec_state decState, void * snapshot);
+
+/**
+ *  @brief  Load a snapshot taken with G729A_Decoder_Snapshot into a decoder
+ *          state, which need not be initialized.
+ *
+ *  @param decState,  Decoder state.
+ *  @param snapshot,  Snapshot of G729A_Decoder_Get_Snapshot_Size() bytes.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Decoder_Restore(G729A_Dec_state decState, const void * snapshot);
+    
     
+/*---------------------------------------------*
+ * Level functions                             *
+ *---------------------------------------------*/
+
+/**
+ *  @brief  Get size in bytes of the level estimator state of a stream.
+ *
+ *  The level estimator reads only the gain indexes of the encoded frames,
+ *  without decoding them, to estimate the level (in dB, of the excitation
+ *  the decoder would build) and the voice activity of a stream.
+ *
+ *  @return  Number of bytes in the level estimator state.
+ */
+G729_UWord32 G729A_Level_Get_Size();
+
+/**
+ *  @brief  Init or reset the level estimator of a stream.
+ *
+ *  @param levelState,  Level estimator state.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Level_Init(G729A_Level_state levelState);
+
+/**
+ *  @brief  Estimate the level and voice activity of consecutive frames of a stream.
+ *
+ *  @param levelState,  Level estimator state.
+ *  @param inData,      Encoded input vector (nFrames * 10 Bytes).
+ *  @param nFrames,     Number of frames.
+ *  @param lostMask,    Frame loss bitmask as in G729A_Decoder_Process_Frames,
+ *                      NULL if no frame is lost.
+ *  @param level,       Level of each frame in dB, Q8 (nFrames entries), or NULL.
+ *  @param active,      1 for each frame with speech, else 0 (nFrames entries), or NULL.
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Level_Process(G729A_Level_state levelState, G729_UWord8 * inData, G729_Word32 nFrames, G729_UWord8 * lostMask, G729_Word16 * level, G729_Word16 * active);
+
+/**
+ *  @brief  Rank the loudest of several streams for one 10 ms tick.
+ *
+ *  Frame i (or bit i of lostMask) goes to the level estimator of stream i,
+ *  then the streams with speech are ranked by their level, smoothed with a
+ *  slow release so that the ranking does not flicker between syllables.
+ *
+ *  @param levelStates,  Level estimator states of the streams (nStates entries).
+ *  @param nStates,      Number of streams.
+ *  @param inData,       Encoded input vector, one frame per stream (nStates * 10 Bytes).
+ *  @param lostMask,     Bitmask of the streams whose frame is lost, or NULL.
+ *  @param nLoudest,     Maximum number of streams to rank.
+ *  @param loudest,      Indexes of the loudest streams with speech, loudest first.
+ *
+ *  @return   Number of indexes written to loudest (0 if nobody speaks),
+ *           -1, if an error occurs
+ */
+G729_Word32 G729A_Level_Rank(G729A_Level_state * levelStates, G729_Word32 nStates, G729_UWord8 * inData, G729_UWord8 * lostMask, G729_Word32 nLoudest, G729_Word32 * loudest);
+    
+    
+/*---------------------------------------------*
+ * Pool functions                              *
+ *---------------------------------------------*/
+
+/**
+ *  @brief  Create a pool of independent encoder channels, initialized as by
+ *          G729A_Encoder_Init, with their states in one cache-aligned block.
+ *
+ *  @param nChannels,  Number of channels, identified by 0 .. nChannels-1.
+ *  @param nThreads,   Number of threads encoding a tick, including the calling
+ *                     thread (1 encodes on the calling thread only).
+ *
+ *  @return  The pool, or NULL if an error occurs.
+ */
+G729A_Pool G729A_Pool_Create(G729_Word32 nChannels, G729_Word32 nThreads);
+
+/**
+ *  @brief  Encode one frame (10 ms tick) for each of several channels of a pool.
+ *
+ *  Frame i is encoded by channel channelIds[i] as with G729A_Encoder_Process.
+ *  A channel must not appear twice in channelIds (such a call is rejected),
+ *  and the pool must not be used by two threads at a time.
+ *
+ *  @param pool,        Encoder pool.
+ *  @param channelIds,  Channels to run (nIds entries).
+ *  @param nIds,        Number of channels to run.
+ *  @param pcmFrames,   Speech sample input vector (nIds * 80 samples).
+ *  @param outData,     Encoded output vector (nIds * 10 Bytes).
+ *
+ *  @return   0, succeeded
+ *           -1, if an error occurs (no frame is encoded)
+ */
+G729_Word32 G729A_Pool_Encode(G729A_Pool pool, const G729_Word32 * channelIds, G729_Word32 nIds, G729_Word16 * pcmFrames, G729_UWord8 * outData);
+
+/**
+ *  @brief  Get the encoder state of a channel of a pool, e.g. to reset it with
+ *          G729A_Encoder_Init when a new call starts on the channel.
+ *
+ *  @param pool,     Encoder pool.
+ *  @param channel,  Channel number.
+ *
+ *  @return  The encoder state, or NULL if an error occurs.
+ */
+G729A_Enc_state G729A_Pool_Get_Encoder(G729A_Pool pool, G729_Word32 channel);
+
+/**
+ *  @brief  Stop the threads of a pool and free it.
+ *
+ *  @param pool,  Encoder pool.
+ */
+void G729A_Pool_Destroy(G729A_Pool pool);
+    
+    
+/*---------------------------------------------*
+ * File functions                              *
+ *---------------------------------------------*/
+
+/**
+ *  @brief  Encode a long signal, e.g. a whole recording, on several threads.
+ *
+ *  The signal is cut into one block per thread (blocks are at least 500
+ *  frames long), at the quietest point near each cut. The encoder of each
+ *  block but the first starts with warmupFrames frames of serial coding of
+ *  the signal preceding the block. Serial coding is then carried on past each
+ *  join, for up to 200 frames, until the two encoder states meet: the frames
+ *  up to there are replaced and the join is exact. The states often never
+ *  meet, the coding loop remembering its past to the last bit; the block then
+ *  keeps the bits of its warmed-up encoder.
+ *  When every join has syncFrames >= 0, the output is exactly what
+ *  G729A_Encoder_Process_Frames on a fresh encoder returns.
+ *
+ *  @param speechIn,      Speech sample input vector (nFrames * 80 samples).
+ *  @param nFrames,       Number of frames to encode.
+ *  @param outData,       Encoded output vector (nFrames * 10 Bytes).
+ *  @param nThreads,      Number of blocks and threads, including the calling
+ *                        thread.
+ *  @param warmupFrames,  Frames coded before each block to warm its encoder up.
+ *  @param joins,         Output report of each join (nThreads - 1 entries),
+ *                        may be NULL.
+ *
+ *  @return  The number of joins (blocks - 1), or -1 if an error occurs
+ */
+G729_Word32 G729A_Encoder_Process_Parallel(G729_Word16 * speechIn, G729_Word32 nFrames, G729_UWord8 * outData, G729_Word32 nThreads, G729_Word32 warmupFrames, G729A_Join * joins);
+
+/**
+ *  @brief  Encode a speech file into a bitstream file of 10 bytes per frame.
+ *
+ *  The input is an 8 kHz mono 16-bit PCM WAV file, or raw 16-bit PCM if it
+ *  does not start with a RIFF/WAVE header. It is read 1000 frames at a time,
+ *  so memory use does not depend on its length; a partial last frame is
+ *  padded with zeros.
+ *
+ *  @param inPath,   Speech file.
+ *  @param outPath,  Bitstream file, created or truncated.
+ *  @param nFrames,  Output number of frames encoded, may be NULL.
+ *
+ *  @return   0, succeeded
+ *           -1, if a file cannot be opened, read or written, or the WAV
+ *               file is not 8 kHz mono 16-bit PCM
+ */
+G729_Word32 G729A_Encode_File(const char * inPath, const char * outPath, G729_Word64 * nFrames);
+
+/**
+ *  @brief  Decode a bitstream file of 10 bytes per frame into a speech file.
+ *
+ *  The input is read 1000 frames at a time; a partial last frame is dropped.
+ *  The WAV header is written first with unknown sizes, then completed when
+ *  the output file can seek.
+ *
+ *  @param inPath,   Bitstream file.
+ *  @param outPath,  Speech file, created or truncated.
+ *  @param wavOut,   1 writes an 8 kHz mono 16-bit WAV file, 0 raw PCM.
+ *  @param nFrames,  Output number of frames decoded, may be NULL.
+ *
+ *  @return   0, succeeded
+ *           -1, if a file cannot be opened, read or written
+ */
+G729_Word32 G729A_Decode_File(const char * inPath, const char * outPath, G729_Word32 wavOut, G729_Word64 * nFrames);
+
     
 /*---------------------------------------------*
  * Generic functions                           *
@@ -0,0 +1,77 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __G729A_STATS_H__
+#define __G729A_STATS_H__
+
+#include "g729a_typedef.h"
+
+/*---------------------------------------------*
+ * Per-stage cycle counters, filled only when  *
+ * the library is built with USE_STAGE_STATS=1 *
+ * (make STATS=1). Counts are CPU cycles (TSC) *
+ * on x86 and nanoseconds elsewhere.           *
+ *---------------------------------------------*/
+
+#define G729A_STATS_MAX_STAGES  8
+
+/*---------------------------------------------*
+ * Encoder stages                              *
+ *---------------------------------------------*/
+
+#define G729A_ENC_STAGE_PRE_PROCESS  0  /* High-pass filter and scaling          */
+#define G729A_ENC_STAGE_LPC          1  /* Autocorr, Levinson, A(z) to LSP       */
+#define G729A_ENC_STAGE_LSP_QUANT    2  /* LSP quantization and interpolation    */
+#define G729A_ENC_STAGE_OL_PITCH     3  /* Weighted speech and open-loop pitch   */
+#define G729A_ENC_STAGE_CL_PITCH     4  /* Impulse response, target and          */
+                                        /* closed-loop pitch search              */
+#define G729A_ENC_STAGE_TAMING       5  /* Taming test and pitch gain clipping   */
+#define G729A_ENC_STAGE_ACELP        6  /* Codebook target and search            */
+#define G729A_ENC_STAGE_GAIN         7  /* Gain VQ, excitation, taming error and */
+                                        /* filter memory update                  */
+#define G729A_ENC_STAGE_NUM          8
+
+/*---------------------------------------------*
+ * Decoder stages                              *
+ *---------------------------------------------*/
+
+#define G729A_DEC_STAGE_LSP          0  /* LSP decoding and interpolation        */
+#define G729A_DEC_STAGE_EXCITATION   1  /* Pitch, codebook and gain decoding     */
+#define G729A_DEC_STAGE_SYNTHESIS    2  /* Synthesis filter                      */
+#define G729A_DEC_STAGE_OVERFLOW     3  /* Excitation rescaling on overflow      */
+#define G729A_DEC_STAGE_POSTFILTER   4  /* Adaptive postfilter                   */
+#define G729A_DEC_STAGE_POST_PROCESS 5  /* High-pass filter and upscaling        */
+#define G729A_DEC_STAGE_NUM          6
+
+typedef struct _G729A_Stats
+{
+    G729_Word64 frames;                          /* Frames processed            */
+    G729_Word64 cycles[G729A_STATS_MAX_STAGES];  /* Time spent in each stage    */
+    G729_Word64 calls[G729A_STATS_MAX_STAGES];   /* Times each stage was run    */
+} G729A_Stats;
+
+#endif  /* __G729A_STATS_H__ */
+/* end of file */
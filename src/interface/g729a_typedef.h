@@ -44,6 +44,11 @@ typedef int             G729_Flag;
 typedef char            G729_Word8;
 typedef short           G729_Word16;
 typedef int             G729_Word32;
+#if defined(_MSC_VER)
+typedef __int64         G729_Word64;
+#else
+typedef long long       G729_Word64;
+#endif
 typedef unsigned char   G729_UWord8;
 typedef unsigned short  G729_UWord16;
 typedef unsigned int    G729_UWord32;
@@ -114,7 +114,9 @@ void g729_Levinson(
   G729_Word16 Rh[],      /* (i)     : Rh[m+1] Vector of autocorrelations (msb) */
   G729_Word16 Rl[],      /* (i)     : Rl[m+1] Vector of autocorrelations (lsb) */
   G729_Word16 A[],       /* (o) Q12 : A[m]    LPC coefficients  (m = 10)       */
-  G729_Word16 rc[]       /* (o) Q15 : rc[M]   Relection coefficients.          */
+  G729_Word16 rc[],      /* (o) Q15 : rc[M]   Relection coefficients.          */
+  G729_Word16 old_A[],   /* (i/o)   : Last A(z) for case of unstable filter    */
+  G729_Word16 old_rc[]   /* (i/o)   : Last rc[0], rc[1] for unstable filter    */
 );
 
 void g729_Az_lsp(
@@ -123,6 +125,12 @@ void g729_Az_lsp(
   G729_Word16 old_lsp[]   /* (i)     : old lsp[] (in case not found 10 roots) */
 );
 
+void g729_Az_lsp_ref(     /* g729_Az_lsp() with the ITU Chebyshev evaluation only */
+  G729_Word16 a[],        /* (i) Q12 : predictor coefficients              */
+  G729_Word16 lsp[],      /* (o) Q15 : line spectral pairs                 */
+  G729_Word16 old_lsp[]   /* (i)     : old lsp[] (in case not found 10 roots) */
+);
+
 void g729_Lsp_Az(
   G729_Word16 lsp[],    /* (i) Q15 : line spectral frequencies            */
   G729_Word16 a[]       /* (o) Q12 : predictor coefficients (order = 10)  */
@@ -191,6 +199,8 @@ void g729_Convolve(
 #define UP_SAMP         3
 #define L_INTER10       10
 #define FIR_SIZE_SYN    (UP_SAMP*L_INTER10+1)
+#define INTER_TAPS      (2*L_INTER10+2)   /* taps of g729_inter_3l_taps[]     */
+#define INTER_TAPS_ABS  59398L            /* largest sum of their |taps|      */
 
 /*-----------------------*
  * Pitch functions.      *
@@ -252,6 +262,13 @@ void g729_Pred_lt_3(
   G729_Word16   L_subfr      /* input : subframe size     */
 );
 
+void g729_Pred_lt_3_fracs(
+  G729_Word16   exc[],       /* input : excitation buffer                  */
+  G729_Word16   T0,          /* input : integer pitch lag                  */
+  G729_Word16   L_subfr,     /* input : subframe size, <= L_SUBFR          */
+  G729_Word16   y[][L_SUBFR] /* output: fractions 0, -1/3 and +1/3         */
+);
+
 G729_Word16 g729_Parity_Pitch(    /* output: parity bit (XOR of 6 MSB bits)    */
    G729_Word16 pitch_index   /* input : index for which parity to compute */
 );
@@ -285,6 +302,16 @@ void g729_Cor_h_X(
 #define _1_8    (G729_Word16)( 4096)
 #define _1_16   (G729_Word16)( 2048)
 
+void g729_Cor_h(
+  G729_Word16 *H,             /* (i) Q12 :Impulse response of filters  */
+  G729_Word16 *rr             /* (o)     :Correlations of H[]          */
+);
+
+void g729_Cor_h_ref(          /* g729_Cor_h() with the ITU loops only  */
+  G729_Word16 *H,             /* (i) Q12 :Impulse response of filters  */
+  G729_Word16 *rr             /* (o)     :Correlations of H[]          */
+);
+
 G729_Word16  g729_ACELP_Code_A(    /* (o)     :index of pulses positions    */
   G729_Word16 x[],            /* (i)     :Target vector                */
   G729_Word16 h[],            /* (i) Q12 :Inpulse response of filters  */
@@ -422,6 +449,9 @@ void  g729_bits2prm_ld8k(G729_Word16 bits[], G729_Word16 prm[]);
 void  g729_prm2bits_ld8k_compressed(G729_Word16 prm[], G729_UWord8 bits[]);
 void  g729_bits2prm_ld8k_compressed(G729_UWord8 bits[], G729_Word16 prm[]);
 
+void  g729_prm2bits_sid(G729_Word16 prm[], G729_UWord8 bits[]);
+void  g729_bits2prm_sid(G729_UWord8 bits[], G729_Word16 prm[]);
+
 #define SYNC_WORD (short)0x6b21 /* definition of frame erasure flag          */
 #define SIZE_WORD (short)80     /* number of speech bits                     */
 
@@ -467,7 +497,22 @@ void g729_Set_zero(
   G729_Word16 L          /* (i)    : length of vector    */
 );
 
-G729_Word16 g729_Random(void);
+G729_Word16 g729_Random(
+  G729_Word16 *seed      /* (i/o)  : generator state, initialized to 21845 */
+);
+
+/*--------------------------------------------------------------------------*
+ * Comfort noise, shared by the encoder and the decoder (calcexc.c).        *
+ *--------------------------------------------------------------------------*/
+
+#define INIT_SEED   11111   /* Seed of the comfort noise generator         */
+
+void g729_Calc_exc_rand(
+  G729_Word16 *cur_gain, /* (i/o) Q15 : smoothed noise gain                */
+  G729_Word16 sid_gain,  /* (i)   Q15 : noise gain of the last SID         */
+  G729_Word16 exc[],     /* (o)       : excitation of the frame (L_FRAME)  */
+  G729_Word16 *seed      /* (i/o)     : generator state                    */
+);
     
 #ifdef __cplusplus
 }
@@ -71,6 +71,7 @@
 
 #include "ld8a.h"
 #include "tab_ld8a.h"
+#include "simd_func.h"
 
 void g729_Autocorr(
     G729_Word16 x[],      /* (i)    : Input signal                      */
@@ -79,7 +80,7 @@ void g729_Autocorr(
     G729_Word16 r_l[]     /* (o)    : Autocorrelations  (lsb)           */
 )
 {
-    G729_Word16 i, j, norm;
+    G729_Word16 i, norm;
     G729_Word16 y[L_WINDOW];
     G729_Word32 sum;
     
@@ -102,19 +103,9 @@ void g729_Autocorr(
 
 #if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
         G729A_Overflow_Flag = 0;
-        for(i=0; i<L_WINDOW; i++)
-            sum = g729_L_mac(sum, y[i], y[i]);
+        sum = g729_Dot_mac(sum, y, y, L_WINDOW, 0);
 #else
-        overflow = 0;
-        for ( i = 0; i < L_WINDOW; ++i)
-        {
-            sum += (((G729_Word32)y[i] * (G729_Word32)y[i]) << 1);
-            if ( sum < 0 )
-            {
-                overflow = 1;
-                break;
-            }
-        }
+        sum = g729_Dot_mac(sum, y, y, L_WINDOW, &overflow);
 #endif
         /* If overflow divide y[] by 4 */
         
@@ -145,9 +136,7 @@ void g729_Autocorr(
     
     for (i = 1; i <= m; i++)
     {
-        sum = 0;
-        for(j=0; j<L_WINDOW-i; j++)
-            sum = g729_L_mac(sum, y[j], y[j+i]);
+        sum = g729_Dot_mac(0, y, &y[i], (G729_Word16)(L_WINDOW-i), 0);
         
         sum = g729_L_shl(sum, norm);
         g729_L_Extract(sum, &r_h[i], &r_l[i]);
@@ -255,16 +244,13 @@ void g729_Lag_window(
  */
 
 
-/* Last A(z) for case of unstable filter */
-
-static G729_Word16 old_A[M+1]={4096,0,0,0,0,0,0,0,0,0,0};
-static G729_Word16 old_rc[2]={0,0};
-
 void g729_Levinson(
     G729_Word16 Rh[],      /* (i)     : Rh[M+1] Vector of autocorrelations (msb) */
     G729_Word16 Rl[],      /* (i)     : Rl[M+1] Vector of autocorrelations (lsb) */
     G729_Word16 A[],       /* (o) Q12 : A[M]    LPC coefficients  (m = 10)       */
-    G729_Word16 rc[]       /* (o) Q15 : rc[M]   Reflection coefficients.         */
+    G729_Word16 rc[],      /* (o) Q15 : rc[M]   Reflection coefficients.         */
+    G729_Word16 old_A[],   /* (i/o)   : Last A(z) for case of unstable filter    */
+    G729_Word16 old_rc[]   /* (i/o)   : Last rc[0], rc[1] for unstable filter    */
 )
 {
     G729_Word16 i, j;
@@ -405,6 +391,9 @@ void g729_Levinson(
 
 /* local function */
 
+static void Az_lsp(G729_Word16 a[], G729_Word16 lsp[], G729_Word16 old_lsp[], G729_Flag fast);
+static G729_Word16 Chebps(G729_Word16 x, G729_Word16 f[], G729_Word16 q, G729_Flag fast);
+static G729_Word16 Chebps_fast(G729_Word16 x, G729_Word16 f[], G729_Word16 q);
 static G729_Word16 Chebps_11(G729_Word16 x, G729_Word16 f[], G729_Word16 n);
 static G729_Word16 Chebps_10(G729_Word16 x, G729_Word16 f[], G729_Word16 n);
 
@@ -413,15 +402,51 @@ void g729_Az_lsp(
     G729_Word16 lsp[],      /* (o) Q15 : line spectral pairs                 */
     G729_Word16 old_lsp[]   /* (i)     : old lsp[] (in case not found 10 roots) */
 )
+{
+    Az_lsp(a, lsp, old_lsp, 1);
+}
+
+/*-------------------------------------------------------------*
+ *  procedure g729_Az_lsp_ref:                                 *
+ *            ~~~~~~~~~~~~~~                                   *
+ *   Same as g729_Az_lsp() with the ITU Chebyshev evaluation   *
+ *   only.                                                     *
+ *-------------------------------------------------------------*/
+
+void g729_Az_lsp_ref(
+    G729_Word16 a[],        /* (i) Q12 : predictor coefficients              */
+    G729_Word16 lsp[],      /* (o) Q15 : line spectral pairs                 */
+    G729_Word16 old_lsp[]   /* (i)     : old lsp[] (in case not found 10 roots) */
+)
+{
+    Az_lsp(a, lsp, old_lsp, 0);
+}
+
+/*-------------------------------------------------------------*
+ * The roots are searched for on the grid of g729_grid[]: the  *
+ * polynomial is evaluated at each grid point until its sign   *
+ * changes, then twice in the interval. With fast set, the     *
+ * evaluations use Chebps_fast() and the values at all grid    *
+ * points of both polynomials are computed beforehand with     *
+ * g729_Chebps_grid() when the vector unit can.                *
+ *-------------------------------------------------------------*/
+
+static void Az_lsp(
+    G729_Word16 a[],        /* (i) Q12 : predictor coefficients              */
+    G729_Word16 lsp[],      /* (o) Q15 : line spectral pairs                 */
+    G729_Word16 old_lsp[],  /* (i)     : old lsp[] (in case not found 10 roots) */
+    G729_Flag   fast        /* (i)     : 0 for the ITU evaluation only       */
+)
 {
     G729_Word16 i, j, nf, ip;
     G729_Word16 xlow, ylow, xhigh, yhigh, xmid, ymid, xint;
     G729_Word16 x, y, sign, exp;
-    G729_Word16 *coef;
+    G729_Word16 *coef, *grid_y;
     G729_Word16 f1[M/2+1], f2[M/2+1];
+    G729_Word16 grid_y1[GRID_POINTS+1], grid_y2[GRID_POINTS+1];
     G729_Word32 t0, L_temp;
-    G729_Flag   ovf_coef;
-    G729_Word16 (*pChebps)(G729_Word16 x, G729_Word16 f[], G729_Word16 n);
+    G729_Flag   ovf_coef, use_grid;
+    G729_Word16 q;          /* Q format of f1[] and f2[], 11 or 10 */
     
     /* add '#if' to avoid warning(-Wunused-variable) */
 #if !defined(USE_GLOBAL_OVERFLOW_FLAG) || (USE_GLOBAL_OVERFLOW_FLAG != 1)
@@ -443,7 +468,7 @@ void g729_Az_lsp(
      *-------------------------------------------------------------*/
     
     ovf_coef = 0;
-    pChebps = Chebps_11;
+    q = 11;
     
     f1[0] = 2048;          /* f1[0] = 1.0 is in Q11 */
     f2[0] = 2048;          /* f2[0] = 1.0 is in Q11 */
@@ -515,7 +540,7 @@ void g729_Az_lsp(
     if ( ovf_coef ) {
         /*printf("===== OVF ovf_coef =====\n");*/
         
-        pChebps = Chebps_10;
+        q = 10;
         
         f1[0] = 1024;          /* f1[0] = 1.0 is in Q10 */
         f2[0] = 1024;          /* f2[0] = 1.0 is in Q10 */
@@ -543,8 +568,15 @@ void g729_Az_lsp(
     
     coef = f1;
     
+    /* Values of both polynomials at the grid points, in one pass */
+    
+    use_grid = fast
+            && g729_Chebps_grid(f1, q, g729_grid, GRID_POINTS+1, grid_y1) == 0
+            && g729_Chebps_grid(f2, q, g729_grid, GRID_POINTS+1, grid_y2) == 0;
+    grid_y = grid_y1;
+    
     xlow = g729_grid[0];
-    ylow = (*pChebps)(xlow, coef, NC);
+    ylow = use_grid ? grid_y[0] : Chebps(xlow, coef, q, fast);
     
     j = 0;
     while ( (nf < M) && (j < GRID_POINTS) )
@@ -553,7 +585,7 @@ void g729_Az_lsp(
         xhigh = xlow;
         yhigh = ylow;
         xlow  = g729_grid[j];
-        ylow  = (*pChebps)(xlow,coef,NC);
+        ylow  = use_grid ? grid_y[j] : Chebps(xlow, coef, q, fast);
         
         L_temp = g729_L_mult(ylow ,yhigh);
         if ( L_temp <= (G729_Word32)0)
@@ -565,7 +597,7 @@ void g729_Az_lsp(
             {
                 xmid = g729_add( g729_shr(xlow, 1) , g729_shr(xhigh, 1)); /* xmid = (xlow + xhigh)/2 */
                 
-                ymid = (*pChebps)(xmid,coef,NC);
+                ymid = Chebps(xmid, coef, q, fast);
                 
                 L_temp = g729_L_mult(ylow,ymid);
                 if ( L_temp <= (G729_Word32)0)
@@ -618,13 +650,15 @@ void g729_Az_lsp(
             {
                 ip = 1;
                 coef = f2;
+                grid_y = grid_y2;
             }
             else
             {
                 ip = 0;
                 coef = f1;
+                grid_y = grid_y1;
             }
-            ylow = (*pChebps)(xlow,coef,NC);
+            ylow = Chebps(xlow, coef, q, fast);
             
         }
     }
@@ -644,6 +678,86 @@ void g729_Az_lsp(
     return;
 }
 
+/*--------------------------------------------------------------*
+ * function  Chebps:                                            *
+ *           ~~~~~~                                             *
+ *    Chebps_fast() or the ITU evaluation of f[] in Qq          *
+ *--------------------------------------------------------------*/
+static G729_Word16 Chebps(G729_Word16 x, G729_Word16 f[], G729_Word16 q, G729_Flag fast)
+{
+    if ( fast )
+    {
+        return Chebps_fast(x, f, q);
+    }
+    
+    return (q == 11) ? Chebps_11(x, f, NC) : Chebps_10(x, f, NC);
+}
+
+/*--------------------------------------------------------------*
+ * function  Chebps_fast:                                       *
+ *           ~~~~~~~~~~~                                        *
+ *    Chebps_11() (q = 11) or Chebps_10() (q = 10) in plain     *
+ *    integer arithmetic.                                       *
+ *                                                              *
+ *  The double precision b1, b2 are kept as the 32-bit words    *
+ *  they were extracted from: hi = b >> 16, lo = (b & 0xffff)   *
+ *  >> 1. Each step of the ITU chain is computed in 64 bits;    *
+ *  if any leaves the 32-bit range, the ITU chain saturated     *
+ *  and is run instead. The final L_shl() saturates as usual.   *
+ *--------------------------------------------------------------*/
+static G729_Word16 Chebps_fast(G729_Word16 x, G729_Word16 f[], G729_Word16 q)
+{
+    G729_Word16 i, shift;
+    G729_Word32 b0, b1, b2;
+    G729_Word64 t0, ovf;
+    
+    b2 = (G729_Word32)1 << (q + 13);                          /* b2 = 1.0 in Q(q+13) */
+    b1 = (G729_Word32)x * (1 << (q - 1)) + f[1] * 8192;       /* b1 = 2*x + f[1]     */
+    ovf = 0;
+    
+    for (i = 2; i <= NC; i++)
+    {
+        t0  = 2 * (G729_Word64)(b1 >> 16) * x;                /* t0 = x*b1           */
+        ovf |= t0 + 0x80000000LL;
+        t0 += 2 * ((((b1 & 0xffff) >> 1) * (G729_Word32)x) >> 15);
+        ovf |= t0 + 0x80000000LL;
+        
+        if (i < NC)
+        {
+            t0 *= 2;                                          /* t0 = 2.0*x*b1       */
+            ovf |= t0 + 0x80000000LL;
+        }
+        
+        ovf |= -(G729_Word64)(b2 >> 16) * 65536 + 0x80000000LL;
+        t0 -= (G729_Word64)(b2 >> 16) * 65536;                /* t0 -= b2            */
+        ovf |= t0 + 0x80000000LL;
+        t0 -= b2 & 0xfffe;
+        ovf |= t0 + 0x80000000LL;
+        t0 += f[i] * ((i < NC) ? 8192 : 4096);                /* t0 += f[i], f[n]/2  */
+        ovf |= t0 + 0x80000000LL;
+        
+        b0 = (G729_Word32)t0;
+        b2 = b1;
+        b1 = b0;
+    }
+    
+    if ( (ovf >> 32) != 0 )
+    {
+        return (q == 11) ? Chebps_11(x, f, NC) : Chebps_10(x, f, NC);
+    }
+    
+    shift = 17 - q;                           /* Q(q+13) to Q30 with saturation */
+    if (b1 > (G729A_MAX_32 >> shift))
+    {
+        return G729A_MAX_16;
+    }
+    if (b1 < (G729A_MIN_32 >> shift))
+    {
+        return G729A_MIN_16;
+    }
+    return (G729_Word16)((b1 * (1 << shift)) >> 16);           /* Result in Q14 */
+}
+
 /*--------------------------------------------------------------*
  * function  Chebps_11, Chebps_10:                              *
  *           ~~~~~~~~~~~~~~~~~~~~                               *
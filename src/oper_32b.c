@@ -64,6 +64,9 @@
  |___________________________________________________________________________|
  */
 
+/* With USE_INLINE_BASIC_OP these come from oper_32b_inline.h */
+#if !defined(USE_INLINE_BASIC_OP) || (USE_INLINE_BASIC_OP != 1)
+
 /*___________________________________________________________________________
  |                                                                           |
  |  Function g729_L_Extract()                                                |
@@ -176,6 +179,8 @@ G729_Word32 g729_Mpy_32_16(G729_Word16 hi, G729_Word16 lo, G729_Word16 n)
     return( L_32 );
 }
 
+#endif  /* USE_INLINE_BASIC_OP */
+
 /*___________________________________________________________________________
  |                                                                           |
  |   Function Name : g729_Div_32                                             |
@@ -46,10 +46,19 @@ extern "C" {
     
 /* Double precision operations */
 
+#if defined(USE_INLINE_BASIC_OP) && (USE_INLINE_BASIC_OP == 1)
+
+#include "oper_32b_inline.h"
+
+#else
+
 void g729_L_Extract(G729_Word32 L_32, G729_Word16 *hi, G729_Word16 *lo);
 G729_Word32 g729_L_Comp(G729_Word16 hi, G729_Word16 lo);
 G729_Word32 g729_Mpy_32(G729_Word16 hi1, G729_Word16 lo1, G729_Word16 hi2, G729_Word16 lo2);
 G729_Word32 g729_Mpy_32_16(G729_Word16 hi, G729_Word16 lo, G729_Word16 n);
+
+#endif  /* USE_INLINE_BASIC_OP */
+
 G729_Word32 g729_Div_32(G729_Word32 L_num, G729_Word16 denom_hi, G729_Word16 denom_lo);
 
 #ifdef __cplusplus
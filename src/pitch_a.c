@@ -68,6 +68,7 @@
 #include "oper_32b.h"
 #include "ld8a.h"
 #include "tab_ld8a.h"
+#include "simd_func.h"
 
 /*---------------------------------------------------------------------------*
  * Function  g729_Pitch_ol_fast                                              *
@@ -88,7 +89,7 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
     G729_Word16  max1, max2, max3;
     G729_Word16  max_h, max_l, ener_h, ener_l;
     G729_Word16  T1, T2, T3;
-    G729_Word16  *p, *p1;
+    G729_Word16  *p;
     G729_Word32  max, sum, L_temp;
     
     /* Scaled signal */
@@ -112,22 +113,13 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
 #if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
     
     G729A_Overflow_Flag = 0;
-    for(i= -pit_max; i< L_frame; i+=2)
-        sum = g729_L_mac(sum, signal[i], signal[i]);
+    sum = g729_Dot_mac_even(sum, &signal[-pit_max], &signal[-pit_max],
+                            (G729_Word16)(L_frame+pit_max), 0);
     
 #else
     
-    overflow = 0;
-    for ( i = -pit_max; i < L_frame; i += 2 )
-    {
-        sum += (((G729_Word32)signal[i] * (G729_Word32)signal[i]) << 1);
-        if ( sum < 0 )
-        {
-            overflow = 1;
-            sum = G729A_MAX_32;
-            break;
-        }
-    }
+    sum = g729_Dot_mac_even(sum, &signal[-pit_max], &signal[-pit_max],
+                            (G729_Word16)(L_frame+pit_max), &overflow);
 #endif
     
     /* Anyway, sum MUST be positive */
@@ -186,21 +178,15 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
     max = G729A_MIN_32;
     T1  = 20;    /* Only to remove warning from some compilers */
     for (i = 20; i < 40; i++) {
-        p  = scal_sig;
-        p1 = &scal_sig[-i];
-        sum = 0;
-        for (j=0; j<L_frame; j+=2, p+=2, p1+=2)
-            sum = g729_L_mac(sum, *p, *p1);
+        sum = g729_Dot_mac_even(0, scal_sig, &scal_sig[-i], L_frame, 0);
         L_temp = g729_L_sub(sum, max);
         if (L_temp > 0) { max = sum; T1 = i;   }
     }
     
     /* compute energy of maximum */
     
-    sum = 1;                   /* to avoid division by zero */
     p = &scal_sig[-T1];
-    for(i=0; i<L_frame; i+=2, p+=2)
-        sum = g729_L_mac(sum, *p, *p);
+    sum = g729_Dot_mac_even(1, p, p, L_frame, 0);   /* 1: to avoid division by zero */
     
     /* max1 = max/sqrt(energy)                  */
     /* This result will always be on 16 bits !! */
@@ -216,21 +202,15 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
     max = G729A_MIN_32;
     T2  = 40;    /* Only to remove warning from some compilers */
     for (i = 40; i < 80; i++) {
-        p  = scal_sig;
-        p1 = &scal_sig[-i];
-        sum = 0;
-        for (j=0; j<L_frame; j+=2, p+=2, p1+=2)
-            sum = g729_L_mac(sum, *p, *p1);
+        sum = g729_Dot_mac_even(0, scal_sig, &scal_sig[-i], L_frame, 0);
         L_temp = g729_L_sub(sum, max);
         if (L_temp > 0) { max = sum; T2 = i;   }
     }
     
     /* compute energy of maximum */
     
-    sum = 1;                   /* to avoid division by zero */
     p = &scal_sig[-T2];
-    for(i=0; i<L_frame; i+=2, p+=2)
-        sum = g729_L_mac(sum, *p, *p);
+    sum = g729_Dot_mac_even(1, p, p, L_frame, 0);   /* 1: to avoid division by zero */
     
     /* max2 = max/sqrt(energy)                  */
     /* This result will always be on 16 bits !! */
@@ -246,11 +226,7 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
     max = G729A_MIN_32;
     T3  = 80;    /* Only to remove warning from some compilers */
     for (i = 80; i < 143; i+=2) {
-        p  = scal_sig;
-        p1 = &scal_sig[-i];
-        sum = 0;
-        for (j=0; j<L_frame; j+=2, p+=2, p1+=2)
-            sum = g729_L_mac(sum, *p, *p1);
+        sum = g729_Dot_mac_even(0, scal_sig, &scal_sig[-i], L_frame, 0);
         L_temp = g729_L_sub(sum, max);
         if (L_temp > 0) { max = sum; T3 = i;   }
     }
@@ -258,28 +234,18 @@ G729_Word16 g729_Pitch_ol_fast(  /* output: open loop pitch lag
     /* Test around max3 */
     
     i = T3;
-    p  = scal_sig;
-    p1 = &scal_sig[-(i+1)];
-    sum = 0;
-    for (j=0; j<L_frame; j+=2, p+=2, p1+=2)
-        sum = g729_L_mac(sum, *p, *p1);
+    sum = g729_Dot_mac_even(0, scal_sig, &scal_sig[-(i+1)], L_frame, 0);
     L_temp = g729_L_sub(sum, max);
     if (L_temp > 0) { max = sum; T3 = i+(G729_Word16)1;   }
     
-    p  = scal_sig;
-    p1 = &scal_sig[-(i-1)];
-    sum = 0;
-    for (j=0; j<L_frame; j+=2, p+=2, p1+=2)
-        sum = g729_L_mac(sum, *p, *p1);
+    sum = g729_Dot_mac_even(0, scal_sig, &scal_sig[-(i-1)], L_frame, 0);
     L_temp = g729_L_sub(sum, max);
     if (L_temp > 0) { max = sum; T3 = i-(G729_Word16)1;   }
     
     /* compute energy of maximum */
     
-    sum = 1;                   /* to avoid division by zero */
     p = &scal_sig[-T3];
-    for(i=0; i<L_frame; i+=2, p+=2)
-        sum = g729_L_mac(sum, *p, *p);
+    sum = g729_Dot_mac_even(1, p, p, L_frame, 0);   /* 1: to avoid division by zero */
     
     /* max1 = max/sqrt(energy)                  */
     /* This result will always be on 16 bits !! */
@@ -350,14 +316,7 @@ G729_Word32 Dot_Product(      /* (o)   :Result of scalar product. */
                         G729_Word16   lg       /* (i)   :Number of point.          */
 )
 {
-    G729_Word16 i;
-    G729_Word32 sum;
-    
-    sum = 0;
-    for(i=0; i<lg; i++)
-        sum = g729_L_mac(sum, x[i], y[i]);
-    
-    return sum;
+    return g729_Dot_mac(0, x, y, lg, 0);
 }
 
 /*--------------------------------------------------------------------------*
@@ -377,9 +336,10 @@ G729_Word16 g729_Pitch_fr3_fast(    /* (o)     : pitch period.
     G729_Word16 *pit_frac           /* (o)     : chosen fraction.                       */
 )
 {
-    G729_Word16 t, t0;
+    G729_Word16 t, t0, f;
     G729_Word16 Dn[L_SUBFR];
-    G729_Word16 exc_tmp[L_SUBFR];
+    G729_Word16 exc_frac[UP_SAMP][L_SUBFR];
+    G729_Word32 corr_lag[PIT_MAX-PIT_MIN+1];
     G729_Word32 max, corr, L_temp;
     
     /*-----------------------------------------------------------------*
@@ -390,14 +350,22 @@ G729_Word16 g729_Pitch_fr3_fast(    /* (o)     : pitch period.
     
     /*-----------------------------------------------------------------*
      * Find maximum integer delay.                                     *
+     * corr_lag[k] is the correlation at lag t0_max-k, all lags being  *
+     * correlated in one pass when none of them can saturate.          *
      *-----------------------------------------------------------------*/
     
+    if( g729_Dot_mac_lags(Dn, &exc[-t0_max], L_subfr, g729_sub(t0_max, t0_min) + 1, corr_lag) != 0 )
+    {
+        for(t=t0_min; t<=t0_max; t++)
+            corr_lag[t0_max - t] = Dot_Product(Dn, &exc[-t], L_subfr);
+    }
+    
     max = G729A_MIN_32;
     t0 = t0_min; /* Only to remove warning from some compilers */
     
     for(t=t0_min; t<=t0_max; t++)
     {
-        corr = Dot_Product(Dn, &exc[-t], L_subfr);
+        corr = corr_lag[t0_max - t];
         L_temp = g729_L_sub(corr, max);
         if(L_temp > 0) {max = corr; t0 = t;  }
     }
@@ -406,41 +374,39 @@ G729_Word16 g729_Pitch_fr3_fast(    /* (o)     : pitch period.
      * Test fractions.                                                 *
      *-----------------------------------------------------------------*/
     
-    /* Fraction 0 */
-    
-    g729_Pred_lt_3(exc, t0, 0, L_subfr);
-    max = Dot_Product(Dn, exc, L_subfr);
-    *pit_frac = 0;
-    
     /* If first subframe and lag > 84 do not search fractional pitch */
     
+    *pit_frac = 0;
     if( (i_subfr == 0) && (g729_sub(t0, 84) > 0) )
+    {
+        g729_Pred_lt_3(exc, t0, 0, L_subfr);
         return t0;
+    }
+    
+    /* Fractions 0, -1/3 and +1/3 interpolated together */
     
-    g729_Copy(exc, exc_tmp, L_subfr);
+    g729_Pred_lt_3_fracs(exc, t0, L_subfr, exc_frac);
     
-    /* Fraction -1/3 */
+    max = Dot_Product(Dn, exc_frac[0], L_subfr);
+    f = 0;
     
-    g729_Pred_lt_3(exc, t0, -1, L_subfr);
-    corr = Dot_Product(Dn, exc, L_subfr);
+    corr = Dot_Product(Dn, exc_frac[1], L_subfr);
     L_temp = g729_L_sub(corr, max);
     if(L_temp > 0) {
         max = corr;
         *pit_frac = -1;
-        g729_Copy(exc, exc_tmp, L_subfr);
+        f = 1;
     }
     
-    /* Fraction +1/3 */
-    
-    g729_Pred_lt_3(exc, t0, 1, L_subfr);
-    corr = Dot_Product(Dn, exc, L_subfr);
+    corr = Dot_Product(Dn, exc_frac[2], L_subfr);
     L_temp = g729_L_sub(corr, max);
     if(L_temp > 0) {
         max = corr;
         *pit_frac =  1;
+        f = 2;
     }
-    else
-        g729_Copy(exc_tmp, exc, L_subfr);
+    
+    g729_Copy(exc_frac[f], exc, L_subfr);
     
     return t0;
 }
@@ -122,3 +122,23 @@ void g729_Post_Process(
     return;
 }
 
+/*------------------------------------------------------------------------*
+ * Function g729_Post_Scale()                                             *
+ *                                                                        *
+ * Multiplication by two of output speech with saturation, without the    *
+ * high pass filter of g729_Post_Process().                               *
+ *-----------------------------------------------------------------------*/
+
+void g729_Post_Scale(
+    G729_Word16 signal_in[],    /* input signal        */
+    G729_Word16 signal_out[],   /* output signal       */
+    G729_Word16 lg)             /* length of signal    */
+{
+    G729_Word16 i;
+    
+    for(i=0; i<lg; i++)
+    {
+        signal_out[i] = g729_shl(signal_in[i], 1);
+    }
+    return;
+}
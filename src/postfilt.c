@@ -48,6 +48,7 @@
 #include "basic_op.h"
 #include "ld8a.h"
 #include "oper_32b.h"
+#include "simd_func.h"
 
 #include "g729a_decoder.h"
 
@@ -97,9 +98,6 @@ static void g729_agc(
 
 void g729_Init_Post_Filter(g729a_post_filter_state * state)
 {
-    state->res2  = state->res2_buf + PIT_MAX;
-    state->scal_res2  = state->scal_res2_buf + PIT_MAX;
-    
     g729_Set_zero(state->mem_syn_pst, M);
     g729_Set_zero(state->res2_buf, PIT_MAX+L_SUBFR);
     g729_Set_zero(state->scal_res2_buf, PIT_MAX+L_SUBFR);
@@ -149,7 +147,7 @@ void g729_Post_Filter(
     
     G729_Word16 h[L_H];
     
-    G729_Word16  i, j;
+    G729_Word16  j;
     G729_Word16  temp1, temp2;
     G729_Word32  L_tmp;
     
@@ -177,18 +175,18 @@ void g729_Post_Filter(
         
         /* filtering of synthesis speech by A(z/GAMMA2_PST) to find res2[] */
         
-        g729_Residu(Ap3, &syn[i_subfr], state->res2, L_SUBFR);
+        g729_Residu(Ap3, &syn[i_subfr], G729_PST_RES2(state), L_SUBFR);
         
         /* scaling of "res2[]" to avoid energy overflow */
         
         for (j=0; j<L_SUBFR; j++)
         {
-            state->scal_res2[j] = g729_shr(state->res2[j], 2);
+            G729_PST_SCAL_RES2(state)[j] = g729_shr(G729_PST_RES2(state)[j], 2);
         }
         
         /* pitch postfiltering */
         
-        g729_pit_pst_filt(state->res2, state->scal_res2, t0_min, t0_max, L_SUBFR, res2_pst);
+        g729_pit_pst_filt(G729_PST_RES2(state), G729_PST_SCAL_RES2(state), t0_min, t0_max, L_SUBFR, res2_pst);
         
         /* tilt compensation filter */
         
@@ -200,12 +198,10 @@ void g729_Post_Filter(
         
         /* 1st correlation of h[] */
         
-        L_tmp = g729_L_mult(h[0], h[0]);
-        for (i=1; i<L_H; i++) L_tmp = g729_L_mac(L_tmp, h[i], h[i]);
+        L_tmp = g729_Dot_mac(0, h, h, L_H, 0);
         temp1 = g729_extract_h(L_tmp);
         
-        L_tmp = g729_L_mult(h[0], h[1]);
-        for (i=1; i<L_H-1; i++) L_tmp = g729_L_mac(L_tmp, h[i], h[i+1]);
+        L_tmp = g729_Dot_mac(0, h, &h[1], L_H-1, 0);
         temp2 = g729_extract_h(L_tmp);
         
         if(temp2 <= 0) {
@@ -228,8 +224,8 @@ void g729_Post_Filter(
         
         /* update res2[] buffer;  shift by L_SUBFR */
         
-        g729_Copy(&(state->res2[L_SUBFR-PIT_MAX]), &(state->res2[-PIT_MAX]), PIT_MAX);
-        g729_Copy(&(state->scal_res2[L_SUBFR-PIT_MAX]), &(state->scal_res2[-PIT_MAX]), PIT_MAX);
+        g729_Copy(&G729_PST_RES2(state)[L_SUBFR-PIT_MAX], &G729_PST_RES2(state)[-PIT_MAX], PIT_MAX);
+        g729_Copy(&G729_PST_SCAL_RES2(state)[L_SUBFR-PIT_MAX], &G729_PST_SCAL_RES2(state)[-PIT_MAX], PIT_MAX);
         
         Az += MP1;
     }
@@ -264,48 +260,42 @@ static void g729_pit_pst_filt(
 {
     G729_Word16 i, j, t0;
     G729_Word16 g0, gain, cmax, en, en0;
-    G729_Word16 *p, *p1, *deb_sig;
-    G729_Word32 corr, cor_max, ener, ener0, temp;
+    G729_Word32 cor_max, ener, ener0, temp;
     G729_Word32 L_temp;
+    G729_Word32 corr[PIT_MAX-PIT_MIN+1];
     
     /*---------------------------------------------------------------------------*
      * Compute the correlations for all delays                                   *
      * and select the delay which maximizes the correlation                      *
+     * corr[k] is the correlation at delay t0_max-k, all delays being correlated *
+     * in one pass when none of them can saturate.                               *
      *---------------------------------------------------------------------------*/
     
-    deb_sig = &scal_sig[-t0_min];
+    if (g729_Dot_mac_lags(scal_sig, &scal_sig[-t0_max], L_subfr, g729_sub(t0_max, t0_min) + 1, corr) != 0)
+    {
+        for (i=t0_min; i<=t0_max; i++)
+            corr[t0_max - i] = g729_Dot_mac(0, scal_sig, &scal_sig[-i], L_subfr, 0);
+    }
+    
     cor_max = G729A_MIN_32;
     t0 = t0_min;             /* Only to remove warning from some compilers */
     for (i=t0_min; i<=t0_max; i++)
     {
-        corr = 0;
-        p    = scal_sig;
-        p1   = deb_sig;
-        for (j=0; j<L_subfr; j++)
-            corr = g729_L_mac(corr, *p++, *p1++);
-        
-        L_temp = g729_L_sub(corr, cor_max);
+        L_temp = g729_L_sub(corr[t0_max - i], cor_max);
         if (L_temp > (G729_Word32)0)
         {
-            cor_max = corr;
+            cor_max = corr[t0_max - i];
             t0 = i;
         }
-        deb_sig--;
     }
     
     /* Compute the energy of the signal delayed by t0 */
     
-    ener = 1;
-    p = scal_sig - t0;
-    for ( i=0; i<L_subfr ;i++, p++)
-        ener = g729_L_mac(ener, *p, *p);
+    ener = g729_Dot_mac(1, scal_sig - t0, scal_sig - t0, L_subfr, 0);
     
     /* Compute the signal energy in the present subframe */
     
-    ener0 = 1;
-    p = scal_sig;
-    for ( i=0; i<L_subfr; i++, p++)
-        ener0 = g729_L_mac(ener0, *p, *p);
+    ener0 = g729_Dot_mac(1, scal_sig, scal_sig, L_subfr, 0);
     
     if (cor_max < 0)
     {
@@ -363,13 +353,9 @@ static void g729_pit_pst_filt(
     }
     
     
-    for (i = 0; i < L_subfr; i++)
-    {
-        /* signal_pst[i] = g0*signal[i] + gain*signal[i-t0]; */
-        
-        signal_pst[i] = g729_add(g729_mult(g0, signal[i]), g729_mult(gain, signal[i-t0]));
-        
-    }
+    /* signal_pst[i] = g0*signal[i] + gain*signal[i-t0]; */
+    
+    g729_Mult_add(signal, g0, signal - t0, gain, signal_pst, L_subfr);
     
     return;
 }
@@ -439,9 +425,7 @@ static void g729_agc(
     for(i=0; i<l_trm; i++)
         signal[i] = g729_shr(sig_out[i], 2);
     
-    s = 0;
-    for(i=0; i<l_trm; i++)
-        s = g729_L_mac(s, signal[i], signal[i]);
+    s = g729_Dot_mac(0, signal, signal, l_trm, 0);
     
     if (s == 0) {
         state->past_gain = 0;
@@ -455,9 +439,7 @@ static void g729_agc(
     for(i=0; i<l_trm; i++)
         signal[i] = g729_shr(sig_in[i], 2);
     
-    s = 0;
-    for(i=0; i<l_trm; i++)
-        s = g729_L_mac(s, signal[i], signal[i]);
+    s = g729_Dot_mac(0, signal, signal, l_trm, 0);
     
     if (s == 0) {
         g0 = 0;
@@ -52,6 +52,7 @@
 #include "basic_op.h"
 #include "ld8a.h"
 #include "tab_ld8a.h"
+#include "simd_func.h"
 
 void g729_Pred_lt_3(
     G729_Word16   exc[],       /* in/out: excitation buffer */
@@ -93,3 +94,98 @@ void g729_Pred_lt_3(
     return;
 }
 
+/*-------------------------------------------------------------------*
+ * Function  g729_Pred_lt_3_fracs()                                  *
+ *           ~~~~~~~~~~~~~~~~~~~~                                    *
+ *-------------------------------------------------------------------*
+ * Interpolation of the past excitation at T0 for the fractions 0,   *
+ * -1/3 and +1/3 together, as the closed-loop pitch search tries     *
+ * them. y[0], y[1] and y[2] get what g729_Pred_lt_3() leaves in     *
+ * exc[0..L_subfr-1] for each of them; exc[] is not modified.        *
+ *                                                                   *
+ * The three filters share their source, which is read once per     *
+ * block of 8 outputs, except when T0 < L_subfr+L_INTER10: then      *
+ * g729_Pred_lt_3() reads back its own outputs and each fraction is  *
+ * run over a copy of the past excitation.                           *
+ *-------------------------------------------------------------------*/
+
+/* One output of g729_Pred_lt_3() at x0 = &exc[j-T0], or &exc[j-T0-1] */
+/* for frac = 2, in the order of its L_mac() chain                    */
+static G729_Word16 Interpol_3(G729_Word16 *x0, G729_Word16 frac)
+{
+    G729_Word16  i, k;
+    G729_Word16  *c1, *c2;
+    G729_Word32  s;
+    
+    c1 = &g729_inter_3l[frac];
+    c2 = &g729_inter_3l[g729_sub(UP_SAMP,frac)];
+    
+    s = 0;
+    for(i=0, k=0; i< L_INTER10; i++, k+=UP_SAMP)
+    {
+        s = g729_L_mac(s, x0[-i],  c1[k]);
+        s = g729_L_mac(s, x0[1+i], c2[k]);
+    }
+    
+    return g729_round(s);
+}
+
+void g729_Pred_lt_3_fracs(
+    G729_Word16   exc[],       /* input : excitation buffer                  */
+    G729_Word16   T0,          /* input : integer pitch lag                  */
+    G729_Word16   L_subfr,     /* input : subframe size, <= L_SUBFR          */
+    G729_Word16   y[][L_SUBFR] /* output: fractions 0, -1/3 and +1/3         */
+)
+{
+    G729_Word16  f, j, k, h, far;
+    G729_Word16  buf[UP_SAMP][2*L_SUBFR+2*L_INTER10];
+    G729_Word16  *src[UP_SAMP], *out[UP_SAMP], *x[UP_SAMP], *yb[UP_SAMP], *w[UP_SAMP];
+    
+    far = (G729_Word16)(T0 >= L_subfr + L_INTER10);
+    h = g729_add(T0, L_INTER10);
+    
+    for (f=0; f<UP_SAMP; f++)
+    {
+        w[f] = g729_inter_3l_taps[f];
+        if (far)
+        {
+            src[f] = exc;
+            out[f] = y[f];
+        }
+        else
+        {
+            g729_Copy(&exc[-h], buf[f], h);
+            src[f] = out[f] = &buf[f][h];
+        }
+    }
+    
+    for (j=0; j<L_subfr; j+=8)
+    {
+        for (f=0; f<UP_SAMP; f++)
+        {
+            x[f] = &src[f][j - h];
+            yb[f] = &out[f][j];
+        }
+        
+        if ( (j + 8 > L_subfr) || g729_Interpol_lanes(UP_SAMP, x, w, INTER_TAPS_ABS, yb) != 0 )
+        {
+            for (f=0; f<UP_SAMP; f++)
+            {
+                for (k=j; (k<j+8) && (k<L_subfr); k++)
+                {
+                    out[f][k] = Interpol_3(&src[f][k - T0 - (f == 2)], f);
+                }
+            }
+        }
+    }
+    
+    if (!far)
+    {
+        for (f=0; f<UP_SAMP; f++)
+        {
+            g729_Copy(out[f], y[f], L_subfr);
+        }
+    }
+    
+    return;
+}
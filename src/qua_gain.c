@@ -43,9 +43,14 @@
 
 #include "ld8a.h"
 #include "tab_ld8a.h"
+#include "simd_func.h"
 
 #include "g729a_encoder.h"
 
+static G729_Word16 Qua_gain(g729a_encoder_state * state, G729_Word16 code[], G729_Word16 g_coeff[],
+                            G729_Word16 exp_coeff[], G729_Word16 L_subfr, G729_Word16 *gain_pit,
+                            G729_Word16 *gain_cod, G729_Word16 tameflag, G729_Flag fast);
+
 static void Gbk_presel(
     G729_Word16 best_gain[],     /* (i) [0] Q9 : unquantized pitch gain     */
                                  /* (i) [1] Q2 : unquantized code gain      */
@@ -82,6 +87,42 @@ G729_Word16 g729_Qua_gain(
     G729_Word16 *gain_cod,    /* (o) Q1  :Code gain.                     */
     G729_Word16 tameflag      /* (i)     : set to 1 if taming is needed  */
 )
+{
+    return Qua_gain(state, code, g_coeff, exp_coeff, L_subfr, gain_pit, gain_cod, tameflag, 1);
+}
+
+/*---------------------------------------------------------------------------*
+ * Function  g729_Qua_gain_ref                                               *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~                                               *
+ *   Same as g729_Qua_gain() with the ITU codebook search loop only.         *
+ *---------------------------------------------------------------------------*/
+G729_Word16 g729_Qua_gain_ref(
+    g729a_encoder_state * state,
+    G729_Word16 code[],       /* (i) Q13 :Innovative vector.             */
+    G729_Word16 g_coeff[],    /* (i)     :Correlations <xn y1> -2<y1 y1> */
+                              /*            <y2,y2>, -2<xn,y2>, 2<y1,y2> */
+    G729_Word16 exp_coeff[],  /* (i)     :Q-Format g_coeff[]             */
+    G729_Word16 L_subfr,      /* (i)     :Subframe length.               */
+    G729_Word16 *gain_pit,    /* (o) Q14 :Pitch gain.                    */
+    G729_Word16 *gain_cod,    /* (o) Q1  :Code gain.                     */
+    G729_Word16 tameflag      /* (i)     : set to 1 if taming is needed  */
+)
+{
+    return Qua_gain(state, code, g_coeff, exp_coeff, L_subfr, gain_pit, gain_cod, tameflag, 0);
+}
+
+static G729_Word16 Qua_gain(
+    g729a_encoder_state * state,
+    G729_Word16 code[],       /* (i) Q13 :Innovative vector.             */
+    G729_Word16 g_coeff[],    /* (i)     :Correlations <xn y1> -2<y1 y1> */
+                              /*            <y2,y2>, -2<xn,y2>, 2<y1,y2> */
+    G729_Word16 exp_coeff[],  /* (i)     :Q-Format g_coeff[]             */
+    G729_Word16 L_subfr,      /* (i)     :Subframe length.               */
+    G729_Word16 *gain_pit,    /* (o) Q14 :Pitch gain.                    */
+    G729_Word16 *gain_cod,    /* (o) Q1  :Code gain.                     */
+    G729_Word16 tameflag,     /* (i)     : set to 1 if taming is needed  */
+    G729_Flag   fast          /* (i)     : 0 for the ITU search only     */
+)
 {
     G729_Word16  i, j, index1, index2;
     G729_Word16  cand1, cand2;
@@ -279,7 +320,14 @@ G729_Word16 g729_Qua_gain(
     index1 = cand1;
     index2 = cand2;
     
-    if(tameflag == 1){
+    /* all NCAN1 x NCAN2 pairs at once in the vector unit */
+    if( fast && g729_Gain_search( &g729_gbk12_pit[cand1][cand2], &g729_gbk12_pit2[cand1][cand2],
+                                  &g729_gbk12_code[cand1][cand2], NCODE2, NCAN1, gcode0,
+                                  coeff, coeff_lsf, (tameflag == 1) ? GP0999 : G729A_MAX_16, &i ) == 0 ){
+        index1 = g729_add( cand1, i / NCAN2 );
+        index2 = g729_add( cand2, i % NCAN2 );
+    }
+    else if(tameflag == 1){
         for(i=0; i<NCAN1; i++){
             for(j=0; j<NCAN2; j++){
                 g_pitch = g729_add( g729_gbk1[cand1+i][0], g729_gbk2[cand2+j][0] );     /* Q14 */
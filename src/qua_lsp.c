@@ -41,11 +41,14 @@
  * Function  g729_Qua_lsp:                                           *
  *           ~~~~~~~~                                                *
  *-------------------------------------------------------------------*/
+#include <stddef.h>
+
 #include "g729a_typedef.h"
 #include "basic_op.h"
 
 #include "ld8a.h"
 #include "tab_ld8a.h"
+#include "simd_func.h"
 
 #include "g729a_encoder.h"
 
@@ -203,6 +206,10 @@ static void g729_Lsp_pre_select(
     
     /* avoid the worst case. (all over flow) */
     
+    /* all codewords at once in the vector unit, g729_lspcb1[] by columns */
+    if ( g729_Lsp_vq_search(rbuf, NULL, g729_lspcb1_t[0], NC0, 0, M, cand) == 0 )
+        return;
+    
     *cand = 0;
     L_dmin = G729A_MAX_32;
     for ( i = 0 ; i < NC0 ; i++ ) {
@@ -210,6 +217,9 @@ static void g729_Lsp_pre_select(
         for ( j = 0 ; j < M ; j++ ) {
             tmp = g729_sub(rbuf[j], lspcb1[i][j]);
             L_tmp = g729_L_mac( L_tmp, tmp, tmp );
+#if defined(USE_LSP_PDE) && (USE_LSP_PDE == 1)
+            if ( L_tmp >= L_dmin ) break;    /* cannot be nearer any more */
+#endif
         }
         
         L_temp = g729_L_sub(L_tmp,L_dmin);
@@ -239,6 +249,10 @@ static void g729_Lsp_select_1(
     for ( j = 0 ; j < NC ; j++ )
         buf[j] = g729_sub(rbuf[j], lspcb1[j]);
     
+    /* all codewords at once in the vector unit, g729_lspcb2[] by columns */
+    if ( g729_Lsp_vq_search(buf, wegt, g729_lspcb2_t[0], NC1, 0, NC, index) == 0 )
+        return;
+    
     /* avoid the worst case. (all over flow) */
     *index = 0;
     L_dmin = G729A_MAX_32;
@@ -248,6 +262,9 @@ static void g729_Lsp_select_1(
             tmp = g729_sub(buf[j], lspcb2[k1][j]);
             tmp2 = g729_mult( wegt[j], tmp );
             L_dist = g729_L_mac( L_dist, tmp2, tmp );
+#if defined(USE_LSP_PDE) && (USE_LSP_PDE == 1)
+            if ( L_dist >= L_dmin ) break;   /* cannot be nearer any more */
+#endif
         }
         
         L_temp =g729_L_sub(L_dist,L_dmin);
@@ -277,6 +294,10 @@ static void g729_Lsp_select_2(
     for ( j = NC ; j < M ; j++ )
         buf[j] = g729_sub(rbuf[j], lspcb1[j]);
     
+    /* all codewords at once in the vector unit, g729_lspcb2[] by columns */
+    if ( g729_Lsp_vq_search(buf, wegt, g729_lspcb2_t[0], NC1, NC, M, index) == 0 )
+        return;
+    
     /* avoid the worst case. (all over flow) */
     *index = 0;
     L_dmin = G729A_MAX_32;
@@ -286,6 +307,9 @@ static void g729_Lsp_select_2(
             tmp = g729_sub(buf[j], lspcb2[k1][j]);
             tmp2 = g729_mult( wegt[j], tmp );
             L_dist = g729_L_mac( L_dist, tmp2, tmp );
+#if defined(USE_LSP_PDE) && (USE_LSP_PDE == 1)
+            if ( L_dist >= L_dmin ) break;   /* cannot be nearer any more */
+#endif
         }
         
         L_temp = g729_L_sub(L_dist, L_dmin);
@@ -0,0 +1,1708 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------------------*
+ * Vector kernels for the multiply-accumulate loops of the coder.            *
+ *                                                                           *
+ * A loop  s = L_init; for (i = 0; i < n; i++) s = L_mac(s, x[i], y[i]);     *
+ * saturates only if a partial sum leaves [MIN_32, MAX_32]. Every partial    *
+ * sum is bounded by |L_init| + 2*sum(|x[i]*y[i]|), so when that bound is    *
+ * not above MAX_32 the saturating loop is an ordinary integer sum and can   *
+ * be computed in any order. The kernels below compute sum(x[i]*y[i]) and    *
+ * an upper bound of sum(|x[i]*y[i]|) in one pass, and the exact scalar      *
+ * loop runs only when the bound fails.                                      *
+ *                                                                           *
+ * The bound uses saturated absolute values (|-32768| -> 32767), so each     *
+ * vector product may be short by at most |x|+|y|+1 < 65536; that much is    *
+ * added per vector element.                                                 *
+ *---------------------------------------------------------------------------*/
+
+#include <stddef.h>
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "ld8a.h"
+#include "simd_func.h"
+
+#if !defined(USE_SIMD) || (USE_SIMD != 0)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define G729A_HAVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) && ((__GNUC__ >= 5) || defined(__clang__))
+#define G729A_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(USE_NEON) && (USE_NEON == 1)
+/* Not yet run against the ITU vectors on an ARM target: opt-in only */
+#define G729A_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#define ABS_SLACK   65536L
+
+/*----------------------------------------------------------------------------*
+ * Dot_mac_ref - reference g729_L_mac() loop over x[0], x[step], ...          *
+ *----------------------------------------------------------------------------*/
+static G729_Word32 Dot_mac_ref(G729_Word32 L_init, G729_Word16 x[], G729_Word16 y[],
+                               G729_Word16 n, G729_Word16 step, G729_Flag *overflow)
+{
+    G729_Word16 i;
+    G729_Word32 L_prod;
+    G729_Word64 L_sum = L_init;
+    G729_Flag ovf = 0;
+
+    for (i = 0; i < n; i += step)
+    {
+        L_prod = (G729_Word32)x[i] * (G729_Word32)y[i];
+        if (L_prod == (G729_Word32)0x40000000L)
+        {
+            L_prod = G729A_MAX_32;
+            ovf = 1;
+        }
+        else
+        {
+            L_prod *= 2;
+        }
+
+        L_sum += L_prod;
+        if (L_sum > G729A_MAX_32)
+        {
+            L_sum = G729A_MAX_32;
+            ovf = 1;
+        }
+        else if (L_sum < G729A_MIN_32)
+        {
+            L_sum = G729A_MIN_32;
+            ovf = 1;
+        }
+    }
+
+#if defined(USE_GLOBAL_OVERFLOW_FLAG) && (USE_GLOBAL_OVERFLOW_FLAG == 1)
+    if (ovf != 0)
+    {
+        G729A_Overflow_Flag = 1;
+    }
+#endif
+
+    if (overflow != 0)
+    {
+        *overflow = ovf;
+    }
+
+    return (G729_Word32)L_sum;
+}
+
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+
+/*----------------------------------------------------------------------------*
+ * Dot_tail - scalar sum and exact absolute sum of the last elements          *
+ *----------------------------------------------------------------------------*/
+static void Dot_tail(G729_Word16 x[], G729_Word16 y[], G729_Word16 i, G729_Word16 n,
+                     G729_Word16 step, G729_Word64 *sum, G729_Word64 *abs_sum)
+{
+    G729_Word32 L_prod;
+
+    for (; i < n; i += step)
+    {
+        L_prod = (G729_Word32)x[i] * (G729_Word32)y[i];
+        *sum += L_prod;
+        *abs_sum += (L_prod < 0) ? -(G729_Word64)L_prod : (G729_Word64)L_prod;
+    }
+}
+
+#if defined(G729A_HAVE_SSE2)
+
+static G729_Word16 Dot_scan_sse2(G729_Word16 x[], G729_Word16 y[], G729_Word16 n, G729_Word16 step,
+                                 G729_Word64 *sum, G729_Word64 *abs_sum)
+{
+    G729_Word16 i;
+    G729_Word32 s[4];
+    G729_Word64 u[2];
+    __m128i zero = _mm_setzero_si128();
+    __m128i mask = (step == 2) ? _mm_set1_epi32(0x0000ffff) : _mm_set1_epi32(-1);
+    __m128i vs = zero, vu = zero;
+    __m128i xv, yv, ax, ay, pu;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        xv = _mm_and_si128(_mm_loadu_si128((const __m128i *)&x[i]), mask);
+        yv = _mm_loadu_si128((const __m128i *)&y[i]);
+        vs = _mm_add_epi32(vs, _mm_madd_epi16(xv, yv));
+
+        ax = _mm_max_epi16(xv, _mm_subs_epi16(zero, xv));
+        ay = _mm_max_epi16(yv, _mm_subs_epi16(zero, yv));
+        pu = _mm_madd_epi16(ax, ay);
+        vu = _mm_add_epi64(vu, _mm_unpacklo_epi32(pu, zero));
+        vu = _mm_add_epi64(vu, _mm_unpackhi_epi32(pu, zero));
+    }
+
+    _mm_storeu_si128((__m128i *)s, vs);
+    _mm_storeu_si128((__m128i *)u, vu);
+    *sum = (G729_Word64)s[0] + s[1] + s[2] + s[3];
+    *abs_sum = u[0] + u[1] + (G729_Word64)i * ABS_SLACK;
+
+    return i;
+}
+
+#if defined(G729A_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static G729_Word16 Dot_scan_avx2(G729_Word16 x[], G729_Word16 y[], G729_Word16 n, G729_Word16 step,
+                                 G729_Word64 *sum, G729_Word64 *abs_sum)
+{
+    G729_Word16 i;
+    G729_Word32 s[8];
+    G729_Word64 u[4];
+    __m256i zero = _mm256_setzero_si256();
+    __m256i mask = (step == 2) ? _mm256_set1_epi32(0x0000ffff) : _mm256_set1_epi32(-1);
+    __m256i vs = zero, vu = zero;
+    __m256i xv, yv, ax, ay, pu;
+
+    for (i = 0; i + 16 <= n; i += 16)
+    {
+        xv = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)&x[i]), mask);
+        yv = _mm256_loadu_si256((const __m256i *)&y[i]);
+        vs = _mm256_add_epi32(vs, _mm256_madd_epi16(xv, yv));
+
+        ax = _mm256_abs_epi16(_mm256_max_epi16(xv, _mm256_set1_epi16(-32767)));
+        ay = _mm256_abs_epi16(_mm256_max_epi16(yv, _mm256_set1_epi16(-32767)));
+        pu = _mm256_madd_epi16(ax, ay);
+        vu = _mm256_add_epi64(vu, _mm256_unpacklo_epi32(pu, zero));
+        vu = _mm256_add_epi64(vu, _mm256_unpackhi_epi32(pu, zero));
+    }
+
+    if (i + 8 <= n)
+    {
+        __m128i xh, yh, axh, ayh, ph;
+
+        xh = _mm_and_si128(_mm_loadu_si128((const __m128i *)&x[i]), _mm256_castsi256_si128(mask));
+        yh = _mm_loadu_si128((const __m128i *)&y[i]);
+        vs = _mm256_add_epi32(vs, _mm256_inserti128_si256(zero, _mm_madd_epi16(xh, yh), 0));
+
+        axh = _mm_abs_epi16(_mm_max_epi16(xh, _mm_set1_epi16(-32767)));
+        ayh = _mm_abs_epi16(_mm_max_epi16(yh, _mm_set1_epi16(-32767)));
+        ph = _mm_madd_epi16(axh, ayh);
+        vu = _mm256_add_epi64(vu, _mm256_cvtepu32_epi64(ph));
+        i += 8;
+    }
+
+    _mm256_storeu_si256((__m256i *)s, vs);
+    _mm256_storeu_si256((__m256i *)u, vu);
+    *sum = (G729_Word64)s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7];
+    *abs_sum = u[0] + u[1] + u[2] + u[3] + (G729_Word64)i * ABS_SLACK;
+
+    return i;
+}
+
+#endif /* G729A_HAVE_AVX2 */
+
+#elif defined(G729A_HAVE_NEON)
+
+static G729_Word16 Dot_scan_neon(G729_Word16 x[], G729_Word16 y[], G729_Word16 n, G729_Word16 step,
+                                 G729_Word64 *sum, G729_Word64 *abs_sum)
+{
+    G729_Word16 i;
+    int16x8_t mask = (step == 2) ? vreinterpretq_s16_u32(vdupq_n_u32(0x0000ffff)) : vdupq_n_s16(-1);
+    int32x4_t vs = vdupq_n_s32(0);
+    uint64x2_t vu = vdupq_n_u64(0);
+    int16x8_t xv, yv;
+    uint16x8_t ax, ay;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        xv = vandq_s16(vld1q_s16(&x[i]), mask);
+        yv = vld1q_s16(&y[i]);
+        vs = vmlal_s16(vs, vget_low_s16(xv), vget_low_s16(yv));
+        vs = vmlal_s16(vs, vget_high_s16(xv), vget_high_s16(yv));
+
+        ax = vreinterpretq_u16_s16(vqabsq_s16(xv));
+        ay = vreinterpretq_u16_s16(vqabsq_s16(yv));
+        vu = vpadalq_u32(vu, vmull_u16(vget_low_u16(ax), vget_low_u16(ay)));
+        vu = vpadalq_u32(vu, vmull_u16(vget_high_u16(ax), vget_high_u16(ay)));
+    }
+
+    *sum = (G729_Word64)vgetq_lane_s32(vs, 0) + vgetq_lane_s32(vs, 1)
+         + vgetq_lane_s32(vs, 2) + vgetq_lane_s32(vs, 3);
+    *abs_sum = (G729_Word64)vgetq_lane_u64(vu, 0) + (G729_Word64)vgetq_lane_u64(vu, 1)
+             + (G729_Word64)i * ABS_SLACK;
+
+    return i;
+}
+
+#endif
+
+#endif /* G729A_HAVE_SSE2 || G729A_HAVE_NEON */
+
+/*----------------------------------------------------------------------------*
+ * Dot_mac - dispatch to the best kernel for this CPU                         *
+ *----------------------------------------------------------------------------*/
+static G729_Word32 Dot_mac(G729_Word32 L_init, G729_Word16 x[], G729_Word16 y[],
+                           G729_Word16 n, G729_Word16 step, G729_Flag *overflow)
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 i;
+    G729_Word64 sum, abs_sum;
+
+#if defined(G729A_HAVE_AVX2)
+    if ((n >= 16) && __builtin_cpu_supports("avx2"))
+    {
+        i = Dot_scan_avx2(x, y, n, step, &sum, &abs_sum);
+    }
+    else
+#endif
+#if defined(G729A_HAVE_SSE2)
+    i = Dot_scan_sse2(x, y, n, step, &sum, &abs_sum);
+#else
+    i = Dot_scan_neon(x, y, n, step, &sum, &abs_sum);
+#endif
+    Dot_tail(x, y, i, n, step, &sum, &abs_sum);
+
+    /* |L_init| + 2*abs_sum <= MAX_32: no partial sum can saturate */
+    if ((L_init < 0 ? -(G729_Word64)L_init : (G729_Word64)L_init) + 2 * abs_sum <= G729A_MAX_32)
+    {
+        if (overflow != 0)
+        {
+            *overflow = 0;
+        }
+        return (G729_Word32)(L_init + 2 * sum);
+    }
+#endif
+
+    return Dot_mac_ref(L_init, x, y, n, step, overflow);
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Dot_mac - L_mac() loop over x[0..n-1], y[0..n-1]                      *
+ *----------------------------------------------------------------------------*/
+G729_Word32 g729_Dot_mac(G729_Word32 L_init, G729_Word16 x[], G729_Word16 y[],
+                         G729_Word16 n, G729_Flag *overflow)
+{
+    return Dot_mac(L_init, x, y, n, 1, overflow);
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Dot_mac_even - L_mac() loop over x[0], x[2], ... x[n-2] and same of y *
+ *----------------------------------------------------------------------------*/
+G729_Word32 g729_Dot_mac_even(G729_Word32 L_init, G729_Word16 x[], G729_Word16 y[],
+                              G729_Word16 n, G729_Flag *overflow)
+{
+    return Dot_mac(L_init, x, y, n, 2, overflow);
+}
+
+/*---------------------------------------------------------------------------*
+ * Element-wise operators for the codebook search.                           *
+ *                                                                           *
+ * mult(a, b) is (a*b)>>15, which can only leave 16 bits for a = b = -32768. *
+ * With SSE2 it is rebuilt from the low and high product halves and that     *
+ * single case is mapped back to MAX_16. NEON vqdmulhq_s16() is mult().      *
+ * The positive weights of L_mac() never make L_mult() saturate, so L_mac()  *
+ * is a doubled product and a saturating L_add().                            *
+ *---------------------------------------------------------------------------*/
+
+#if defined(G729A_HAVE_SSE2)
+
+static __m128i mult_sse2(__m128i a, __m128i b)
+{
+    __m128i lo = _mm_mullo_epi16(a, b);
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    __m128i r  = _mm_or_si128(_mm_slli_epi16(hi, 1), _mm_srli_epi16(lo, 15));
+
+    return _mm_xor_si128(r, _mm_cmpeq_epi16(r, _mm_set1_epi16(G729A_MIN_16)));
+}
+
+static __m128i L_add_sse2(__m128i a, __m128i b)
+{
+    __m128i r   = _mm_add_epi32(a, b);
+    __m128i ovf = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r)), 31);
+    __m128i sat = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(G729A_MAX_32));
+
+    return _mm_or_si128(_mm_andnot_si128(ovf, r), _mm_and_si128(ovf, sat));
+}
+
+static void L_mac_sse2(__m128i *L_lo, __m128i *L_hi, __m128i a, __m128i c)
+{
+    __m128i lo = _mm_mullo_epi16(a, c);
+    __m128i hi = _mm_mulhi_epi16(a, c);
+
+    *L_lo = L_add_sse2(*L_lo, _mm_slli_epi32(_mm_unpacklo_epi16(lo, hi), 1));
+    *L_hi = L_add_sse2(*L_hi, _mm_slli_epi32(_mm_unpackhi_epi16(lo, hi), 1));
+}
+
+#endif /* G729A_HAVE_SSE2 */
+
+/*----------------------------------------------------------------------------*
+ * g729_Mult_add - weighted sum of two vectors                                *
+ *----------------------------------------------------------------------------*/
+void g729_Mult_add(G729_Word16 x[], G729_Word16 g0, G729_Word16 y[], G729_Word16 g1,
+                   G729_Word16 z[], G729_Word16 n)
+{
+    G729_Word16 i = 0;
+#if defined(G729A_HAVE_SSE2)
+    __m128i vg0 = _mm_set1_epi16(g0);
+    __m128i vg1 = _mm_set1_epi16(g1);
+
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm_storeu_si128((__m128i *)&z[i],
+                         _mm_adds_epi16(mult_sse2(vg0, _mm_loadu_si128((const __m128i *)&x[i])),
+                                        mult_sse2(vg1, _mm_loadu_si128((const __m128i *)&y[i]))));
+    }
+#elif defined(G729A_HAVE_NEON)
+    for (; i + 8 <= n; i += 8)
+    {
+        vst1q_s16(&z[i], vqaddq_s16(vqdmulhq_n_s16(vld1q_s16(&x[i]), g0),
+                                    vqdmulhq_n_s16(vld1q_s16(&y[i]), g1)));
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        z[i] = g729_add(g729_mult(g0, x[i]), g729_mult(g1, y[i]));
+    }
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Mult_rows - multiply rows of 8 by one of two factor vectors           *
+ *----------------------------------------------------------------------------*/
+void g729_Mult_rows(G729_Word16 x[], G729_Word16 n_row, G729_Word16 row_sign[],
+                    G729_Word16 y[], G729_Word16 y_inv[])
+{
+    G729_Word16 r;
+#if defined(G729A_HAVE_SSE2)
+    __m128i vy = _mm_loadu_si128((const __m128i *)y);
+    __m128i vy_inv = _mm_loadu_si128((const __m128i *)y_inv);
+
+    __m128i m;
+
+    for (r = 0; r < n_row; r++, x += 8)
+    {
+        m = _mm_set1_epi16((G729_Word16)((row_sign[r] < 0) ? -1 : 0));
+        _mm_storeu_si128((__m128i *)x, mult_sse2(_mm_loadu_si128((const __m128i *)x),
+                                                 _mm_or_si128(_mm_and_si128(m, vy_inv),
+                                                              _mm_andnot_si128(m, vy))));
+    }
+#elif defined(G729A_HAVE_NEON)
+    int16x8_t vy = vld1q_s16(y);
+    int16x8_t vy_inv = vld1q_s16(y_inv);
+
+    uint16x8_t m;
+
+    for (r = 0; r < n_row; r++, x += 8)
+    {
+        m = vdupq_n_u16((G729_UWord16)((row_sign[r] < 0) ? 0xffff : 0));
+        vst1q_s16(x, vqdmulhq_s16(vld1q_s16(x), vbslq_s16(m, vy_inv, vy)));
+    }
+#else
+    G729_Word16 k, *p;
+
+    for (r = 0; r < n_row; r++, x += 8)
+    {
+        p = (row_sign[r] < 0) ? y_inv : y;
+        for (k = 0; k < 8; k++)
+        {
+            x[k] = g729_mult(x[k], p[k]);
+        }
+    }
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ * Candidate selection of the codebook search.                                *
+ *                                                                            *
+ * A candidate replaces the best one when                                     *
+ *     g729_L_msu(g729_L_mult(alp, sq2), sq, alp_16) > 0                      *
+ * sq2 = mult(ps2, ps2) is never negative and sq is -1 or an earlier sq2, so  *
+ * neither L_mult() saturates and a saturated difference keeps its sign: the  *
+ * test is alp*sq2 - sq*alp_16 > 0 on 32 bits (both products are below 2^30). *
+ * If no candidate of a row beats the best one found before the row, the      *
+ * scan of that row changes nothing, so the whole row is tested at once and   *
+ * only rows holding a better candidate are scanned one by one.               *
+ *----------------------------------------------------------------------------*/
+
+#define CAND_BETTER(sq2, alp_16, sq, alp) \
+    ((G729_Word32)(alp) * (G729_Word32)(sq2) > (G729_Word32)(sq) * (G729_Word32)(alp_16))
+
+static G729_Word16 Acelp_scan_row(G729_Word16 row, G729_Word16 ps2[], G729_Word16 sq2[],
+                                  G729_Word16 alp_16[], G729_Word16 *sq, G729_Word16 *alp,
+                                  G729_Word16 *ps, G729_Word16 best)
+{
+    G729_Word16 k;
+
+    for (k = 0; k < 8; k++)
+    {
+        if (CAND_BETTER(sq2[k], alp_16[k], *sq, *alp))
+        {
+            *sq = sq2[k];
+            *alp = alp_16[k];
+            if (ps != 0)
+            {
+                *ps = ps2[k];
+            }
+            best = (G729_Word16)(row * 8 + k);
+        }
+    }
+
+    return best;
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Acelp_cand - evaluate rows of 8 candidates and keep the best one      *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Acelp_cand(G729_Word16 n_row, G729_Word16 ps1[], G729_Word16 dn[], G729_Word32 L_alp1[],
+                            G729_Word16 rr_a[], G729_Word16 c_a, G729_Word16 rr_b[], G729_Word16 c_b,
+                            G729_Word16 *sq, G729_Word16 *alp, G729_Word16 *ps)
+{
+    G729_Word16 r, best = -1;
+    G729_Word16 ps2[8], sq2[8], alp_16[8];
+#if defined(G729A_HAVE_SSE2)
+    __m128i vdn = _mm_loadu_si128((const __m128i *)dn);
+    __m128i vca = _mm_set1_epi16(c_a);
+    __m128i vround = _mm_set1_epi32(0x00008000L);
+    __m128i zero = _mm_setzero_si128();
+    __m128i vps2, vsq2, valp, w, L_lo, L_hi, L_b_lo, L_b_hi, lo, hi;
+
+    /* L_mult(rr_b[k], c_b) is the same for all rows */
+    lo = _mm_mullo_epi16(_mm_loadu_si128((const __m128i *)rr_b), _mm_set1_epi16(c_b));
+    hi = _mm_mulhi_epi16(_mm_loadu_si128((const __m128i *)rr_b), _mm_set1_epi16(c_b));
+    L_b_lo = _mm_slli_epi32(_mm_unpacklo_epi16(lo, hi), 1);
+    L_b_hi = _mm_slli_epi32(_mm_unpackhi_epi16(lo, hi), 1);
+
+    for (r = 0; r < n_row; r++, rr_a += 8)
+    {
+        vps2 = _mm_adds_epi16(_mm_set1_epi16(ps1[r]), vdn);
+        vsq2 = mult_sse2(vps2, vps2);
+
+        L_lo = L_hi = _mm_set1_epi32(L_alp1[r]);
+        L_mac_sse2(&L_lo, &L_hi, _mm_loadu_si128((const __m128i *)rr_a), vca);
+        L_lo = L_add_sse2(L_add_sse2(L_lo, L_b_lo), vround);
+        L_hi = L_add_sse2(L_add_sse2(L_hi, L_b_hi), vround);
+        valp = _mm_packs_epi32(_mm_srai_epi32(L_lo, 16), _mm_srai_epi32(L_hi, 16));
+
+        /* alp*sq2[k] - sq*alp_16[k] of the 8 candidates, see CAND_BETTER */
+        w = _mm_set1_epi32((G729_Word32)(((G729_UWord32)(G729_UWord16)(-*sq) << 16) | (G729_UWord16)*alp));
+        lo = _mm_cmpgt_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(vsq2, valp), w), zero);
+        hi = _mm_cmpgt_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(vsq2, valp), w), zero);
+        if (_mm_movemask_epi8(_mm_or_si128(lo, hi)) != 0)
+        {
+            _mm_storeu_si128((__m128i *)ps2, vps2);
+            _mm_storeu_si128((__m128i *)sq2, vsq2);
+            _mm_storeu_si128((__m128i *)alp_16, valp);
+            best = Acelp_scan_row(r, ps2, sq2, alp_16, sq, alp, ps, best);
+        }
+    }
+#elif defined(G729A_HAVE_NEON)
+    int16x8_t vdn = vld1q_s16(dn);
+    int16x8_t vb = vld1q_s16(rr_b);
+    int32x4_t L_b_lo = vqdmull_n_s16(vget_low_s16(vb), c_b);
+    int32x4_t L_b_hi = vqdmull_n_s16(vget_high_s16(vb), c_b);
+    int32x4_t vround = vdupq_n_s32(0x00008000L);
+    int16x8_t vps2, vsq2, valp, va;
+    int32x4_t L_lo, L_hi;
+    uint32x4_t better;
+
+    for (r = 0; r < n_row; r++, rr_a += 8)
+    {
+        vps2 = vqaddq_s16(vdupq_n_s16(ps1[r]), vdn);
+        vsq2 = vqdmulhq_s16(vps2, vps2);
+
+        va = vld1q_s16(rr_a);
+        L_lo = vqaddq_s32(vdupq_n_s32(L_alp1[r]), vqdmull_n_s16(vget_low_s16(va), c_a));
+        L_hi = vqaddq_s32(vdupq_n_s32(L_alp1[r]), vqdmull_n_s16(vget_high_s16(va), c_a));
+        L_lo = vqaddq_s32(vqaddq_s32(L_lo, L_b_lo), vround);
+        L_hi = vqaddq_s32(vqaddq_s32(L_hi, L_b_hi), vround);
+        valp = vcombine_s16(vshrn_n_s32(L_lo, 16), vshrn_n_s32(L_hi, 16));
+
+        /* alp*sq2[k] - sq*alp_16[k] of the 8 candidates, see CAND_BETTER */
+        L_lo = vmlsl_n_s16(vmull_n_s16(vget_low_s16(vsq2), *alp), vget_low_s16(valp), *sq);
+        L_hi = vmlsl_n_s16(vmull_n_s16(vget_high_s16(vsq2), *alp), vget_high_s16(valp), *sq);
+        better = vorrq_u32(vcgtq_s32(L_lo, vdupq_n_s32(0)), vcgtq_s32(L_hi, vdupq_n_s32(0)));
+        if ((vgetq_lane_u32(better, 0) | vgetq_lane_u32(better, 1)
+           | vgetq_lane_u32(better, 2) | vgetq_lane_u32(better, 3)) != 0)
+        {
+            vst1q_s16(ps2, vps2);
+            vst1q_s16(sq2, vsq2);
+            vst1q_s16(alp_16, valp);
+            best = Acelp_scan_row(r, ps2, sq2, alp_16, sq, alp, ps, best);
+        }
+    }
+#else
+    G729_Word16 k;
+    G729_Word32 L_alp2;
+
+    for (r = 0; r < n_row; r++, rr_a += 8)
+    {
+        for (k = 0; k < 8; k++)
+        {
+            ps2[k] = g729_add(ps1[r], dn[k]);
+            sq2[k] = g729_mult(ps2[k], ps2[k]);
+
+            L_alp2 = g729_L_mac(L_alp1[r], rr_a[k], c_a);
+            L_alp2 = g729_L_mac(L_alp2, rr_b[k], c_b);
+            alp_16[k] = g729_round(L_alp2);
+        }
+        best = Acelp_scan_row(r, ps2, sq2, alp_16, sq, alp, ps, best);
+    }
+#endif
+
+    return best;
+}
+
+/*---------------------------------------------------------------------------*
+ * Correlation matrix of the codebook search.                                *
+ *                                                                           *
+ * With h[k] = 0 outside 0..L_SUBFR-1, the L_mac() chain of rr[i][j] sums    *
+ * h[t-i]*h[t-j] for t = max(i,j) to L_SUBFR-1. If 2*sum(h[k]^2) <= MAX_32   *
+ * no partial sum of any chain can saturate, since                           *
+ * |h[t-i]*h[t-j]| <= (h[t-i]^2 + h[t-j]^2)/2, and the chains are integer    *
+ * sums that can be added in any order. Then                                 *
+ *     rr[i][j] = rr[i+STEP][j+STEP] + sum(h[t-i]*h[t-j], t = 35..39)        *
+ * so row ix of the table of tracks x and y, rr[x+5*ix][y+5*iy] for the 8   *
+ * values of iy, is row ix+1 moved by one position plus 5 products with     *
+ * the vectors h[t-y-5*iy]. Rows are built from the last one up and stored   *
+ * whole; extract_h() of a doubled sum is the sum shifted right by 15.       *
+ *---------------------------------------------------------------------------*/
+
+#define COR_T0      (L_SUBFR - STEP)    /* first t of the 5 products      */
+#define COR_PAD     8                   /* zeros around h[] in hz[]       */
+
+/*----------------------------------------------------------------------------*
+ * g729_Cor_h_rr - rr[] of the codebook search from the scaled h[]            *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Cor_h_rr(G729_Word16 h[], G729_Word16 rr[])
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 i, k, x, y, ix;
+    G729_Word16 hz[COR_PAD + L_SUBFR + COR_PAD];   /* h[] with zeros around */
+    G729_Word16 *p0, *p1, *p2, *p3, *p4;
+    G729_Word32 cor;
+    G729_Flag overflow;
+
+    g729_Dot_mac(0, h, h, L_SUBFR, &overflow);
+    if (overflow != 0)
+    {
+        return -1;
+    }
+
+    for (k = 0; k < COR_PAD; k++)
+    {
+        hz[k] = 0;
+    }
+    for (k = 0; k < L_SUBFR; k++)
+    {
+        hz[COR_PAD + k] = h[k];
+    }
+    for (k = COR_PAD + L_SUBFR; k < COR_PAD + L_SUBFR + COR_PAD; k++)
+    {
+        hz[k] = 0;
+    }
+
+    /* rri0i0[] to rri4i4[]: rr[i][i] is the sum of h[k]^2 for k <= L_SUBFR-1-i */
+
+    p0 = rr + NB_POS - 1;
+    p1 = p0 + NB_POS;
+    p2 = p1 + NB_POS;
+    p3 = p2 + NB_POS;
+    p4 = p3 + NB_POS;
+
+    cor = 0;
+    for (k = 0; k < L_SUBFR; k += STEP)
+    {
+        cor += (G729_Word32)h[k] * h[k];
+        *p4-- = (G729_Word16)(cor >> 15);
+        cor += (G729_Word32)h[k + 1] * h[k + 1];
+        *p3-- = (G729_Word16)(cor >> 15);
+        cor += (G729_Word32)h[k + 2] * h[k + 2];
+        *p2-- = (G729_Word16)(cor >> 15);
+        cor += (G729_Word32)h[k + 3] * h[k + 3];
+        *p1-- = (G729_Word16)(cor >> 15);
+        cor += (G729_Word32)h[k + 4] * h[k + 4];
+        *p0-- = (G729_Word16)(cor >> 15);
+    }
+
+    /* rri0i1[] to rri0i4[], rri1i2[] to rri1i4[], rri2i3[], rri2i4[] */
+
+    p0 = rr + STEP * NB_POS;
+
+#if defined(G729A_HAVE_SSE2)
+    {
+        __m128i f_lo[STEP - 1][3], f_hi[STEP - 1][3];   /* pairs of h[t-y-5*iy] */
+        __m128i f[2 * STEP - 1];        /* h[s-5*iy], s = 31..39            */
+        __m128i zero = _mm_setzero_si128();
+        __m128i w, acc_lo, acc_hi;
+
+        for (k = 0; k < 2 * STEP - 1; k++)
+        {
+            p1 = &hz[COR_PAD + COR_T0 - (STEP - 1) + k];
+            f[k] = _mm_set_epi16(p1[-35], p1[-30], p1[-25], p1[-20],
+                                 p1[-15], p1[-10], p1[-5], p1[0]);
+        }
+
+        for (y = 1; y < STEP; y++)
+        {
+            for (k = 0; k < 3; k++)
+            {
+                /* t = 35+2k and 36+2k, t = 40 is left out */
+                f_lo[y - 1][k] = _mm_unpacklo_epi16(f[STEP - 1 + 2 * k - y],
+                                                    (k < 2) ? f[STEP + 2 * k - y] : zero);
+                f_hi[y - 1][k] = _mm_unpackhi_epi16(f[STEP - 1 + 2 * k - y],
+                                                    (k < 2) ? f[STEP + 2 * k - y] : zero);
+            }
+        }
+
+        for (x = 0; x < 3; x++)
+        {
+            for (y = x + 1; y < STEP; y++, p0 += MSIZE)
+            {
+                acc_lo = acc_hi = zero;
+                for (ix = NB_POS - 1; ix >= 0; ix--)
+                {
+                    i = x + STEP * ix;
+                    p1 = &hz[COR_PAD + COR_T0 - i];     /* h[t-i] */
+
+                    acc_lo = _mm_or_si128(_mm_srli_si128(acc_lo, 4), _mm_slli_si128(acc_hi, 12));
+                    acc_hi = _mm_srli_si128(acc_hi, 4);
+
+                    /* (h[t-i], h[t+1-i]) pairs, h[40-i] is multiplied by 0 */
+                    w = _mm_loadu_si128((const __m128i *)p1);
+                    acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(f_lo[y - 1][0], _mm_shuffle_epi32(w, 0x00)));
+                    acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(f_hi[y - 1][0], _mm_shuffle_epi32(w, 0x00)));
+                    acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(f_lo[y - 1][1], _mm_shuffle_epi32(w, 0x55)));
+                    acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(f_hi[y - 1][1], _mm_shuffle_epi32(w, 0x55)));
+                    acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(f_lo[y - 1][2], _mm_shuffle_epi32(w, 0xaa)));
+                    acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(f_hi[y - 1][2], _mm_shuffle_epi32(w, 0xaa)));
+
+                    _mm_storeu_si128((__m128i *)&p0[ix * NB_POS],
+                                     _mm_packs_epi32(_mm_srai_epi32(acc_lo, 15),
+                                                     _mm_srai_epi32(acc_hi, 15)));
+                }
+            }
+        }
+    }
+#elif defined(G729A_HAVE_NEON)
+    {
+        int16x8_t f[STEP - 1][STEP];                    /* h[t-y-5*iy] */
+        int32x4_t zero = vdupq_n_s32(0);
+        int32x4_t acc_lo, acc_hi;
+
+        for (y = 1; y < STEP; y++)
+        {
+            for (k = 0; k < STEP; k++)
+            {
+                G729_Word16 v[NB_POS];
+                G729_Word16 iy;
+
+                p1 = &hz[COR_PAD + COR_T0 + k - y];
+                for (iy = 0; iy < NB_POS; iy++)
+                {
+                    v[iy] = p1[-STEP * iy];
+                }
+                f[y - 1][k] = vld1q_s16(v);
+            }
+        }
+
+        for (x = 0; x < 3; x++)
+        {
+            for (y = x + 1; y < STEP; y++, p0 += MSIZE)
+            {
+                acc_lo = acc_hi = zero;
+                for (ix = NB_POS - 1; ix >= 0; ix--)
+                {
+                    i = x + STEP * ix;
+                    p1 = &hz[COR_PAD + COR_T0 - i];     /* h[t-i] */
+
+                    acc_lo = vextq_s32(acc_lo, acc_hi, 1);
+                    acc_hi = vextq_s32(acc_hi, zero, 1);
+
+                    for (k = 0; k < STEP; k++)
+                    {
+                        acc_lo = vmlal_n_s16(acc_lo, vget_low_s16(f[y - 1][k]), p1[k]);
+                        acc_hi = vmlal_n_s16(acc_hi, vget_high_s16(f[y - 1][k]), p1[k]);
+                    }
+
+                    vst1q_s16(&p0[ix * NB_POS], vcombine_s16(vshrn_n_s32(acc_lo, 15),
+                                                             vshrn_n_s32(acc_hi, 15)));
+                }
+            }
+        }
+    }
+#endif
+
+    return 0;
+#else
+    /* without vectors, 5 products per word cost more than the ITU chains */
+    (void)h;
+    (void)rr;
+
+    return -1;
+#endif
+}
+
+/*---------------------------------------------------------------------------*
+ * Filters of several channels at once.                                      *
+ *                                                                           *
+ * The signals of the channels are interleaved, sample t of channel l at     *
+ * [t*G729_LANES + l], and each channel runs in its own 32-bit lane; the     *
+ * serial recursion of g729_Syn_filt() stays within a lane.                  *
+ *                                                                           *
+ * SSE2 has no saturating 32-bit arithmetic: the chains are summed modulo    *
+ * 2^32 and every step that would have saturated in g729_L_mult(),           *
+ * g729_L_mac()/g729_L_msu(), g729_L_shl() or g729_round() is flagged. A     *
+ * flagged channel is filtered again by the scalar function, the others are  *
+ * exact. NEON has the saturating operators themselves (vqdmull, vqdmlal,    *
+ * vqdmlsl, vqshl, vqrshrn) and runs every channel.                          *
+ *--------------------------------------------------------------------------*/
+
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+
+/* Interleaves lg samples of the n channels from x[l][t0], zeros in the */
+/* unused channels.                                                     */
+static void Lanes_load(G729_Word16 n, G729_Word16 *x[], G729_Word16 t0, G729_Word16 lg,
+                       G729_Word16 v[])
+{
+    G729_Word16 l, t;
+
+    for (t = 0; t < lg; t++, v += G729_LANES)
+    {
+        for (l = 0; l < n; l++)
+        {
+            v[l] = x[l][t0 + t];
+        }
+        for (; l < G729_LANES; l++)
+        {
+            v[l] = 0;
+        }
+    }
+}
+
+#endif
+
+#if defined(G729A_HAVE_SSE2)
+
+/* Sign bit set where a+b (add) or a-b (sub) left the 32-bit range */
+#define ADD_OVF(a, b, r)    _mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r))
+#define SUB_OVF(a, b, r)    _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r))
+
+/* 2*a*x of 4 lanes: a holds (a[l], 0) pairs, x (x[l], any) pairs; the */
+/* doubling wraps only for -32768*-32768, flagged in *ovf              */
+#define L_MULT_LANES(a, x, d, ovf)                                      \
+    do {                                                                \
+        __m128i p_ = _mm_madd_epi16(a, x);                              \
+        d = _mm_add_epi32(p_, p_);                                      \
+        ovf = _mm_or_si128(ovf, _mm_xor_si128(d, p_));                  \
+    } while (0)
+
+/* round(L_shl(s, 3)) of 4 lanes, flagging a saturating shift or round */
+static __m128i Shl3_round_sse2(__m128i s, __m128i *ovf)
+{
+    __m128i t = _mm_slli_epi32(s, 3);
+
+    *ovf = _mm_or_si128(*ovf, _mm_xor_si128(_mm_cmpeq_epi32(_mm_srai_epi32(t, 3), s),
+                                            _mm_set1_epi32(-1)));
+    *ovf = _mm_or_si128(*ovf, _mm_cmpgt_epi32(t, _mm_set1_epi32(0x7fff7fffL)));
+
+    return _mm_srai_epi32(_mm_add_epi32(t, _mm_set1_epi32(0x8000L)), 16);
+}
+
+/* v[t*G729_LANES + l] = round(L_shl(chain, 3)) for t = 0..lg-1, where   */
+/* the chain is L_mult(v0[t], a[0]) followed by M L_msu(a[j], v[t-j])    */
+/* (sub != 0) or L_mac(a[j], v0[t-j]) (sub == 0); bad[l] != 0 where a    */
+/* step saturated. v and v0 hold M samples of history before index 0.    */
+static void Lanes_chain_sse2(G729_Word16 a16[], G729_Word16 v0[], G729_Word16 v[],
+                             G729_Word16 lg, G729_Word16 sub, G729_Word32 bad[])
+{
+    G729_Word16 t, j;
+    __m128i zero = _mm_setzero_si128();
+    __m128i a_lo[MP1], a_hi[MP1];
+    __m128i s_lo, s_hi, d_lo, d_hi, r_lo, r_hi, x, x_lo, x_hi;
+    __m128i sgn_lo = zero, sgn_hi = zero, ovf_lo = zero, ovf_hi = zero;
+    G729_Word16 *src;
+
+    for (j = 0; j <= M; j++)
+    {
+        x = _mm_loadu_si128((const __m128i *)&a16[j * G729_LANES]);
+        a_lo[j] = _mm_unpacklo_epi16(x, zero);
+        a_hi[j] = _mm_unpackhi_epi16(x, zero);
+    }
+
+    for (t = 0; t < lg; t++)
+    {
+        x = _mm_loadu_si128((const __m128i *)&v0[t * G729_LANES]);
+        L_MULT_LANES(a_lo[0], _mm_unpacklo_epi16(x, x), s_lo, sgn_lo);
+        L_MULT_LANES(a_hi[0], _mm_unpackhi_epi16(x, x), s_hi, sgn_hi);
+
+        src = sub ? v : v0;
+        for (j = 1; j <= M; j++)
+        {
+            x = _mm_loadu_si128((const __m128i *)&src[(t - j) * G729_LANES]);
+            x_lo = _mm_unpacklo_epi16(x, x);
+            x_hi = _mm_unpackhi_epi16(x, x);
+            L_MULT_LANES(a_lo[j], x_lo, d_lo, sgn_lo);
+            L_MULT_LANES(a_hi[j], x_hi, d_hi, sgn_hi);
+            if (sub)
+            {
+                r_lo = _mm_sub_epi32(s_lo, d_lo);
+                r_hi = _mm_sub_epi32(s_hi, d_hi);
+                sgn_lo = _mm_or_si128(sgn_lo, SUB_OVF(s_lo, d_lo, r_lo));
+                sgn_hi = _mm_or_si128(sgn_hi, SUB_OVF(s_hi, d_hi, r_hi));
+            }
+            else
+            {
+                r_lo = _mm_add_epi32(s_lo, d_lo);
+                r_hi = _mm_add_epi32(s_hi, d_hi);
+                sgn_lo = _mm_or_si128(sgn_lo, ADD_OVF(s_lo, d_lo, r_lo));
+                sgn_hi = _mm_or_si128(sgn_hi, ADD_OVF(s_hi, d_hi, r_hi));
+            }
+            s_lo = r_lo;
+            s_hi = r_hi;
+        }
+
+        s_lo = Shl3_round_sse2(s_lo, &ovf_lo);
+        s_hi = Shl3_round_sse2(s_hi, &ovf_hi);
+        _mm_storeu_si128((__m128i *)&v[t * G729_LANES], _mm_packs_epi32(s_lo, s_hi));
+    }
+
+    _mm_storeu_si128((__m128i *)&bad[0], _mm_or_si128(_mm_srai_epi32(sgn_lo, 31), ovf_lo));
+    _mm_storeu_si128((__m128i *)&bad[4], _mm_or_si128(_mm_srai_epi32(sgn_hi, 31), ovf_hi));
+}
+
+#elif defined(G729A_HAVE_NEON)
+
+static void Lanes_chain_neon(G729_Word16 a16[], G729_Word16 v0[], G729_Word16 v[],
+                             G729_Word16 lg, G729_Word16 sub, G729_Word32 bad[])
+{
+    G729_Word16 t, j, l;
+    int16x8_t a[MP1], x;
+    int32x4_t s_lo, s_hi;
+    G729_Word16 *src = sub ? v : v0;
+
+    for (j = 0; j <= M; j++)
+    {
+        a[j] = vld1q_s16(&a16[j * G729_LANES]);
+    }
+
+    for (t = 0; t < lg; t++)
+    {
+        x = vld1q_s16(&v0[t * G729_LANES]);
+        s_lo = vqdmull_s16(vget_low_s16(x), vget_low_s16(a[0]));
+        s_hi = vqdmull_s16(vget_high_s16(x), vget_high_s16(a[0]));
+
+        for (j = 1; j <= M; j++)
+        {
+            x = vld1q_s16(&src[(t - j) * G729_LANES]);
+            if (sub)
+            {
+                s_lo = vqdmlsl_s16(s_lo, vget_low_s16(a[j]), vget_low_s16(x));
+                s_hi = vqdmlsl_s16(s_hi, vget_high_s16(a[j]), vget_high_s16(x));
+            }
+            else
+            {
+                s_lo = vqdmlal_s16(s_lo, vget_low_s16(a[j]), vget_low_s16(x));
+                s_hi = vqdmlal_s16(s_hi, vget_high_s16(a[j]), vget_high_s16(x));
+            }
+        }
+
+        s_lo = vqshlq_n_s32(s_lo, 3);
+        s_hi = vqshlq_n_s32(s_hi, 3);
+        vst1q_s16(&v[t * G729_LANES], vcombine_s16(vqrshrn_n_s32(s_lo, 16), vqrshrn_n_s32(s_hi, 16)));
+    }
+
+    for (l = 0; l < G729_LANES; l++)
+    {
+        bad[l] = 0;
+    }
+}
+
+#endif
+
+/*----------------------------------------------------------------------------*
+ * g729_Residu_lanes - g729_Residu() of n channels                            *
+ *----------------------------------------------------------------------------*/
+void g729_Residu_lanes(G729_Word16 n, G729_Word16 *a[], G729_Word16 *x[],
+                       G729_Word16 *y[], G729_Word16 lg)
+{
+    G729_Word16 l;
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 t;
+    G729_Word16 a16[MP1 * G729_LANES];
+    G729_Word16 xv[(M + L_SUBFR) * G729_LANES];
+    G729_Word16 yv[L_SUBFR * G729_LANES];
+    G729_Word32 bad[G729_LANES];
+
+    if ((n > 1) && (lg <= L_SUBFR))
+    {
+        Lanes_load(n, a, 0, MP1, a16);
+        Lanes_load(n, x, -M, (G729_Word16)(M + lg), xv);
+
+#if defined(G729A_HAVE_SSE2)
+        Lanes_chain_sse2(a16, &xv[M * G729_LANES], yv, lg, 0, bad);
+#else
+        Lanes_chain_neon(a16, &xv[M * G729_LANES], yv, lg, 0, bad);
+#endif
+
+        for (l = 0; l < n; l++)
+        {
+            if (bad[l] != 0)
+            {
+                g729_Residu(a[l], x[l], y[l], lg);
+                continue;
+            }
+            for (t = 0; t < lg; t++)
+            {
+                y[l][t] = yv[t * G729_LANES + l];
+            }
+        }
+        return;
+    }
+#endif
+
+    for (l = 0; l < n; l++)
+    {
+        g729_Residu(a[l], x[l], y[l], lg);
+    }
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Syn_filt_lanes - g729_Syn_filt() of n channels                        *
+ *----------------------------------------------------------------------------*/
+void g729_Syn_filt_lanes(G729_Word16 n, G729_Word16 *a[], G729_Word16 *x[],
+                         G729_Word16 *y[], G729_Word16 lg, G729_Word16 *mem[],
+                         G729_Word16 update)
+{
+    G729_Word16 l;
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 t;
+    G729_Word16 a16[MP1 * G729_LANES];
+    G729_Word16 xv[L_SUBFR * G729_LANES];
+    G729_Word16 yv[(M + L_SUBFR) * G729_LANES];
+    G729_Word32 bad[G729_LANES];
+
+    if ((n > 1) && (lg <= L_SUBFR))
+    {
+        Lanes_load(n, a, 0, MP1, a16);
+        Lanes_load(n, x, 0, lg, xv);
+        Lanes_load(n, mem, 0, M, yv);
+
+#if defined(G729A_HAVE_SSE2)
+        Lanes_chain_sse2(a16, xv, &yv[M * G729_LANES], lg, 1, bad);
+#else
+        Lanes_chain_neon(a16, xv, &yv[M * G729_LANES], lg, 1, bad);
+#endif
+
+        for (l = 0; l < n; l++)
+        {
+            if (bad[l] != 0)
+            {
+                g729_Syn_filt(a[l], x[l], y[l], lg, mem[l], update);
+                continue;
+            }
+            for (t = 0; t < lg; t++)
+            {
+                y[l][t] = yv[(M + t) * G729_LANES + l];
+            }
+            if (update != 0)
+            {
+                for (t = 0; t < M; t++)
+                {
+                    mem[l][t] = yv[(lg + t) * G729_LANES + l];
+                }
+            }
+        }
+        return;
+    }
+#endif
+
+    for (l = 0; l < n; l++)
+    {
+        g729_Syn_filt(a[l], x[l], y[l], lg, mem[l], update);
+    }
+}
+
+/*---------------------------------------------------------------------------*
+ * Chebyshev polynomial of g729_Az_lsp() at several points.                  *
+ *                                                                           *
+ * Each point runs the Chebps_11() (q = 11) or Chebps_10() (q = 10) chain    *
+ * in one lane. The double precision words are kept as the 32-bit words they *
+ * were extracted from: hi = b >> 16, lo = (b & 0xffff) >> 1. SSE2 computes  *
+ * every step in wrapping arithmetic and flags the lanes where an operator   *
+ * would have saturated; then the scalar chain has to be run, and the        *
+ * kernel returns -1. NEON runs the saturating operators themselves.         *
+ *---------------------------------------------------------------------------*/
+
+#define CHEB_LANES  8               /* points per pass */
+
+#if defined(G729A_HAVE_SSE2)
+
+/* 4 points x[] (sign extended) of f[] in Qq, as 32-bit Q14 values */
+static __m128i Chebps_sse2(__m128i x, G729_Word16 f[], G729_Word16 q, __m128i *ovf)
+{
+    G729_Word16 i;
+    __m128i xm, b1, b2, b2_h, d, p, m, t, u;
+    __m128i mask_lo = _mm_set1_epi32(0xffffL);
+    __m128i mask_hi = _mm_set1_epi32((G729_Word32)0xffff0000UL);
+    __m128i shift = _mm_cvtsi32_si128(17 - q);
+
+    xm = _mm_and_si128(x, mask_lo);                     /* (x, 0) pairs         */
+    b2 = _mm_set1_epi32((G729_Word32)1 << (q + 13));    /* b2 = 1.0 in Q(q+13)  */
+    b1 = _mm_add_epi32(_mm_sll_epi32(x, _mm_cvtsi32_si128(q - 1)),
+                       _mm_set1_epi32(f[1] * 8192));    /* b1 = 2*x + f[1]      */
+
+    for (i = 2; i <= NC; i++)
+    {
+        /* t = Mpy_32_16(b1_h, b1_l, x) */
+        L_MULT_LANES(_mm_srai_epi32(b1, 16), xm, d, *ovf);
+        m = _mm_srai_epi32(_mm_madd_epi16(_mm_srli_epi32(_mm_and_si128(b1, mask_lo), 1), xm), 15);
+        m = _mm_add_epi32(m, m);
+        t = _mm_add_epi32(d, m);
+        *ovf = _mm_or_si128(*ovf, ADD_OVF(d, m, t));
+
+        if (i < NC)
+        {
+            u = _mm_add_epi32(t, t);                    /* t = 2.0*x*b1         */
+            *ovf = _mm_or_si128(*ovf, _mm_xor_si128(t, u));
+            t = u;
+        }
+
+        /* t -= b2, L_mult(b2_h, -32768) saturates for b2_h = -32768 */
+        b2_h = _mm_and_si128(b2, mask_hi);
+        *ovf = _mm_or_si128(*ovf, _mm_cmpeq_epi32(b2_h, _mm_set1_epi32(G729A_MIN_32)));
+        u = _mm_sub_epi32(t, b2_h);
+        *ovf = _mm_or_si128(*ovf, SUB_OVF(t, b2_h, u));
+        p = _mm_and_si128(b2, _mm_set1_epi32(0xfffeL));
+        t = _mm_sub_epi32(u, p);
+        *ovf = _mm_or_si128(*ovf, SUB_OVF(u, p, t));
+
+        p = _mm_set1_epi32(f[i] * ((i < NC) ? 8192 : 4096));   /* f[i], f[n]/2 */
+        u = _mm_add_epi32(t, p);
+        *ovf = _mm_or_si128(*ovf, ADD_OVF(t, p, u));
+
+        b2 = b1;
+        b1 = u;
+    }
+
+    /* Q(q+13) to Q30 with saturation, result in Q14 */
+    d = _mm_cmpgt_epi32(b1, _mm_set1_epi32(G729A_MAX_32 >> (17 - q)));
+    m = _mm_cmplt_epi32(b1, _mm_set1_epi32(G729A_MIN_32 >> (17 - q)));
+    t = _mm_srai_epi32(_mm_sll_epi32(b1, shift), 16);
+    t = _mm_andnot_si128(_mm_or_si128(d, m), t);
+    t = _mm_or_si128(t, _mm_and_si128(d, _mm_set1_epi32(G729A_MAX_16)));
+    return _mm_or_si128(t, _mm_and_si128(m, _mm_set1_epi32(G729A_MIN_16)));
+}
+
+#elif defined(G729A_HAVE_NEON)
+
+/* 4 points x[] of f[] in Qq, exactly as Chebps_11() or Chebps_10() */
+static int16x4_t Chebps_neon(int16x4_t x, G729_Word16 f[], G729_Word16 q)
+{
+    G729_Word16 i;
+    int32x4_t b1, b2, t;
+    int16x4_t b1_l, b2_l;
+    int16x4_t one = vdup_n_s16(1);
+
+    b2 = vdupq_n_s32((G729_Word32)1 << (q + 13));       /* b2 = 1.0 in Q(q+13)  */
+    b1 = vqdmull_s16(x, vdup_n_s16((G729_Word16)(1 << (q - 2))));
+    b1 = vqaddq_s32(b1, vqdmull_s16(vdup_n_s16(f[1]), vdup_n_s16(4096)));   /* b1 = 2*x + f[1] */
+
+    for (i = 2; i <= NC; i++)
+    {
+        b1_l = vmovn_s32(vshrq_n_s32(vandq_s32(b1, vdupq_n_s32(0xffff)), 1));
+        b2_l = vmovn_s32(vshrq_n_s32(vandq_s32(b2, vdupq_n_s32(0xffff)), 1));
+
+        t = vqdmull_s16(vshrn_n_s32(b1, 16), x);       /* t = Mpy_32_16(b1, x) */
+        t = vqaddq_s32(t, vqdmull_s16(vqdmulh_s16(b1_l, x), one));
+        if (i < NC)
+        {
+            t = vqshlq_n_s32(t, 1);                     /* t = 2.0*x*b1         */
+        }
+        t = vqaddq_s32(t, vqdmull_s16(vshrn_n_s32(b2, 16), vdup_n_s16(-32768)));
+        t = vqsubq_s32(t, vqdmull_s16(b2_l, one));      /* t -= b2              */
+        t = vqaddq_s32(t, vqdmull_s16(vdup_n_s16(f[i]),
+                                      vdup_n_s16((i < NC) ? 4096 : 2048)));  /* f[i], f[n]/2 */
+
+        b2 = b1;
+        b1 = t;
+    }
+
+    t = vqshlq_s32(b1, vdupq_n_s32(17 - q));           /* Q(q+13) to Q30       */
+    return vshrn_n_s32(t, 16);                          /* Result in Q14        */
+}
+
+#endif
+
+/*----------------------------------------------------------------------------*
+ * g729_Chebps_grid - Chebyshev polynomial f[] at the n points x[]            *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Chebps_grid(G729_Word16 f[], G729_Word16 q, G729_Word16 x[],
+                             G729_Word16 n, G729_Word16 y[])
+{
+#if defined(G729A_HAVE_SSE2)
+    G729_Word16 k, j;
+    G729_Word16 xv[CHEB_LANES];
+    G729_Word16 yv[GRID_POINTS + CHEB_LANES];       /* whole passes of points */
+    __m128i v, ovf = _mm_setzero_si128();
+
+    if (n > GRID_POINTS + 1)
+    {
+        return -1;
+    }
+
+    for (k = 0; k < n; k += CHEB_LANES)
+    {
+        for (j = 0; j < CHEB_LANES; j++)
+        {
+            xv[j] = (k + j < n) ? x[k + j] : 0;
+        }
+        v = _mm_loadu_si128((const __m128i *)xv);
+        _mm_storeu_si128((__m128i *)&yv[k], _mm_packs_epi32(
+            Chebps_sse2(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), f, q, &ovf),
+            Chebps_sse2(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), f, q, &ovf)));
+    }
+
+    if (_mm_movemask_ps(_mm_castsi128_ps(ovf)) != 0)
+    {
+        return -1;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        y[k] = yv[k];
+    }
+
+    return 0;
+#elif defined(G729A_HAVE_NEON)
+    G729_Word16 k, j;
+    G729_Word16 xv[CHEB_LANES], yv[CHEB_LANES];
+
+    for (k = 0; k < n; k += CHEB_LANES)
+    {
+        for (j = 0; j < CHEB_LANES; j++)
+        {
+            xv[j] = (k + j < n) ? x[k + j] : 0;
+        }
+        vst1_s16(&yv[0], Chebps_neon(vld1_s16(&xv[0]), f, q));
+        vst1_s16(&yv[4], Chebps_neon(vld1_s16(&xv[4]), f, q));
+        for (j = 0; j < CHEB_LANES && k + j < n; j++)
+        {
+            y[k + j] = yv[j];
+        }
+    }
+
+    return 0;
+#else
+    /* without vectors, the grid points are evaluated one by one */
+    (void)f;
+    (void)q;
+    (void)x;
+    (void)n;
+    (void)y;
+
+    return -1;
+#endif
+}
+
+/*---------------------------------------------------------------------------*
+ * Nearest codeword of the LSP quantizer.                                    *
+ *                                                                           *
+ * Every term of the distance, L_mult(tmp, tmp) or L_mult(mult(w, tmp),     *
+ * tmp) with w >= 0, is positive: the L_mac() chain is 2*S where S is the    *
+ * exact sum of the products, or saturates at MAX_32 and stays there once S  *
+ * reaches 2^30. Codewords are compared on S clamped to 2^30, which orders   *
+ * them as the chains do. Codewords run along the lanes of cb_t[] rows.      *
+ *---------------------------------------------------------------------------*/
+
+#define VQ_SAT      0x40000000L     /* S of a saturated chain */
+
+/*----------------------------------------------------------------------------*
+ * g729_Lsp_vq_search - first codeword of cb_t[] nearest to x[j0..j1-1]       *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Lsp_vq_search(G729_Word16 x[], G729_Word16 w[], G729_Word16 cb_t[],
+                               G729_Word16 n_cb, G729_Word16 j0, G729_Word16 j1,
+                               G729_Word16 *index)
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 j, k;
+    G729_Word32 dist[NC0];
+    G729_Word32 dmin;
+
+    if ((n_cb > NC0) || ((n_cb & 7) != 0))
+    {
+        return -1;
+    }
+
+    for (k = 0; k < n_cb; k += 8)
+    {
+#if defined(G729A_HAVE_SSE2)
+        __m128i zero = _mm_setzero_si128();
+        __m128i mask = _mm_set1_epi32(VQ_SAT - 1);
+        __m128i acc_lo = zero, acc_hi = zero, sat_lo = zero, sat_hi = zero;
+        __m128i t, u, lo, hi;
+
+        for (j = j0; j < j1; j++)
+        {
+            t = _mm_subs_epi16(_mm_set1_epi16(x[j]),
+                               _mm_loadu_si128((const __m128i *)&cb_t[j * n_cb + k]));
+            u = t;
+            if (w != NULL)
+            {
+                /* u = mult(w[j], t), no saturation with w[j] >= 0 */
+                lo = _mm_mullo_epi16(_mm_set1_epi16(w[j]), t);
+                hi = _mm_mulhi_epi16(_mm_set1_epi16(w[j]), t);
+                u = _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15),
+                                    _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15));
+            }
+            lo = _mm_mullo_epi16(u, t);
+            hi = _mm_mulhi_epi16(u, t);
+
+            /* sums below 2^30 plus a product up to 2^30 stay positive; */
+            /* bit 30 marks the saturated chains                        */
+            acc_lo = _mm_add_epi32(acc_lo, _mm_unpacklo_epi16(lo, hi));
+            acc_hi = _mm_add_epi32(acc_hi, _mm_unpackhi_epi16(lo, hi));
+            sat_lo = _mm_or_si128(sat_lo, acc_lo);
+            sat_hi = _mm_or_si128(sat_hi, acc_hi);
+            acc_lo = _mm_and_si128(acc_lo, mask);
+            acc_hi = _mm_and_si128(acc_hi, mask);
+        }
+
+        sat_lo = _mm_srai_epi32(_mm_slli_epi32(sat_lo, 1), 31);
+        sat_hi = _mm_srai_epi32(_mm_slli_epi32(sat_hi, 1), 31);
+        acc_lo = _mm_or_si128(_mm_andnot_si128(sat_lo, acc_lo), _mm_and_si128(sat_lo, _mm_set1_epi32(VQ_SAT)));
+        acc_hi = _mm_or_si128(_mm_andnot_si128(sat_hi, acc_hi), _mm_and_si128(sat_hi, _mm_set1_epi32(VQ_SAT)));
+        _mm_storeu_si128((__m128i *)&dist[k], acc_lo);
+        _mm_storeu_si128((__m128i *)&dist[k + 4], acc_hi);
+#elif defined(G729A_HAVE_NEON)
+        int32x4_t acc_lo = vdupq_n_s32(0), acc_hi = vdupq_n_s32(0);
+        int16x8_t t, u;
+
+        for (j = j0; j < j1; j++)
+        {
+            t = vqsubq_s16(vdupq_n_s16(x[j]), vld1q_s16(&cb_t[j * n_cb + k]));
+            u = (w != NULL) ? vqdmulhq_s16(vdupq_n_s16(w[j]), t) : t;   /* mult(w[j], t) */
+            acc_lo = vqaddq_s32(acc_lo, vmull_s16(vget_low_s16(u), vget_low_s16(t)));
+            acc_hi = vqaddq_s32(acc_hi, vmull_s16(vget_high_s16(u), vget_high_s16(t)));
+        }
+
+        vst1q_s32(&dist[k], vminq_s32(acc_lo, vdupq_n_s32(VQ_SAT)));
+        vst1q_s32(&dist[k + 4], vminq_s32(acc_hi, vdupq_n_s32(VQ_SAT)));
+#endif
+    }
+
+    /* L_sub(L_dist, L_dmin) < 0 from L_dmin = MAX_32 */
+    *index = 0;
+    dmin = VQ_SAT;
+    for (k = 0; k < n_cb; k++)
+    {
+        if (dist[k] < dmin)
+        {
+            dmin = dist[k];
+            *index = k;
+        }
+    }
+
+    return 0;
+#else
+    /* without vectors, the scalar searches of qua_lsp.c are used */
+    (void)x;
+    (void)w;
+    (void)cb_t;
+    (void)n_cb;
+    (void)j0;
+    (void)j1;
+    (void)index;
+
+    return -1;
+#endif
+}
+
+/*---------------------------------------------------------------------------*
+ * Gain codebook search.                                                     *
+ *                                                                           *
+ * The distance of a gain pair is the sum of 5 Mpy_32_16(coeff[k],          *
+ * coeff_lsf[k], n[k]) with n = g2_pitch, g_pitch, g2_code, g_code and       *
+ * g_pit_cod. Mpy_32_16(hi, lo, n) is 2*(hi*n + mult(lo, n)): with SSE2 the  *
+ * inner sum comes from one madd of (n, mult(lo, n)) pairs by (hi, 1), and   *
+ * lanes where the doubling or an L_add() would saturate are flagged, in     *
+ * which case the scalar search is run instead. NEON uses the saturating     *
+ * operators themselves. A row holds the 8 second stage candidates.          *
+ *---------------------------------------------------------------------------*/
+
+#if defined(G729A_HAVE_SSE2)
+
+/* Mpy_32_16(hi, lo, n) of 4 lanes, n and m = mult(lo, n) interleaved in nm */
+static __m128i Mpy_32_16_sse2(__m128i nm, __m128i hi_one, __m128i *ovf)
+{
+    __m128i v = _mm_madd_epi16(nm, hi_one);
+
+    /* 2*v leaves 32 bits, or L_mult(hi, n) saturated for hi = n = -32768 */
+    *ovf = _mm_or_si128(*ovf, _mm_xor_si128(v, _mm_slli_epi32(v, 1)));
+    *ovf = _mm_or_si128(*ovf, _mm_cmpgt_epi32(v, _mm_set1_epi32(0x3fff7fffL)));
+
+    return _mm_slli_epi32(v, 1);
+}
+
+#endif
+
+/*----------------------------------------------------------------------------*
+ * g729_Gain_search - nearest of n_row x 8 gain pairs                         *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Gain_search(G729_Word16 pit[], G729_Word16 pit2[], G729_Word16 code[],
+                             G729_Word16 stride, G729_Word16 n_row, G729_Word16 gcode0,
+                             G729_Word16 coeff[], G729_Word16 coeff_lsf[],
+                             G729_Word16 gp_max, G729_Word16 *index)
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 r, k, q;
+    G729_Word32 dist[8 * NCODE1];
+    G729_Word32 dmin;
+#if defined(G729A_HAVE_SSE2)
+    __m128i hi_one[5], lo[5], n[5];
+    __m128i vgc0 = _mm_set1_epi16(gcode0);
+    __m128i vgp_max = _mm_set1_epi16(gp_max);
+    __m128i vmax = _mm_set1_epi32(G729A_MAX_32);
+    __m128i ovf = _mm_setzero_si128();
+    __m128i m, skip, L_lo, L_hi, t_lo, t_hi;
+
+    if (n_row > NCODE1)
+    {
+        return -1;
+    }
+
+    for (k = 0; k < 5; k++)
+    {
+        hi_one[k] = _mm_set1_epi32((G729_Word32)(((G729_UWord32)1 << 16) | (G729_UWord16)coeff[k]));
+        lo[k] = _mm_set1_epi16(coeff_lsf[k]);
+    }
+
+    for (r = 0; r < n_row; r++)
+    {
+        n[1] = _mm_loadu_si128((const __m128i *)&pit[r * stride]);          /* g_pitch   */
+        n[0] = _mm_loadu_si128((const __m128i *)&pit2[r * stride]);         /* g2_pitch  */
+        n[3] = mult_sse2(vgc0, _mm_loadu_si128((const __m128i *)&code[r * stride]));  /* g_code */
+        n[2] = mult_sse2(n[3], n[3]);                                       /* g2_code   */
+        n[4] = mult_sse2(n[3], n[1]);                                       /* g_pit_cod */
+
+        for (k = 0; k < 5; k++)
+        {
+            m = mult_sse2(lo[k], n[k]);
+            t_lo = Mpy_32_16_sse2(_mm_unpacklo_epi16(n[k], m), hi_one[k], &ovf);
+            t_hi = Mpy_32_16_sse2(_mm_unpackhi_epi16(n[k], m), hi_one[k], &ovf);
+            if (k == 0)
+            {
+                L_lo = t_lo;
+                L_hi = t_hi;
+            }
+            else
+            {
+                m = _mm_add_epi32(L_lo, t_lo);
+                ovf = _mm_or_si128(ovf, ADD_OVF(L_lo, t_lo, m));
+                L_lo = m;
+                m = _mm_add_epi32(L_hi, t_hi);
+                ovf = _mm_or_si128(ovf, ADD_OVF(L_hi, t_hi, m));
+                L_hi = m;
+            }
+        }
+
+        /* pairs with g_pitch >= gp_max are never taken */
+        skip = _mm_cmplt_epi16(n[1], vgp_max);
+        skip = _mm_xor_si128(skip, _mm_set1_epi16(-1));
+        m = _mm_unpacklo_epi16(skip, skip);
+        L_lo = _mm_or_si128(_mm_andnot_si128(m, L_lo), _mm_and_si128(m, vmax));
+        m = _mm_unpackhi_epi16(skip, skip);
+        L_hi = _mm_or_si128(_mm_andnot_si128(m, L_hi), _mm_and_si128(m, vmax));
+
+        _mm_storeu_si128((__m128i *)&dist[r * 8], L_lo);
+        _mm_storeu_si128((__m128i *)&dist[r * 8 + 4], L_hi);
+    }
+
+    if (_mm_movemask_ps(_mm_castsi128_ps(ovf)) != 0)
+    {
+        return -1;
+    }
+#elif defined(G729A_HAVE_NEON)
+    int16x8_t n[5];
+    int16x8_t vgc0 = vdupq_n_s16(gcode0);
+    int32x4_t L_lo, L_hi;
+    uint16x8_t skip;
+
+    if (n_row > NCODE1)
+    {
+        return -1;
+    }
+
+    for (r = 0; r < n_row; r++)
+    {
+        n[1] = vld1q_s16(&pit[r * stride]);                                 /* g_pitch   */
+        n[0] = vld1q_s16(&pit2[r * stride]);                                /* g2_pitch  */
+        n[3] = vqdmulhq_s16(vgc0, vld1q_s16(&code[r * stride]));           /* g_code    */
+        n[2] = vqdmulhq_s16(n[3], n[3]);                                    /* g2_code   */
+        n[4] = vqdmulhq_s16(n[3], n[1]);                                    /* g_pit_cod */
+
+        L_lo = L_hi = vdupq_n_s32(0);
+        for (k = 0; k < 5; k++)
+        {
+            int16x8_t m = vqdmulhq_n_s16(n[k], coeff_lsf[k]);               /* mult(lo, n) */
+
+            L_lo = vqaddq_s32(L_lo, vqaddq_s32(vqdmull_n_s16(vget_low_s16(n[k]), coeff[k]),
+                                               vqdmull_n_s16(vget_low_s16(m), 1)));
+            L_hi = vqaddq_s32(L_hi, vqaddq_s32(vqdmull_n_s16(vget_high_s16(n[k]), coeff[k]),
+                                               vqdmull_n_s16(vget_high_s16(m), 1)));
+        }
+
+        /* pairs with g_pitch >= gp_max are never taken */
+        skip = vcgeq_s16(n[1], vdupq_n_s16(gp_max));
+        L_lo = vbslq_s32(vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_low_u16(skip)))), vdupq_n_s32(G729A_MAX_32), L_lo);
+        L_hi = vbslq_s32(vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(vget_high_u16(skip)))), vdupq_n_s32(G729A_MAX_32), L_hi);
+
+        vst1q_s32(&dist[r * 8], L_lo);
+        vst1q_s32(&dist[r * 8 + 4], L_hi);
+    }
+#endif
+
+    /* L_sub(L_dist, L_dist_min) < 0 from L_dist_min = MAX_32 */
+    *index = 0;
+    dmin = G729A_MAX_32;
+    q = (G729_Word16)(n_row * 8);
+    for (k = 0; k < q; k++)
+    {
+        if (dist[k] < dmin)
+        {
+            dmin = dist[k];
+            *index = k;
+        }
+    }
+
+    return 0;
+#else
+    /* without vectors, the scalar search of g729_Qua_gain() is used */
+    (void)pit;
+    (void)pit2;
+    (void)code;
+    (void)stride;
+    (void)n_row;
+    (void)gcode0;
+    (void)coeff;
+    (void)coeff_lsf;
+    (void)gp_max;
+    (void)index;
+
+    return -1;
+#endif
+}
+
+/*---------------------------------------------------------------------------*
+ * Closed-loop pitch search.                                                 *
+ *                                                                           *
+ * g729_Dot_mac_lags() gives the correlation of x[] with y[] at n_lag        *
+ * consecutive shifts. One bound 2*sum|x[i]|*max|y[i]| <= MAX_32 for all of  *
+ * them replaces the absolute sums of g729_Dot_mac(), and the vector of x[]  *
+ * is loaded once.                                                           *
+ *                                                                           *
+ * g729_Interpol_lanes() gives 8 consecutive outputs of n interpolation      *
+ * filters of INTER_TAPS taps, with the rounding of g729_round(). The        *
+ * sources of a block are checked against w_abs, the largest sum of the      *
+ * absolute taps, so that no partial sum of the L_mac() chains of           *
+ * g729_Pred_lt_3() can saturate.                                            *
+ *---------------------------------------------------------------------------*/
+
+#define LAG_BLOCK   8               /* outputs of g729_Interpol_lanes() */
+
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+
+/* Largest |x[i]| of n words */
+static G729_Word32 Abs_max(G729_Word16 x[], G729_Word16 n)
+{
+    G729_Word16 i;
+    G729_Word32 v, e = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        v = (x[i] < 0) ? -(G729_Word32)x[i] : (G729_Word32)x[i];
+        if (v > e)
+        {
+            e = v;
+        }
+    }
+
+    return e;
+}
+
+#endif
+
+/*----------------------------------------------------------------------------*
+ * g729_Dot_mac_lags - g729_Dot_mac(0, x, &y[k], n) for k = 0..n_lag-1        *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Dot_mac_lags(G729_Word16 x[], G729_Word16 y[], G729_Word16 n,
+                              G729_Word16 n_lag, G729_Word32 corr[])
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 i, k, m;
+    G729_Word32 s;
+    G729_Word64 a = 0;
+#if defined(G729A_HAVE_SSE2)
+    __m128i xv[L_SUBFR / 8];
+    __m128i acc;
+#else
+    int16x8_t xv[L_SUBFR / 8];
+    int16x8_t yv;
+    int32x4_t acc;
+#endif
+
+    if ((n > L_SUBFR) || (n_lag <= 0))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        a += (x[i] < 0) ? -(G729_Word32)x[i] : (G729_Word32)x[i];
+    }
+
+    /* 2*sum|x[i]*y[k+i]| <= MAX_32: no L_mac() of any lag saturates */
+    if (2 * a * Abs_max(y, (G729_Word16)(n + n_lag - 1)) > G729A_MAX_32)
+    {
+        return -1;
+    }
+
+    m = (G729_Word16)(n & ~7);
+    for (i = 0; i < m; i += 8)
+    {
+#if defined(G729A_HAVE_SSE2)
+        xv[i >> 3] = _mm_loadu_si128((const __m128i *)&x[i]);
+#else
+        xv[i >> 3] = vld1q_s16(&x[i]);
+#endif
+    }
+
+    for (k = 0; k < n_lag; k++)
+    {
+#if defined(G729A_HAVE_SSE2)
+        acc = _mm_setzero_si128();
+        for (i = 0; i < m; i += 8)
+        {
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(xv[i >> 3], _mm_loadu_si128((const __m128i *)&y[k + i])));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+        s = _mm_cvtsi128_si32(acc);
+#else
+        acc = vdupq_n_s32(0);
+        for (i = 0; i < m; i += 8)
+        {
+            yv = vld1q_s16(&y[k + i]);
+            acc = vmlal_s16(acc, vget_low_s16(xv[i >> 3]), vget_low_s16(yv));
+            acc = vmlal_s16(acc, vget_high_s16(xv[i >> 3]), vget_high_s16(yv));
+        }
+        s = vgetq_lane_s32(acc, 0) + vgetq_lane_s32(acc, 1)
+          + vgetq_lane_s32(acc, 2) + vgetq_lane_s32(acc, 3);
+#endif
+        for (i = m; i < n; i++)
+        {
+            s += (G729_Word32)x[i] * (G729_Word32)y[k + i];
+        }
+        corr[k] = 2 * s;
+    }
+
+    return 0;
+#else
+    /* without vectors, the lags are correlated one by one */
+    (void)x;
+    (void)y;
+    (void)n;
+    (void)n_lag;
+    (void)corr;
+
+    return -1;
+#endif
+}
+
+/*----------------------------------------------------------------------------*
+ * g729_Interpol_lanes - 8 outputs of n interpolation filters                 *
+ *----------------------------------------------------------------------------*/
+G729_Word16 g729_Interpol_lanes(G729_Word16 n, G729_Word16 *x[], G729_Word16 *w[],
+                                G729_Word32 w_abs, G729_Word16 *y[])
+{
+#if defined(G729A_HAVE_SSE2) || defined(G729A_HAVE_NEON)
+    G729_Word16 f, m;
+#if defined(G729A_HAVE_SSE2)
+    __m128i a, b, c, L_lo, L_hi;
+    __m128i rnd = _mm_set1_epi32(0x8000L);
+#else
+    int32x4_t L_lo, L_hi;
+    int16x8_t v;
+#endif
+
+    /* 2*w_abs*max|x| + 0x8000 <= MAX_32: neither the chains nor the rounding saturate */
+    for (f = 0; f < n; f++)
+    {
+        if (2 * (G729_Word64)w_abs * Abs_max(x[f], INTER_TAPS + LAG_BLOCK - 1) + 0x8000L > G729A_MAX_32)
+        {
+            return -1;
+        }
+    }
+
+    for (f = 0; f < n; f++)
+    {
+#if defined(G729A_HAVE_SSE2)
+        L_lo = _mm_setzero_si128();
+        L_hi = _mm_setzero_si128();
+        for (m = 0; m < INTER_TAPS; m += 2)
+        {
+            /* lane l gets x[f][m+l]*w[f][m] + x[f][m+1+l]*w[f][m+1] */
+            a = _mm_loadu_si128((const __m128i *)&x[f][m]);
+            b = _mm_loadu_si128((const __m128i *)&x[f][m + 1]);
+            c = _mm_set1_epi32((G729_Word32)(((G729_UWord32)(G729_UWord16)w[f][m + 1] << 16) | (G729_UWord16)w[f][m]));
+            L_lo = _mm_add_epi32(L_lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+            L_hi = _mm_add_epi32(L_hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+        }
+        /* g729_round(2*L) */
+        L_lo = _mm_srai_epi32(_mm_add_epi32(_mm_slli_epi32(L_lo, 1), rnd), 16);
+        L_hi = _mm_srai_epi32(_mm_add_epi32(_mm_slli_epi32(L_hi, 1), rnd), 16);
+        _mm_storeu_si128((__m128i *)y[f], _mm_packs_epi32(L_lo, L_hi));
+#else
+        L_lo = vdupq_n_s32(0);
+        L_hi = vdupq_n_s32(0);
+        for (m = 0; m < INTER_TAPS; m++)
+        {
+            v = vld1q_s16(&x[f][m]);
+            L_lo = vmlal_n_s16(L_lo, vget_low_s16(v), w[f][m]);
+            L_hi = vmlal_n_s16(L_hi, vget_high_s16(v), w[f][m]);
+        }
+        /* g729_round(2*L) = (L + 0x4000) >> 15 */
+        vst1q_s16(y[f], vcombine_s16(vrshrn_n_s32(L_lo, 15), vrshrn_n_s32(L_hi, 15)));
+#endif
+    }
+
+    return 0;
+#else
+    /* without vectors, the L_mac() chains are run */
+    (void)n;
+    (void)x;
+    (void)w;
+    (void)w_abs;
+    (void)y;
+
+    return -1;
+#endif
+}
@@ -0,0 +1,209 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------*
+ * SIMD_FUNC.H                                                   *
+ * ~~~~~~~~~~~                                                   *
+ * Vector kernels for the multiply-accumulate loops of the coder.*
+ *                                                               *
+ * Every kernel returns exactly what the basic operator loop it *
+ * replaces returns. The g729_Dot_mac() kernels also report      *
+ * overflow like g729_L_mac() does, including                    *
+ * G729A_Overflow_Flag when USE_GLOBAL_OVERFLOW_FLAG is 1; their *
+ * vector path is only taken when saturation is proven           *
+ * impossible. The other kernels do not touch the flag. Build    *
+ * with USE_SIMD=0 to always use the scalar loops. The NEON      *
+ * kernels are only built with USE_NEON=1 until they have been   *
+ * verified on an ARM target; ARM builds use the scalar loops.   *
+ *---------------------------------------------------------------*/
+
+#ifndef __G729_SIMD_FUNC_H__
+#define __G729_SIMD_FUNC_H__
+
+#include "g729a_typedef.h"
+
+#define G729_LANES  8       /* channels filtered together by the *_lanes kernels */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+G729_Word32 g729_Dot_mac(   /* (o) : L_mac(...L_mac(L_init, x[0], y[0])..., x[n-1], y[n-1]) */
+  G729_Word32 L_init,       /* (i) : initial value of the accumulator             */
+  G729_Word16 x[],          /* (i) : first vector                                 */
+  G729_Word16 y[],          /* (i) : second vector                                */
+  G729_Word16 n,            /* (i) : vector length                                */
+  G729_Flag *overflow       /* (o) : 1 if the accumulator saturated, may be NULL  */
+);
+
+G729_Word32 g729_Dot_mac_even(  /* (o) : same as g729_Dot_mac() on x[0], x[2], ... */
+  G729_Word32 L_init,       /* (i) : initial value of the accumulator             */
+  G729_Word16 x[],          /* (i) : first vector                                 */
+  G729_Word16 y[],          /* (i) : second vector                                */
+  G729_Word16 n,            /* (i) : vector length, only even indices are used    */
+  G729_Flag *overflow       /* (o) : 1 if the accumulator saturated, may be NULL  */
+);
+
+void g729_Mult_add(
+  G729_Word16 x[],          /* (i)   : first vector                               */
+  G729_Word16 g0,           /* (i)   : Q15 weight of x[]                           */
+  G729_Word16 y[],          /* (i)   : second vector                              */
+  G729_Word16 g1,           /* (i)   : Q15 weight of y[]                           */
+  G729_Word16 z[],          /* (o)   : z[i] = g729_add(g729_mult(g0, x[i]),        */
+                            /*         g729_mult(g1, y[i])), may be x[] or y[]    */
+  G729_Word16 n             /* (i)   : vector length                              */
+);
+
+void g729_Mult_rows(
+  G729_Word16 x[],          /* (i/o) : n_row rows of 8, x[8*r+k] = g729_mult(x[8*r+k], */
+                            /*         row_sign[r] < 0 ? y_inv[k] : y[k])          */
+  G729_Word16 n_row,        /* (i)   : number of rows                             */
+  G729_Word16 row_sign[],   /* (i)   : one sign per row                           */
+  G729_Word16 y[],          /* (i)   : 8 factors of a row with row_sign >= 0      */
+  G729_Word16 y_inv[]       /* (i)   : 8 factors of a row with row_sign < 0       */
+);
+
+/* For candidate k of row r, with ps2 = add(ps1[r], dn[k]), sq2 = mult(ps2, ps2)  */
+/* and alp_16 = round(L_mac(L_mac(L_alp1[r], rr_a[8*r+k], c_a), rr_b[k], c_b)),   */
+/* g729_Acelp_cand() keeps the candidate, in row then k order, when               */
+/* L_msu(L_mult(*alp, sq2), *sq, alp_16) > 0, exactly as the scalar search loop.  */
+
+G729_Word16 g729_Acelp_cand( /* (o) : 8*row+k of the last kept candidate, -1 if none */
+  G729_Word16 n_row,        /* (i)   : number of rows of 8 candidates             */
+  G729_Word16 ps1[],        /* (i)   : correlation of the pulses of each row      */
+  G729_Word16 dn[],         /* (i)   : dn[] of the 8 candidate positions          */
+  G729_Word32 L_alp1[],     /* (i)   : energy of the pulses of each row           */
+  G729_Word16 rr_a[],       /* (i)   : n_row rows of 8, first rr[] term           */
+  G729_Word16 c_a,          /* (i)   : weight of rr_a[], positive                 */
+  G729_Word16 rr_b[],       /* (i)   : second rr[] term, same for all rows        */
+  G729_Word16 c_b,          /* (i)   : weight of rr_b[], positive                 */
+  G729_Word16 *sq,          /* (i/o) : square correlation of the best candidate   */
+  G729_Word16 *alp,         /* (i/o) : energy of the best candidate               */
+  G729_Word16 *ps           /* (o)   : correlation of the best candidate, may be  */
+                            /*         NULL                                       */
+);
+
+G729_Word16 g729_Cor_h_rr(  /* (o) : 0, or -1 if the L_mac() chains could saturate */
+                            /*       or there is no vector unit: rr[] is not set  */
+  G729_Word16 h[],          /* (i) : scaled impulse response, L_SUBFR words       */
+  G729_Word16 rr[]          /* (o) : DIM_RR correlations of h[], Cor_h() layout   */
+);
+
+G729_Word16 g729_Chebps_grid( /* (o) : 0, or -1 if a chain saturated or there is */
+                            /*       no vector unit: y[] is not set             */
+  G729_Word16 f[],          /* (i) Qq  : coefficients of the polynomial           */
+  G729_Word16 q,            /* (i)     : Q format of f[], 11 or 10                */
+  G729_Word16 x[],          /* (i) Q15 : points, at most GRID_POINTS+1            */
+  G729_Word16 n,            /* (i)     : number of points                         */
+  G729_Word16 y[]           /* (o) Q14 : Chebps_11() or Chebps_10() of f[] at x[] */
+);
+
+/* g729_Lsp_vq_search() returns the codeword of the smallest L_mac() chain of */
+/* g729_Lsp_pre_select() (w == NULL) or g729_Lsp_select_1/2(), the first of  */
+/* equal ones, exactly as the scalar search loops.                           */
+
+G729_Word16 g729_Lsp_vq_search( /* (o) : 0, or -1 if there is no vector unit:  */
+                            /*       *index is not set                          */
+  G729_Word16 x[],          /* (i) Q13 : target vector                            */
+  G729_Word16 w[],          /* (i)     : weights >= 0 of the distance, or NULL    */
+  G729_Word16 cb_t[],       /* (i) Q13 : codebook by columns, cb_t[j*n_cb+k]      */
+  G729_Word16 n_cb,         /* (i)     : codewords, a multiple of 8, <= NC0       */
+  G729_Word16 j0,           /* (i)     : first coefficient of the distance        */
+  G729_Word16 j1,           /* (i)     : last coefficient + 1                     */
+  G729_Word16 *index        /* (o)     : selected codeword                        */
+);
+
+/* g729_Gain_search() returns the pair of the smallest distance of the       */
+/* g729_Qua_gain() codebook search, the first of equal ones, exactly as the  */
+/* scalar search loop. Row r, lane j of pit[], pit2[] and code[] is at       */
+/* r*stride+j, as in g729_gbk12_pit[cand1][cand2] and the like.              */
+
+G729_Word16 g729_Gain_search( /* (o) : 0, or -1 if the sums could saturate or  */
+                            /*       there is no vector unit: *index not set    */
+  G729_Word16 pit[],        /* (i) Q14 : g_pitch of the pairs                     */
+  G729_Word16 pit2[],       /* (i) Q13 : mult(g_pitch, g_pitch) of the pairs      */
+  G729_Word16 code[],       /* (i) Q12 : code gain factor of the pairs            */
+  G729_Word16 stride,       /* (i)     : distance between two rows                */
+  G729_Word16 n_row,        /* (i)     : rows of 8 pairs, <= NCODE1               */
+  G729_Word16 gcode0,       /* (i)     : predicted code gain                      */
+  G729_Word16 coeff[],      /* (i)     : 5 distance coefficients, high part       */
+  G729_Word16 coeff_lsf[],  /* (i)     : 5 distance coefficients, low part        */
+  G729_Word16 gp_max,       /* (i) Q14 : pairs with g_pitch >= gp_max are skipped */
+  G729_Word16 *index        /* (o)     : 8*row+lane of the selected pair          */
+);
+
+/* g729_Dot_mac_lags() returns g729_Dot_mac(0, x, &y[k], n, NULL) in       */
+/* corr[k] for the n_lag shifts k, as the lags of the closed-loop pitch      */
+/* search, when no L_mac() of any shift can saturate.                        */
+
+G729_Word16 g729_Dot_mac_lags( /* (o) : 0, or -1 if a sum could saturate or   */
+                            /*       there is no vector unit: corr[] not set    */
+  G729_Word16 x[],          /* (i) : first vector                                 */
+  G729_Word16 y[],          /* (i) : second vector, y[0..n+n_lag-2] are read      */
+  G729_Word16 n,            /* (i) : vector length, <= L_SUBFR                    */
+  G729_Word16 n_lag,        /* (i) : number of shifts                             */
+  G729_Word32 corr[]        /* (o) : correlation at each shift                    */
+);
+
+/* g729_Interpol_lanes() sets y[f][l] = g729_round(2*sum(x[f][l+m]*w[f][m])) */
+/* for l = 0..7, which is the L_mac() chain of g729_Pred_lt_3() for the taps */
+/* of g729_inter_3l_taps[], when none of its sums can saturate.              */
+
+G729_Word16 g729_Interpol_lanes( /* (o) : 0, or -1 if a sum could saturate or */
+                            /*       there is no vector unit: y[] not set       */
+  G729_Word16 n,            /* (i)     : number of filters                        */
+  G729_Word16 *x[],         /* (i)     : source of each filter, INTER_TAPS+7 words */
+  G729_Word16 *w[],         /* (i) Q15 : INTER_TAPS taps of each filter         */
+  G729_Word32 w_abs,        /* (i)     : largest sum of |w[f][m]| of the filters  */
+  G729_Word16 *y[]          /* (o)     : 8 outputs of each filter                 */
+);
+
+/* The *_lanes kernels filter n independent channels, channel l with a[l],   */
+/* x[l], y[l] and mem[l], exactly as n calls of the scalar filter would.     */
+
+void g729_Residu_lanes(
+  G729_Word16 n,            /* (i)     : number of channels, 1..G729_LANES        */
+  G729_Word16 *a[],         /* (i) Q12 : prediction coefficients of each channel  */
+  G729_Word16 *x[],         /* (i)     : speech, x[l][-M..lg-1] are needed         */
+  G729_Word16 *y[],         /* (o)     : residual signal of each channel          */
+  G729_Word16 lg            /* (i)     : size of filtering, <= L_SUBFR            */
+);
+
+void g729_Syn_filt_lanes(
+  G729_Word16 n,            /* (i)     : number of channels, 1..G729_LANES        */
+  G729_Word16 *a[],         /* (i) Q12 : a[m+1] coefficients of each channel      */
+  G729_Word16 *x[],         /* (i)     : input signal of each channel             */
+  G729_Word16 *y[],         /* (o)     : output signal of each channel            */
+  G729_Word16 lg,           /* (i)     : size of filtering, M..L_SUBFR            */
+  G729_Word16 *mem[],       /* (i/o)   : filter memory of each channel            */
+  G729_Word16 update        /* (i)     : 0=no update, 1=update of memory          */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __G729_SIMD_FUNC_H__ */
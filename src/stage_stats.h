@@ -0,0 +1,111 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*---------------------------------------------------------------*
+ * STAGE_STATS.H                                                 *
+ * ~~~~~~~~~~~~~                                                 *
+ * Per-stage cycle counters of the encoder and decoder state.    *
+ *                                                               *
+ * With USE_STAGE_STATS=1, G729_STATS_START reads the clock and  *
+ * G729_STATS_STOP(stats, stage) charges the time since the last *
+ * mark to the stage, counts one call and restarts the clock, so *
+ * that consecutive stages cost one clock read each.             *
+ * G729_STATS_ADD() charges the time without counting a call and *
+ * G729_STATS_SHARE(states, n, stage) splits it evenly between   *
+ * the n channels run in lockstep by g729_Coder_ld8a_lanes().    *
+ * Otherwise every macro expands to nothing.                     *
+ *---------------------------------------------------------------*/
+
+#ifndef __G729_STAGE_STATS_H__
+#define __G729_STAGE_STATS_H__
+
+#include "g729a_typedef.h"
+#include "g729a_stats.h"
+
+#if defined(USE_STAGE_STATS) && (USE_STAGE_STATS == 1)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define g729_Stats_clock()  ((G729_Word64)__rdtsc())
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define g729_Stats_clock()  ((G729_Word64)__rdtsc())
+#else
+#include <time.h>
+static inline G729_Word64 g729_Stats_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (G729_Word64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+#define G729_STATS_DECL     G729_Word64 stats_t0_ = 0, stats_t1_;
+
+#define G729_STATS_START    (stats_t0_ = g729_Stats_clock())
+
+#define G729_STATS_STOP(stats, stage)                   \
+    do {                                                \
+        stats_t1_ = g729_Stats_clock();                 \
+        (stats)->cycles[stage] += stats_t1_ - stats_t0_;\
+        (stats)->calls[stage]++;                        \
+        stats_t0_ = stats_t1_;                          \
+    } while (0)
+
+#define G729_STATS_ADD(stats, stage)                    \
+    do {                                                \
+        stats_t1_ = g729_Stats_clock();                 \
+        (stats)->cycles[stage] += stats_t1_ - stats_t0_;\
+        stats_t0_ = stats_t1_;                          \
+    } while (0)
+
+#define G729_STATS_SHARE(states, n, stage)              \
+    do {                                                \
+        G729_Word16 l_;                                 \
+        stats_t1_ = g729_Stats_clock();                 \
+        for (l_ = 0; l_ < (n); l_++)                    \
+        {                                               \
+            (states)[l_]->stats.cycles[stage] +=        \
+                (stats_t1_ - stats_t0_) / (n);          \
+        }                                               \
+        stats_t0_ = stats_t1_;                          \
+    } while (0)
+
+#define G729_STATS_FRAME(stats)     ((stats)->frames++)
+
+#else
+
+#define G729_STATS_DECL
+#define G729_STATS_START
+#define G729_STATS_STOP(stats, stage)
+#define G729_STATS_ADD(stats, stage)
+#define G729_STATS_SHARE(states, n, stage)
+#define G729_STATS_FRAME(stats)
+
+#endif
+
+#endif  /* __G729_STAGE_STATS_H__ */
+/* end of file */
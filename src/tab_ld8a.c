@@ -355,6 +355,225 @@ G729_Word16 g729_lspcb2[NC1][M] = {        /* Q13 */
 { 1320,   827,  -398,  -576,   341,  -774,  -483, -1247,   -70,    98},
 { -163,   674,   -11,  -886,   531, -1125,  -265,  -242,   724,   934}
 };
+
+/* g729_lspcb1[] and g729_lspcb2[] by columns, row j holding coefficient j */
+/* of every codeword, for the vector searches of qua_lsp.c                 */
+
+G729_Word16 g729_lspcb1_t[M][NC0] = {        /* Q13 */
+{
+   1486,  1730,  1568,  1733,  1744,  1786,  1631,  1489,  1869,  2070,
+   1910,  1141,  2192,  1286,  1921,  2052,  1798,  1009,  3016,  2203,
+   2912,  2861,  3069,  2434,  2020,  1877,  2107,  1612,  2420,  1667,
+   2388,  1875,   679,  1838,  1303,  1438,   860,  1673,  1246,  1525,
+   1196,  2147,  1585,  1778,  1862,  1395,  1444,  2004,  1495,  2484,
+   2424,  2565,  2727,  1916,  3384,  3075,  1751,  1442,  2294,  1937,
+   2071,  1740,  2199,  1943,  1825,  2464,  2550,  3003,  3455,  3052,
+   3671,  2716,  1945,  2304,  1800,  1436,  2319,  2187,  2235,  1765,
+   3460,  3735,  3521,  2141,  4148,  4403,  4091,  2746,  2248,  1279,
+   2440,  1879,  2804,  2023,  2823,  2851,  1348,  2141,  1608,  2774,
+   1934,  2288,  2951,  3256,  1827,  1000,  1646,  1708,  2623,  2518,
+   1726,  2860,  4247,  3502,  3151,  3960,  4499,  4251,  3769,  3083,
+   2731,  1187,  1911,  1764,  1400,  2322,  2630,  1721
+},
+{
+   2168,  2640,  2256,  2512,  2436,  2369,  2433,  2364,  2533,  3025,
+   2673,  1815,  3171,  1907,  2720,  2759,  2497,  1647,  3794,  3040,
+   4292,  3607,  4311,  3661,  2605,  2809,  2873,  2284,  3156,  2612,
+   3017,  2786,  1411,  2596,  1955,  2102,  1904,  2723,  1849,  2260,
+   1846,  3106,  2405,  2688,  2586,  2156,  2117,  2895,  2863,  3114,
+   3277,  3778,  3384,  2953,  4366,  4283,  2455,  2188,  2895,  2659,
+   2663,  2491,  2881,  2988,  3175,  3046,  3393,  3799,  4157,  3769,
+   4356,  3684,  2638,  2928,  2516,  2224,  2899,  2919,  2923,  2638,
+   5741,  4426,  4778,  2968,  6128,  5367,  5386,  3625,  3556,  1960,
+   3475,  2514,  3688,  2682,  3605,  3681,  2645,  3036,  2375,  3616,
+   4813,  3507,  3771,  4791,  2614,  1704,  2286,  2501,  3510,  3434,
+   2383,  3735,  5993,  4051,  4893,  4848,  6604,  5541,  5327,  3969,
+   4670,  2227,  2477,  2519,  3674,  3073,  3339,  2577
+},
+{
+   3751,  3450,  3088,  3357,  3308,  3372,  3361,  3291,  3475,  4333,
+   3419,  2624,  4707,  2548,  4604,  3897,  5617,  2889,  5406,  3796,
+   7988,  5923,  5967,  4866,  3860,  3590,  3673,  2944,  6542,  3534,
+   4839,  4231,  4654,  3578,  2395,  2663,  6098,  3704,  2902,  3862,
+   3104,  4475,  2994,  3614,  3492,  2669,  3286,  3783,  6360,  5718,
+   5296,  5360,  6613,  6274,  5349,  5951,  5147,  3330,  4070,  4602,
+   4216,  3488,  4675,  4177,  7062,  4822,  5305,  5321,  6838,  4891,
+   5827,  5246,  4130,  4122,  3350,  2753,  4980,  4610,  5121,  3751,
+   9596,  6199,  6887,  6865,  9028,  6634,  6852,  5299,  8539,  3920,
+   6737,  4497,  7490,  3873,  5815,  5280,  5826,  4293,  3384,  5014,
+   6204,  5037,  4878,  6601,  3486,  3002,  3109,  3315,  4478,  4728,
+   4090,  4838,  7952,  5680,  5899,  5926,  8036,  6654,  7865,  6248,
+   7063,  4737,  3915,  3887,  7131,  4287,  4758,  5553
+},
+{
+   9074,  4870,  4874,  4708,  8731,  4521,  6328,  6250,  4365,  5854,
+   4261,  4623,  5808,  3453,  6684,  5246, 11449,  5709,  7469,  5442,
+   9572,  7034,  7367,  5798,  9241,  4707,  5799,  3572, 10215,  5237,
+   9333,  6320,  8006,  4608,  3322,  3462,  7775,  6125,  4508,  5659,
+   7063,  6511,  4036,  4680,  6719,  3386,  6233,  4897,  8100,  7097,
+   6284,  6989,  9254,  8088,  7667,  7619,  9966,  6813,  8035,  6697,
+   9445,  8138,  8527,  6039,  9818,  5977,  6920,  6437,  8199,  5810,
+   6997,  6686,  7995,  4824,  5219,  4546,  6936,  5875,  6259,  5730,
+  11742,  7363,  8680,  8051, 10871,  8371,  8770,  7504, 10590,  7793,
+   8654,  7572, 10086,  8268,  8595,  7648,  8785,  6082,  6878,  6557,
+   7212,  6841,  7578,  7521,  6039,  6335,  7245,  6737,  5645,  6388,
+   6303,  6044,  9792,  6805,  7198,  7259,  9251,  8318,  9360,  8121,
+   9201,  7214, 10098,  6944,  8718,  8108,  8360,  7195
+},
+{
+  12134,  6126, 11063,  6977, 10432,  6795, 10709,  9227,  9152,  7805,
+  11168,  6495, 10904,  9574, 11503,  6638, 13189,  9541, 12488, 11987,
+  11562,  9234, 11482, 10383, 13275, 11056, 13579,  8219, 12061, 10513,
+  11413,  8694, 11446,  5650, 12023,  8328,  9815,  7668,  7221,  7342,
+  10972,  8227, 11481,  9465, 11708, 10607,  9423,  6168, 11399,  8400,
+  11290,  8782, 10542,  9710, 11180,  9604, 11621,  8929, 12233,  9071,
+  10887,  9656, 10051,  7478, 12824,  7696, 10235,  7919,  9877,  6977,
+   8460,  8463, 14338,  5640, 13406,  9657,  8404,  7390,  8099,  7883,
+  14413,  9250, 12717, 10010, 12686, 10163, 11563, 10262, 12665, 10153,
+  12190, 10017, 11218, 10255, 10085,  9173, 10620,  7593,  9970,  7788,
+   8979,  8278,  9016,  8644, 12149,  8471, 11493,  8729,  9862,  8082,
+   7805,  7254, 12342,  8146, 11418,  8811, 10804,  9900, 10684,  9798,
+  11346,  9622, 11616,  9150, 10688,  9407, 10274,  8651
+},
+{
+  13944,  7876, 13393, 10296, 12007, 12963, 12013, 10403, 14513,  9231,
+  15111,  9588, 12500, 11964, 12992, 10267, 14711, 12354, 13984, 13512,
+  13244, 12054, 12699, 11722, 14644, 12441, 14687, 13959, 13534, 11696,
+  12730, 10149, 13249, 11274, 13764, 10362, 12007,  9447, 12710, 11748,
+  12905,  9765, 13177, 11064, 13012, 12125, 12981,  7297, 14271, 12616,
+  12903, 10428, 12236, 10925, 12605, 11010, 13176, 12135, 13416, 12863,
+  12292, 11153, 11408,  8536, 15450, 15398, 14083, 11643, 12314, 10126,
+  12084, 10001, 15576, 13139, 15948, 11245, 13489, 12556, 13589, 10108,
+  16080, 14489, 14322, 13159, 14005, 11599, 13290, 11432, 14696, 14753,
+  14588, 14948, 12711, 11645, 11469, 10338, 12831, 10629, 11227,  8959,
+  11665,  9638, 10298,  9707, 13823, 10500, 12791,  9924, 11115,  9285,
+  12845,  8402, 14653, 11945, 13073, 10529, 12627, 11686, 11818, 10994,
+  13735, 12633, 12955, 12590, 12508, 10628, 11333, 10686
+},
+{
+  17983, 15644, 18307, 17024, 15614, 17674, 13277, 13843, 15908, 10597,
+  16577, 13968, 14162, 15978, 14350, 15834, 17050, 15231, 15328, 14931,
+  14556, 13729, 14309, 13049, 16010, 15622, 15938, 15924, 15305, 12940,
+  15024, 11785, 15763, 14355, 15883, 13763, 14821, 13683, 14835, 13370,
+  14814, 10984, 14519, 12473, 14364, 13614, 14998, 12609, 15902, 14073,
+  16022, 14390, 14651, 12392, 13921, 12384, 14739, 14476, 14762, 14197,
+  13949, 13206, 14435, 14181, 18330, 16730, 18143, 15810, 15905, 14788,
+  14154, 12394, 17057, 15825, 17618, 15177, 15554, 14033, 15340, 13633,
+  18173, 16035, 15950, 14813, 15976, 14963, 15728, 13172, 16515, 16646,
+  17119, 16141, 16307, 15187, 16568, 14961, 16255, 17158, 16928, 17068,
+  15989, 15066, 14490, 13398, 16191, 14878, 16824, 16089, 15219, 13162,
+  14612, 14031, 17527, 16649, 15124, 15661, 15880, 15100, 13660, 12393,
+  16875, 15404, 16223, 16258, 15708, 15862, 12880, 15069
+},
+{
+  19173, 17817, 19293, 17956, 16639, 18988, 13904, 15278, 17022, 16047,
+  17591, 16428, 15664, 17344, 15262, 16814, 18195, 18494, 16334, 16370,
+  16529, 18056, 16233, 15668, 17099, 17168, 17077, 17239, 16452, 16798,
+  16248, 17013, 18127, 15886, 18077, 17248, 16709, 14443, 16314, 14442,
+  17037, 12161, 15431, 16320, 16128, 16705, 15853, 16445, 17711, 14847,
+  17508, 15742, 15687, 16434, 15324, 14006, 16470, 15306, 17367, 15230,
+  14909, 14688, 15463, 15551, 19856, 17646, 19195, 16846, 16826, 15990,
+  14939, 14131, 18206, 16938, 18540, 16317, 16281, 16794, 16340, 15419,
+  19090, 17026, 18050, 15861, 17208, 16331, 16930, 15490, 17824, 18139,
+  17925, 16897, 17470, 17102, 17462, 16148, 18319, 18033, 17650, 18302,
+  17811, 16481, 15242, 16078, 17282, 16979, 17667, 17097, 18067, 18383,
+  17608, 16381, 18774, 17444, 17673, 16560, 17512, 17093, 15366, 13686,
+  18797, 17968, 17138, 16984, 17711, 16693, 17374, 16953
+},
+{
+  21190, 20294, 21109, 19145, 21359, 20855, 19441, 17721, 20611, 20109,
+  19310, 19351, 21124, 19691, 16997, 18149, 20307, 20966, 19952, 17856,
+  20004, 20262, 18333, 18862, 19268, 18761, 18890, 18592, 18717, 18058,
+  17449, 18608, 20361, 20579, 20180, 19732, 19787, 20538, 19335, 18044,
+  19922, 18971, 19967, 19742, 19610, 18976, 17188, 19297, 20479, 20535,
+  19333, 17770, 20074, 20010, 19901, 20658, 20788, 19635, 18952, 16047,
+  19236, 20896, 17190, 17622, 21830, 20588, 20681, 18119, 19949, 19773,
+  19247, 16150, 20225, 20108, 20531, 17489, 20270, 20998, 17927, 16808,
+  20845, 19873, 20166, 17528, 19587, 17982, 19056, 16875, 20268, 20679,
+  19110, 18397, 20077, 18965, 18754, 17559, 21133, 21466, 20185, 19537,
+  20426, 21653, 20223, 19102, 21423, 20026, 18981, 18374, 19583, 19819,
+  19269, 18037, 20831, 20390, 20520, 18196, 20020, 20572, 18733, 17888,
+  20787, 20262, 19270, 17924, 19720, 19714, 19221, 18703
+},
+{
+  21820, 21902, 21741, 20350, 21913, 21640, 21088, 21451, 21411, 21834,
+  20265, 21286, 21789, 22495, 20791, 21675, 21182, 22033, 20791, 18803,
+  21073, 20974, 19172, 19831, 20251, 19907, 19831, 20117, 19880, 19378,
+  18677, 19960, 21567, 21754, 21232, 22344, 21132, 21731, 22720, 21334,
+  22636, 21300, 21275, 20800, 20425, 21367, 21857, 21465, 22061, 21396,
+  20283, 21734, 21102, 21183, 20754, 21497, 21756, 20544, 19688, 18877,
+  20341, 21907, 20597, 21579, 22412, 21320, 21336, 18980, 20892, 20904,
+  20423, 19776, 20997, 21054, 21252, 19135, 20911, 21769, 20159, 18574,
+  21601, 20876, 21145, 18655, 20595, 18768, 20102, 17514, 21247, 21466,
+  19979, 19376, 21126, 19788, 19876, 18474, 22586, 22084, 21120, 20542,
+  21703, 22214, 20990, 20249, 22041, 22427, 20222, 19917, 20382, 20552,
+  20181, 19410, 21699, 21564, 21861, 20183, 21046, 21687, 19882, 19105,
+  22360, 23533, 20729, 18435, 21068, 21474, 19936, 19929
+}
+};
+
+G729_Word16 g729_lspcb2_t[M][NC1] = {        /* Q13 */
+{
+   -435,  -833, -1021,    57,   171,  -701,   584,  -109,  -859,  -877,
+    -77,  -314,   711,  -112,   575,   145, -1133, -1459,   -15,  -338,
+    389,  -312,  1127,   539,  2197, -1596,  1154,   397,   334,  -545,
+   1320,  -163
+},
+{
+   -815,  -891,   231,  -198,  -350,  -842,    31,  -808,  1236,  -954,
+    344,  -307,   693,  -271,   -10,  -285,  -835, -1237,    66,   148,
+    239,   -98,   584,  -114,  2337,   550,   593,   558,  1475,  -330,
+    827,   674
+},
+{
+   -742,   463,  -306,  -339,   294,   -58,  -289,   231,   550, -1248,
+   -620,  -256,   521,  -500,  -468, -1280,  1350,   416,   468,  1445,
+   1568,   949,   835,   856,  1268,   801,   -77,   203,   632,  -429,
+   -398,   -11
+},
+{
+   1033,    -8,   321,   -33,  1660,   950,   356,    77,   854,  -299,
+    763, -1260,   650,   946,  -199,  -398,  1284,  -213,  1019,    75,
+    981,    31,   277,  -493,   670,  -456,  1237,  -797,   -80,  -680,
+   -576,  -886
+},
+{
+   -518, -1251,  -220, -1468,   453,   892,  -333,   -87,   714,   212,
+    413,  -429,  1305,  1733,  1101,    36,   -95,   466,  -748,  -760,
+    113,  1104, -1159,   223,   304,   -56,   -31,  -919,    48,  1133,
+    341,   531
+},
+{
+    582,  1450,  -163,   573,   519,  1549,  -457,  -344,  -543,  -235,
+    502,   450,   -28,   271, -1011,  -498,  1015,   669,  1385,   569,
+    369,    72,   208,  -912,  -267,  -697,   581,     3, -1061, -1182,
+   -774, -1125
+},
+{
+  -1201,    72,  -526,   796,   291,   715,   612,  1341, -1752,  -728,
+   -362,  -466,  -378,   -15,   581, -1377,  -222,   659,  -182,  1247,
+  -1003,  -141,   301,   623,  -525,   865, -1037,   692,  -484,  -744,
+   -483,  -265
+},
+{
+    829,  -231,  -754,  -169,   159,   527,  -283,  1087,  -195,   949,
+   -960,  -108,   744,   909,   -53,    18,   443,  1640,  -907,   337,
+   -507,  1465,  -882,   -76,   140,  1060,  -895,  -292,   362,  1340,
+  -1247,  -242
+},
+{
+     86,   864, -1633,  -631,  -640,  -714, -1381,  -654,   -98,  1517,
+   -483,  1010, -1005,  -259,  -747,  -444,   372,   932,  -721,   416,
+   -587,    63,   117,   276,   882,   413,   669,  1050,  -597,   262,
+    -70,   724
+},
+{
+    385,   661,   267,   816, -1296,  -193,  -741,  -569,  -276,   895,
+   1386,  2223,   240,  1688,   878,  1483,  -354,   534,  -262,  -121,
+   -904,  -785,  -404,  -440,  -139,   446,   297,   782,  -852,    63,
+     98,   934
+}
+};
 G729_Word16 g729_fg[2][MA_NP][M] = {       /* Q15 */
   {
     { 8421,  9109,  9175,  8965,  9034,  9057,  8765,  8775,  9106,  8673},
@@ -436,6 +655,18 @@ G729_Word16 g729_inter_3l[FIR_SIZE_SYN] = {
    0.002780,   0.002145,   0.000000};
   */
 
+/* g729_inter_3l[] as the taps m = -L_INTER10..L_INTER10+1 around x[j-T0]   */
+/* of g729_Pred_lt_3() for the fractions 0, -1/3 and +1/3, in that order    */
+
+G729_Word16 g729_inter_3l_taps[UP_SAMP][INTER_TAPS] = {
+ {      0,     34,   -120,    308,   -634,   1099,  -1666,   2259,  -2783,   3143,  29443,
+     3143,  -2783,   2259,  -1666,   1099,   -634,    308,   -120,     34,      0,      0 },
+ {      0,     91,   -165,    296,   -451,    550,   -464,      0,   1211,  -4402,  25207,
+    14701,  -5850,   3130,  -1652,    756,   -245,      0,     78,    -79,     70,      0 },
+ {     70,    -79,     78,      0,   -245,    756,  -1652,   3130,  -5850,  14701,  25207,
+    -4402,   1211,      0,   -464,    550,   -451,    296,   -165,     91,      0,      0 }
+};
+
 /*-----------------------------------------------------*
  | Tables for gain related routines .                  |
  -----------------------------------------------------*/
@@ -476,6 +707,68 @@ G729_Word16 g729_gbk2[NCODE2][2] = {
  { 18973 ,  5935 }
 };
 
+/* The NCODE1 x NCODE2 gain pairs for the vector search of g729_Qua_gain(), */
+/* row i, column j: g_pitch = add(g729_gbk1[i][0], g729_gbk2[j][0]), its    */
+/* square mult(g_pitch, g_pitch), and the Q12 code gain factor              */
+/* (g729_gbk1[i][1] + g729_gbk2[j][1]) >> 1                                 */
+
+G729_Word16 g729_gbk12_pit[NCODE1][NCODE2] = {   /* Q14 */
+ {   827,  1995,  5143,  6161,  8092,  9121, 10574, 11570,
+   13261, 14195, 15133, 15162, 15435, 16113, 17300, 18974 },
+ {  2377,  3545,  6693,  7711,  9642, 10671, 12124, 13120,
+   14811, 15745, 16683, 16712, 16985, 17663, 18850, 20524 },
+ {  2657,  3825,  6973,  7991,  9922, 10951, 12404, 13400,
+   15091, 16025, 16963, 16992, 17265, 17943, 19130, 20804 },
+ {   883,  2051,  5199,  6217,  8148,  9177, 10630, 11626,
+   13317, 14251, 15189, 15218, 15491, 16169, 17356, 19030 },
+ {  2747,  3915,  7063,  8081, 10012, 11041, 12494, 13490,
+   15181, 16115, 17053, 17082, 17355, 18033, 19220, 20894 },
+ {  4068,  5236,  8384,  9402, 11333, 12362, 13815, 14811,
+   16502, 17436, 18374, 18403, 18676, 19354, 20541, 22215 },
+ {  1182,  2350,  5498,  6516,  8447,  9476, 10929, 11925,
+   13616, 14550, 15488, 15517, 15790, 16468, 17655, 19329 },
+ {  3504,  4672,  7820,  8838, 10769, 11798, 13251, 14247,
+   15938, 16872, 17810, 17839, 18112, 18790, 19977, 21651 }
+};
+
+G729_Word16 g729_gbk12_pit2[NCODE1][NCODE2] = {   /* Q13 */
+ {    20,   121,   807,  1158,  1998,  2538,  3412,  4085,
+    5366,  6149,  6988,  7015,  7270,  7923,  9133, 10986 },
+ {   172,   383,  1367,  1814,  2837,  3475,  4485,  5253,
+    6694,  7565,  8493,  8523,  8804,  9520, 10843, 12855 },
+ {   215,   446,  1483,  1948,  3004,  3659,  4695,  5479,
+    6950,  7836,  8781,  8811,  9096,  9825, 11168, 13208 },
+ {    23,   128,   824,  1179,  2026,  2570,  3448,  4124,
+    5412,  6197,  7040,  7067,  7323,  7978,  9192, 11051 },
+ {   230,   467,  1522,  1992,  3059,  3720,  4763,  5553,
+    7033,  7925,  8874,  8904,  9191,  9923, 11273, 13322 },
+ {   505,   836,  2145,  2697,  3919,  4663,  5824,  6694,
+    8310,  9277, 10302, 10335, 10644, 11431, 12876, 15060 },
+ {    42,   168,   922,  1295,  2177,  2740,  3645,  4339,
+    5657,  6460,  7320,  7347,  7608,  8276,  9512, 11401 },
+ {   374,   666,  1866,  2383,  3539,  4247,  5358,  6194,
+    7752,  8687,  9680,  9711, 10011, 10774, 12178, 14305 }
+};
+
+G729_Word16 g729_gbk12_code[NCODE1][NCODE2] = {   /* Q12 */
+ {  1760,   758,  1054,  1955,  3188,  1020,  2241,  1356,
+    2386,  1573,  3215,  7896,   876,  2454,  1688,  3725 },
+ {  2215,  1212,  1508,  2410,  3643,  1475,  2695,  1810,
+    2840,  2027,  3669,  8350,  1331,  2908,  2143,  4180 },
+ {  3513,  2511,  2807,  3708,  4941,  2773,  3994,  3109,
+    4139,  3326,  4968,  9649,  2629,  4207,  3441,  5478 },
+ {  3704,  2702,  2998,  3899,  5132,  2964,  4185,  3300,
+    4330,  3517,  5159,  9840,  2820,  4398,  3632,  5669 },
+ {  5648,  4645,  4941,  5843,  7076,  4908,  6128,  5243,
+    6273,  5460,  7102, 11783,  4764,  6341,  5576,  7613 },
+ {  5977,  4974,  5270,  6172,  7405,  5237,  6457,  5572,
+    6602,  5789,  7431, 12112,  5093,  6670,  5905,  7942 },
+ {  8380,  7378,  7674,  8575,  9808,  7640,  8861,  7976,
+    9006,  8193,  9835, 14516,  7496,  9074,  8308, 10345 },
+ { 14583, 13581, 13877, 14778, 16011, 13843, 15064, 14179,
+   15209, 14396, 16038, 20719, 13699, 15277, 14511, 16548 }
+};
+
 G729_Word16 g729_map1[NCODE1] = {
  5, 1, 4, 7, 3, 0, 6, 2
 };
@@ -521,6 +814,49 @@ G729_Word16 g729_imap2[NCODE2] = {
  2,14, 3,13, 0,15, 1,12, 6,10, 7, 9, 4,11, 5, 8
 };
 
+/* Per gain VQ index GA/GB (row GA, column GB, through g729_imap1/imap2), */
+/* for the level estimation of g729a_level.c: the quantized energy        */
+/* 20 log10(g729_gbk1[][1] + g729_gbk2[][1]) that g729_Gain_update()      */
+/* stores in past_qua_en[0], and -10 log10(1 - min(g_pitch, 0.95)^2)      */
+
+G729_Word16 g729_gbk_qua_en[NCODE1][NCODE2] = {   /* Q10 */
+ {  2241,  3252,  3646,  4337,  3360,  5888,  1727,  1937,
+    4048,  5298,  2737,  3077,  5265,  9642,  2184,  4245 },
+ { -8886, -5764, -4719, -3047, -5469,   179, -10828, -9999,
+   -3723,  -980, -7263, -6256, -1044,  6334, -9085, -3257 },
+ { 10851, 11250, 11411, 11706, 11293, 12417, 10660, 10737,
+   11581, 12139, 11043, 11178, 12124, 14416, 10830, 11666 },
+ {  1667,  2742,  3158,  3886,  2856,  5512,  1118,  1342,
+    3582,  4894,  2195,  2556,  4861,  9398,  1607,  3791 },
+ { -3362, -1550,  -885,   237, -1366,  2585, -4353, -3943,
+    -226,  1715, -2454, -1853,  1667,  7619, -3469,    91 },
+ { -12074, -7883, -6577, -4558, -7511,  -845, -15007, -13714,
+   -5365, -2155, -9833, -8513, -2229,  5836, -12361, -4808 },
+ {  5583,  6289,  6570,  7073,  6365,  8239,  5233,  5374,
+    6861,  7789,  5926,  6165,  7765, 11252,  5544,  7006 },
+ { -2777, -1069,  -438,   631,  -895,  2890, -3702, -3319,
+     189,  2051, -1923, -1357,  2005,  7794, -2877,   492 }
+};
+
+G729_Word16 g729_gbk_pit_boost[NCODE1][NCODE2] = {   /* Q8 */
+ {   338,  2589,   445,  2589,    71,  2589,   120,  2589,
+    1381,  2589,  1890,  2589,   724,  2589,   937,  2589 },
+ {   204,  2589,   279,  2589,    24,  2589,    54,  2589,
+     882,  2589,  1140,  2589,   473,  2589,   614,  1890 },
+ {   288,  2589,   383,  2589,    53,  2589,    95,  2589,
+    1181,  2589,  1570,  2589,   630,  2589,   813,  2589 },
+ {   229,  2589,   311,  2589,    32,  2589,    66,  2589,
+     969,  2589,  1260,  2589,   520,  2589,   674,  2175 },
+ {   223,  2589,   303,  2589,    30,  2589,    63,  2589,
+     947,  2589,  1230,  2589,   509,  2589,   659,  2098 },
+ {   116,  2589,   170,  2589,     3,  2589,    17,  2430,
+     600,  2133,   768,  1545,   311,  2158,   413,  1184 },
+ {   133,  2589,   192,  2589,     6,  2589,    24,  2589,
+     655,  2492,   839,  1729,   344,  2527,   453,  1305 },
+ {   119,  2589,   173,  2589,     4,  2589,    18,  2495,
+     608,  2182,   779,  1571,   316,  2208,   419,  1202 }
+};
+
 /*-----------------------------------------------------*
  | Tables for routine bits().                          |
  -----------------------------------------------------*/
@@ -530,6 +866,23 @@ G729_Word16 g729_bitsno[PRM_SIZE] = {1+NC0_B,               /* MA + 1st stage
                                  8, 1, 13, 4, 7,  /* first subframe   */
                                  5,    13, 4, 7}; /* second subframe  */
 
+/*-----------------------------------------------------------*
+ * Comfort noise gain of each SID energy index i (Q15): the  *
+ * residual rms of -8 + 1.25*i dB over the rms of the noise  *
+ * of g729_Calc_exc_rand().                                  *
+ *-----------------------------------------------------------*/
+
+G729_Word16 g729_sid_gain[NB_SID_ENER] = {
+      3,     3,     4,     4,     5,     6,     7,     8,
+      9,    10,    12,    13,    16,    18,    21,    24,
+     28,    32,    37,    42,    49,    57,    65,    76,
+     87,   101,   116,   134,   155,   179,   207,   239,
+    276,   319,   368,   425,   490,   566,   654,   755,
+    872,  1007,  1163,  1343,  1551,  1791,  2068,  2389,
+   2758,  3185,  3678,  4247,  4905,  5664,  6541,  7553,
+   8722, 10072, 11631, 13432, 15510, 17911, 20684, 23885
+};
+
 
 /*-----------------------------------------------------*
  | Table for routine g729_Pow2().                           |
@@ -54,14 +54,20 @@ extern G729_Word16 g729_slope_cos[64];
 extern G729_Word16 g729_slope_acos[64];
 extern G729_Word16 g729_lspcb1[NC0][M];
 extern G729_Word16 g729_lspcb2[NC1][M];
+extern G729_Word16 g729_lspcb1_t[M][NC0];
+extern G729_Word16 g729_lspcb2_t[M][NC1];
 extern G729_Word16 g729_fg[2][MA_NP][M];
 extern G729_Word16 g729_fg_sum[2][M];
 extern G729_Word16 g729_fg_sum_inv[2][M];
 extern G729_Word16 g729_grid[GRID_POINTS+1];
 extern G729_Word16 g729_inter_3l[FIR_SIZE_SYN];
+extern G729_Word16 g729_inter_3l_taps[UP_SAMP][INTER_TAPS];
 extern G729_Word16 g729_pred[4];
 extern G729_Word16 g729_gbk1[NCODE1][2];
 extern G729_Word16 g729_gbk2[NCODE2][2];
+extern G729_Word16 g729_gbk12_pit[NCODE1][NCODE2];
+extern G729_Word16 g729_gbk12_pit2[NCODE1][NCODE2];
+extern G729_Word16 g729_gbk12_code[NCODE1][NCODE2];
 extern G729_Word16 g729_map1[NCODE1];
 extern G729_Word16 g729_map2[NCODE2];
 extern G729_Word16 g729_coef[2][2];
@@ -70,7 +76,10 @@ extern G729_Word16 g729_thr1[NCODE1-NCAN1];
 extern G729_Word16 g729_thr2[NCODE2-NCAN2];
 extern G729_Word16 g729_imap1[NCODE1];
 extern G729_Word16 g729_imap2[NCODE2];
+extern G729_Word16 g729_gbk_qua_en[NCODE1][NCODE2];
+extern G729_Word16 g729_gbk_pit_boost[NCODE1][NCODE2];
 extern G729_Word16 g729_bitsno[PRM_SIZE];
+extern G729_Word16 g729_sid_gain[NB_SID_ENER];
 extern G729_Word16 g729_tabpow[33];
 extern G729_Word16 g729_tablog[33];
 extern G729_Word16 g729_tabsqr[49];
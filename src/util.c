@@ -81,13 +81,13 @@ void g729_Copy(
 
 /* g729_Random generator  */
 
-G729_Word16 g729_Random()
+G729_Word16 g729_Random(
+    G729_Word16 *seed      /* (i/o)  : generator state, initialized to 21845 */
+)
 {
-    static G729_Word16 seed = 21845;
-    
     /* seed = seed*31821 + 13849; */
-    seed = g729_extract_l(g729_L_add(g729_L_shr(g729_L_mult(seed, 31821), 1), 13849L));
+    *seed = g729_extract_l(g729_L_add(g729_L_shr(g729_L_mult(*seed, 31821), 1), 13849L));
     
-    return(seed);
+    return(*seed);
 }
 
@@ -0,0 +1,187 @@
+/**
+ *  Copyright (c) 2015, Russell
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*-------------------------------------------------------------------*
+ * Voice activity detection of the encoder, for the private DTX of   *
+ * this library (not the VAD of G.729 Annex B).                      *
+ *                                                                   *
+ * The features are the energy of the frame and the distance of its *
+ * LSPs to the mean LSPs of the inactive frames. The noise floor     *
+ * follows the short term mean of the energy down at once and up by  *
+ * FLOOR_RISE per frame, as in g729a_level.c.                        *
+ *                                                                   *
+ * A frame is active when its energy is ACTIVE_MARGIN above the      *
+ * floor, or SPECTRAL_MARGIN above it with a spectrum that differs   *
+ * from the noise by more than SPECTRAL_DIST. Frames below           *
+ * ACTIVE_MIN are always inactive. The decision holds HANGOVER       *
+ * frames after the last active one, to keep the word endings.       *
+ *-------------------------------------------------------------------*/
+
+#include "g729a_typedef.h"
+#include "basic_op.h"
+#include "oper_32b.h"
+#include "ld8a.h"
+
+#include "g729a_encoder.h"
+
+#if defined(USE_PRIVATE_DTX) && (USE_PRIVATE_DTX == 1)
+
+#define FLOOR_INIT      (25*256)    /* Q8: noise floor at start                            */
+#define FLOOR_RISE      13          /* Q8: 0.05 dB per frame, 5 dB/s                       */
+#define ACTIVE_MARGIN   (9*256)     /* Q8: energy above the floor of an active frame       */
+#define SPECTRAL_MARGIN (4*256)     /* Q8: same, with a spectrum unlike the noise          */
+#define SPECTRAL_DIST   10000000L   /* distance of g729_Lsp_dist() to the noise LSPs       */
+#define ACTIVE_MIN      (15*256)    /* Q8: lowest energy of an active frame                */
+#define HANGOVER        8           /* frames still active after the last active one      */
+#define LOG2_2L_FRAME   479849L     /* Q16: log2(2*L_FRAME)                                */
+
+void g729_Init_Vad(g729a_vad_state * state)
+{
+    state->first     = 1;
+    state->ener_mean = FLOOR_INIT;
+    state->floor     = FLOOR_INIT;
+    state->hangover  = 0;
+    g729_Set_zero(state->lsp_noise, M);
+}
+
+/*-------------------------------------------------------------------*
+ * g729_Ener_dB: 10*log10 of the mean power of a frame, in Q8.       *
+ *-------------------------------------------------------------------*/
+
+G729_Word16 g729_Ener_dB(        /* (o) Q8  : 10*log10 of the mean power     */
+    G729_Word16 x[]              /* (i)     : frame (L_FRAME)                */
+)
+{
+    G729_Word16 i, exp, frac, hi, lo;
+    G729_Word32 L_ener;
+    
+    L_ener = 1;
+    for (i = 0; i < L_FRAME; i++)
+    {
+        L_ener = g729_L_mac(L_ener, x[i], x[i]);
+    }
+    
+    /* 10*log10(L_ener / (2*L_FRAME)) = 10*log10(2) * (log2(L_ener) - log2(2*L_FRAME)) */
+    
+    g729_Log2(L_ener, &exp, &frac);
+    L_ener = g729_L_sub(g729_L_Comp(exp, frac), LOG2_2L_FRAME);   /* Q16 */
+    g729_L_Extract(L_ener, &hi, &lo);
+    L_ener = g729_Mpy_32_16(hi, lo, 24660);                      /* 10*log10(2) in Q13 -> Q14 */
+    
+    return g729_extract_l(g729_L_shr(L_ener, 6));
+}
+
+/*-------------------------------------------------------------------*
+ * g729_Lsp_dist: squared distance of two LSP vectors.               *
+ *-------------------------------------------------------------------*/
+
+G729_Word32 g729_Lsp_dist(       /* (o)     : sum of (lsp1-lsp2)^2, Q31      */
+    G729_Word16 lsp1[],          /* (i) Q15 : first LSP vector               */
+    G729_Word16 lsp2[]           /* (i) Q15 : second LSP vector              */
+)
+{
+    G729_Word16 i, diff;
+    G729_Word32 L_dist;
+    
+    L_dist = 0;
+    for (i = 0; i < M; i++)
+    {
+        diff   = g729_sub(lsp1[i], lsp2[i]);
+        L_dist = g729_L_mac(L_dist, diff, diff);
+    }
+    
+    return L_dist;
+}
+
+/*-------------------------------------------------------------------*
+ * g729_Vad: voice activity decision of the present frame.           *
+ *-------------------------------------------------------------------*/
+
+G729_Word16 g729_Vad(            /* (o)     : 1 active, 0 inactive frame     */
+    g729a_vad_state * state,
+    G729_Word16 speech[],        /* (i)     : present frame (L_FRAME)        */
+    G729_Word16 lsp[]            /* (i) Q15 : LSPs of the frame              */
+)
+{
+    G729_Word16 i, ener, diff, active;
+    
+    ener = g729_Ener_dB(speech);
+    
+    if (state->first != 0)
+    {
+        state->first = 0;
+        state->ener_mean = ener;
+        g729_Copy(lsp, state->lsp_noise, M);
+    }
+    
+    state->ener_mean = g729_add(state->ener_mean, g729_shr(g729_sub(ener, state->ener_mean), 2));
+    
+    if (g729_sub(state->ener_mean, state->floor) < 0) {
+        state->floor = state->ener_mean;
+    }
+    else {
+        state->floor = g729_add(state->floor, FLOOR_RISE);
+    }
+    
+    diff = g729_sub(ener, state->floor);
+    
+    active = 0;
+    if (g729_sub(ener, ACTIVE_MIN) > 0)
+    {
+        if (g729_sub(diff, ACTIVE_MARGIN) > 0) {
+            active = 1;
+        }
+        else if (g729_sub(diff, SPECTRAL_MARGIN) > 0 &&
+                 g729_L_sub(g729_Lsp_dist(lsp, state->lsp_noise), SPECTRAL_DIST) > 0) {
+            active = 1;
+        }
+    }
+    
+    if (active != 0)
+    {
+        state->hangover = HANGOVER;
+        return 1;
+    }
+    
+    /* lsp_noise += (lsp - lsp_noise) / 8 */
+    
+    for (i = 0; i < M; i++)
+    {
+        state->lsp_noise[i] = g729_add(state->lsp_noise[i], g729_shr(g729_sub(lsp[i], state->lsp_noise[i]), 3));
+    }
+    
+    if (state->hangover > 0)
+    {
+        state->hangover = g729_sub(state->hangover, 1);
+        return 1;
+    }
+    
+    return 0;
+}
+
+#endif /* USE_PRIVATE_DTX */
+
+/* end of file */